@@ -9,14 +9,37 @@
 #include "hardware/adc.h"
 #include "hardware/pwm.h"
 #include "ssd1306_i2c.h"
+#include "ssd1306_text.h"
+#include "ssd1306_gfx.h"
+#include "telas.h"
 #include "hardware/timer.h" 
 #include "hardware/clocks.h"
 #include "hardware/pio.h"
-#include "ws2818b.pio.h"
+#include "neopixel.h"
+#include "matriz_led.h"
+#include "captura_adc.h"
+#include "detector.h"
+#include "dizimador.h"
+#include "desentrelacador.h"
+#include "espectro.h"
+#include "gatilho.h"
+#include "ciclos.h"
+#include "fila_spsc.h"
+#include "botoes.h"
+#include "grafico.h"
+#include "telemetria.h"
+#include "registro.h"
+#include "agenda.h"
+#include "tom.h"
+#include "perfil.h"
+#include "calibracao.h"
+#include "partida.h"
+#include "relogio.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
 
 #define count_of(arr) (sizeof(arr) / sizeof((arr)[0])) 
 
-#define LED_COUNT 25 // Número de LEDs na matriz
 #define LED_MATRIX_PIN 7 // Pino de controle da matriz
 
 static uint32_t brilhoMaximo = 64;
@@ -32,396 +55,872 @@ static uint32_t brilhoMaximo = 64;
 
 #define IN_PIN 28    // GP28 (ADC2)
 #define LED_PIN 13   // GP13 (Saída PWM de teste (LED RGB))
-#define ADC_THRESHOLD 60 // Valor para ignorar o ruído do ADC
-
-// Definições para realizar debouncing por temporizadores
-static uint32_t ultimoTempoA = 0;
-static uint32_t ultimoTempoB = 0;
-const uint32_t debounceDelay = 200; // 200ms de debounce
+#define ADC_THRESHOLD 60 // Piso de ruído inicial; a calibração acompanha o piso real de cada placa e antena
+#define TETO_INICIAL 4000 // Teto inicial da escala, ajustado da mesma forma
+#define TAXA_AMOSTRAGEM 10000 // Amostras por segundo entregues ao detector, depois da dizimação
+#define LEITURA_PROVISORIA_MS 20 // Depois do reset, uma leitura pelo RMS com um ciclo de 50 Hz, sem esperar a janela inteira
+// Canais varridos pelo ADC (bit i = ADCi). Na BitDogLab o GP26 e o GP27 são o
+// joystick, então o padrão é só a antena do GP28. Com antenas extras e o
+// sensor de temperatura, por exemplo:
+//   (1u << 0) | (1u << 1) | (1u << 2) | (1u << CAPTURA_CANAL_TEMPERATURA)
+// As antenas ocupam o início do quadro, em ordem de ADC; o sensor (ADC4) é
+// sempre o último canal.
+#define CANAIS_ADC (1u << (IN_PIN - 26))
+#define NUM_CANAIS_ADC CAPTURA_NUM_CANAIS(CANAIS_ADC)
+#define COM_TEMPERATURA ((CANAIS_ADC >> CAPTURA_CANAL_TEMPERATURA) & 1)
+#define NUM_ANTENAS (NUM_CANAIS_ADC - COM_TEMPERATURA)
+// O ADC roda 16x mais rápido (160 kS/s por canal) e o CIC devolve 14 bits
+// efetivos; com 4 canais ou mais cai para 8x, para caber nos 500 kS/s do ADC
+#define RAZAO_DIZIMACAO (NUM_CANAIS_ADC > 3 ? 8 : 16)
+#define MODO_TELEMETRIA (TELEMETRIA_AMOSTRAS | TELEMETRIA_RESULTADOS) // TELEMETRIA_TEXTO volta aos printf
+#define DECIMACAO_TELEMETRIA RAZAO_DIZIMACAO // Amostras do ADC por amostra enviada pela USB
+#define PERIODO_TELEMETRIA 10000 // Tarefa que esvazia a fila de pacotes de amostras (us)
+_Static_assert(TELEMETRIA_CABE_NA_FILA(TAXA_AMOSTRAGEM * RAZAO_DIZIMACAO, DECIMACAO_TELEMETRIA, PERIODO_TELEMETRIA),
+               "A fila da telemetria não comporta dois períodos da tarefa com essa decimação");
+#define SPLASH_MS 0 // Rolagem de abertura do OLED; bloqueia o núcleo 0 (a amostragem já está rodando). 0 desliga
+#define RELOGIO_DINAMICO 1 // Clock por modo (relogio.h): turbo no espectro, economia sem campo. 0 fica em 125 MHz
+#define RELOGIO_ECONOMIA_APOS_US 30000000 // Tempo sem campo até cair para o clock de economia
+#define GATILHO_BAIXO 150 // Disparo de osciloscópio na primeira antena: amostra fora de [GATILHO_BAIXO, GATILHO_ALTO]
+#define GATILHO_ALTO 3945 // (faíscas e partidas de motor levam o ADC perto dos extremos)
+#define GATILHO_PRE (GATILHO_AMOSTRAS / 4) // Amostras da rajada antes do disparo
+#define GATILHO_HOLDOFF_US 100000 // Tempo mínimo entre dois disparos
+#define ESPECTROS_POR_SEGUNDO 25 // FFTs na tela do espectro (cada uma sobre ESPECTRO_PONTOS amostras do ADC)
 
 volatile static uint16_t valorA = 1;
 volatile static uint16_t valorB = 5;
-volatile static float multiplicadorVolume = 1;
-
-// Definição de um pixel
-struct pixel{
-    uint8_t G, R, B;
-};
-
-typedef struct pixel pixel;
-typedef pixel sLED; // struct pixel -> sLED
-
-sLED leds[LED_COUNT]; // Array de LEDs
-
-// Variáveis para uso do PIO
-PIO np_pio;
-uint sm;
+volatile static uint16_t multiplicadorVolume = TOM_VOLUME_MAX; // Fração do duty em Q8 (256 = máximo)
+static bool oledPendente = false; // Tela precisa ser redesenhada
+
+typedef enum {
+    TELA_VOLUME,  // Volume do buzzer
+    TELA_GRAFICO, // Histórico da intensidade do campo
+    TELA_ESPECTRO, // Espectro das amostras do ADC (OLED em barras, matriz em 5 bandas)
+    TELA_GATILHO, // Última rajada congelada pelo gatilho (forma de onda)
+    TELA_PERFIL   // Histogramas do perfilador (só com PERFIL_HABILITADO)
+} Tela;
+static Tela telaAtual = TELA_VOLUME;
+static bool telaTrocada = false; // Tela nova precisa ser desenhada por inteiro
+
+static uint16_t valorLed = 0; // Último valor mostrado na matriz de LEDs
+static uint64_t ultimoCampo = 0; // Última leitura acima do limiar, para o modo de economia
+static uint32_t i2cKhz = SSD1306_I2C_CLK; // Velocidade do I2C do OLED (comando 'i'), refeita a cada troca de clock
+
+// Etapas medidas pelo perfilador (perfil.h). CANS, CIC, DSP, AMOS, FFT e GAT rodam no núcleo 1,
+// as demais no núcleo 0. Os nomes aparecem na tela do perfil (4 caracteres).
+typedef enum {
+    ETAPA_CANAIS,     // Separação e alinhamento dos canais (só com mais de um canal)
+    ETAPA_DIZIMADOR,  // Filtro CIC por bloco e antena
+    ETAPA_DETECTOR,   // detectorProcessar() por bloco e antena
+    ETAPA_AMOSTRAS,   // telemetriaAmostras() por bloco
+    ETAPA_ESPECTRO,   // espectroAlimentar() por bloco (só na tela do espectro)
+    ETAPA_GATILHO,    // gatilhoAlimentar() por bloco
+    ETAPA_RESULTADOS, // processarLeitura() (inclui o printf no modo texto)
+    ETAPA_BUZZER,     // pwmBuzzer()
+    ETAPA_MATRIZ,     // Renderização da matriz e npWrite()
+    ETAPA_OLED,       // Desenho da tela no framebuffer
+    ETAPA_I2C,        // SSD1306_poll(): montagem e disparo do DMA do OLED
+    ETAPA_USB,        // telemetriaEnviar()
+    NUM_ETAPAS
+} Etapa;
+#if PERFIL_HABILITADO
+static const char *const nomesEtapas[NUM_ETAPAS] = {"CANS", "CIC", "DSP", "AMOS", "FFT", "GAT", "RES", "BUZ", "MATR", "OLED", "I2C", "USB"};
+static uint8_t primeiraEtapaTela = 0; // A tela do perfil mostra quatro etapas por vez
+#endif
+
+static Calibrador calibrador; // Piso, limiar e escala adaptativos da intensidade (núcleo 0)
+static Desentrelacador desentrelacador; // Separa os canais da varredura e os alinha no tempo (núcleo 1)
+static uint16_t amostrasCanal[NUM_CANAIS_ADC][CAPTURA_TAM_BLOCO / NUM_CANAIS_ADC];
+static uint16_t *canais[NUM_CANAIS_ADC];
+static Dizimador dizimador[NUM_ANTENAS]; // Sobreamostragem e dizimação antes do detector (núcleo 1)
+static uint16_t amostrasDizimadas[CAPTURA_TAM_BLOCO / DIZIMADOR_RAZAO_MIN + 1];
+static Detector detector[NUM_ANTENAS]; // Detector de campo 50/60 Hz, um por antena (núcleo 1)
+static uint32_t somaTemperatura, contagemTemperatura; // Leituras do ADC4 na janela atual (núcleo 1)
+static bool semLeitura = true; // Nenhuma leitura enviada desde o reset (núcleo 1)
+
+// Uma janela do detector em todas as antenas
+typedef struct {
+    DetectorResultado res;              // Antena mais forte: é o que a interface mostra
+    uint16_t intensidade[NUM_ANTENAS];  // Intensidade de cada antena (0-4095)
+    uint16_t razao[NUM_ANTENAS];        // Fração da soma das intensidades, Q12 (4096 = todo o campo numa antena)
+    uint8_t dominante;                  // Antena mais forte
+    int16_t temperatura;                // Média da janela em décimos de °C (só com COM_TEMPERATURA)
+    uint64_t instante;                  // Fim da janela (us desde o reset), marcado no núcleo 1
+    bool provisoria;                    // Janela ainda aberta (detectorParcial), só na partida
+} Leitura;
+static Leitura ultimaLeitura; // Última leitura recebida, para as estatísticas (núcleo 0)
+
+// Espectros passam do núcleo 1 para o núcleo 0 só enquanto a tela do espectro
+// está aberta; vale sempre o mais recente
+static volatile bool espectroLigado = false;
+#define TAM_FILA_ESPECTROS 2
+FILA_SPSC_ARMAZENAMENTO(espectros, EspectroQuadro, TAM_FILA_ESPECTROS);
+static FilaSpsc filaEspectros;
+static EspectroQuadro ultimoEspectro; // Núcleo 0
+static struct text_label rotuloEspectro; // Pico e custo da FFT na página 0
+static struct text_label rotuloGatilho; // Estado do gatilho na página 0
+static bool ondaNaTela = false; // A tela do gatilho mostra uma rajada (apagada ao rearmar)
+static uint32_t exportandoGatilho = GATILHO_AMOSTRAS; // Próxima amostra da rajada a exportar pela USB
+
+// Resultados do detector passam do núcleo 1 (aquisição/DSP) para o núcleo 0 (interface).
+// Se o núcleo 0 atrasar, os resultados mais antigos são sobrescritos.
+#define TAM_FILA_RESULTADOS 8
+FILA_SPSC_ARMAZENAMENTO(resultados, Leitura, TAM_FILA_RESULTADOS);
+static FilaSpsc filaResultados;
+
+// Desenha o nível do ADC na matriz como barra que sobe linha a linha
+// (as tabelas de brilho ficam prontas em matrizInit)
+void ativarLedADC(uint16_t val) {
+    matrizRenderizar(val, MATRIZ_BARRA);
+}
 
-// Função para inverter um byte (especificamente para inverter o código de intensidade dos LEDs)
-uint8_t inverter_byte(uint8_t byte_original){
-    uint8_t invertido = 0;
-    for (int i = 0; i < 8; i++){
-        invertido = invertido << 1;
-        invertido = (invertido | ((byte_original >> i) & 0x1));
+// Tela do espectro: frequência do pico e custo da última FFT na página 0 e uma
+// barra de 3 colunas por faixa de frequência nas páginas 1 a 3 (24 pixels).
+// As barras são montadas por página e copiadas com SSD1306_blit(), que só
+// marca as colunas que mudaram.
+static void desenharEspectro(const EspectroQuadro *q) {
+    uint8_t *buf = SSD1306_framebuffer();
+    if (telaTrocada) {
+        SSD1306_clear();
+        TextLabelInvalidate(&rotuloEspectro);
     }
-    return invertido;
+    char texto[TEXT_LABEL_MAX + 1];
+    uint32_t frequencia = espectroFrequencia(q->pico);
+    // Limitados às larguras dos campos para a linha caber no rótulo
+    snprintf(texto, sizeof(texto), "%6luHz %7luc", (unsigned long)(frequencia < 999999 ? frequencia : 999999),
+             (unsigned long)(q->ciclos < 9999999 ? q->ciclos : 9999999));
+    DrawLabel(buf, &rotuloEspectro, texto);
+
+    uint8_t barras[3][SSD1306_WIDTH];
+    for (int b = 0; b < ESPECTRO_BARRAS; b++) {
+        int altura = (q->barras[b] * 25) >> 8; // 0-255 -> 0-24
+        for (int pagina = 0; pagina < 3; pagina++) {
+            int primeiro = 24 - altura - pagina * 8; // Primeiro bit aceso dentro da página
+            uint8_t byte = primeiro <= 0 ? 0xFF : primeiro >= 8 ? 0 : (uint8_t)(0xFF << primeiro);
+            int x = b * (SSD1306_WIDTH / ESPECTRO_BARRAS);
+            barras[pagina][x] = barras[pagina][x + 1] = barras[pagina][x + 2] = byte;
+            barras[pagina][x + 3] = 0;
+        }
+    }
+    SSD1306_blit(barras[0], 0, 1, SSD1306_WIDTH, 3);
+    SSD1306_update();
 }
 
-void npInit(uint pin) {
+// Tela do gatilho: estado na página 0 e, com a rajada congelada, a forma de
+// onda nas páginas 1 a 3. Cada coluna resume GATILHO_AMOSTRAS / 128 amostras
+// numa linha vertical do mínimo ao máximo (envelope), então picos curtos não
+// somem; a coluna do disparo fica pontilhada.
+static void desenharGatilho() {
+    uint8_t *buf = SSD1306_framebuffer();
+    if (telaTrocada) {
+        SSD1306_clear();
+        TextLabelInvalidate(&rotuloGatilho);
+        ondaNaTela = false;
+    }
+    GatilhoStats stats;
+    gatilhoGetStats(&stats);
+    char texto[TEXT_LABEL_MAX + 1];
+    uint8_t onda[3][SSD1306_WIDTH];
+
+    if (gatilhoCongelado()) {
+        memset(onda, 0, sizeof(onda));
+        const uint32_t fatia = GATILHO_AMOSTRAS / SSD1306_WIDTH;
+        uint16_t menor = 4095, maior = 0;
+        for (int x = 0; x < SSD1306_WIDTH; x++) {
+            uint16_t minimo = 4095, maximo = 0;
+            for (uint32_t i = x * fatia; i < (x + 1) * fatia; i++) {
+                uint16_t v = gatilhoAmostra(i);
+                minimo = v < minimo ? v : minimo;
+                maximo = v > maximo ? v : maximo;
+            }
+            menor = minimo < menor ? minimo : menor;
+            maior = maximo > maior ? maximo : maior;
+            // y de 0 (alto) a 23 nas páginas 1 a 3; a coluna do disparo fica pontilhada
+            DrawVLine(onda[0], x, 23 - maximo * 24 / 4096, 23 - minimo * 24 / 4096, true);
+            if (x == GATILHO_PRE / fatia) {
+                onda[0][x] |= 0x55;
+                onda[1][x] |= 0x55;
+                onda[2][x] |= 0x55;
+            }
+        }
+        // Amostras de 12 bits; a contagem é limitada para a linha caber no rótulo
+        unsigned long disparos = stats.disparos < 99999 ? stats.disparos : 99999;
+        snprintf(texto, sizeof(texto), "DISP %lu %4u-%4u", disparos, menor & 0xFFF, maior & 0xFFF);
+        SSD1306_blit(onda[0], 0, 1, SSD1306_WIDTH, 3);
+        ondaNaTela = true;
+    } else {
+        snprintf(texto, sizeof(texto), "ARMADO %lu", (unsigned long)stats.disparos);
+        if (ondaNaTela) { // O anel voltou a ser escrito: a rajada antiga não vale mais
+            memset(onda, 0, sizeof(onda));
+            SSD1306_blit(onda[0], 0, 1, SSD1306_WIDTH, 3);
+            ondaNaTela = false;
+        }
+    }
+    DrawLabel(buf, &rotuloGatilho, texto);
+    SSD1306_update();
+}
 
-    // Cria programa PIO
-    uint offset = pio_add_program(pio0, &ws2818b_program);
-    np_pio = pio0;
-   
-    // Toma posse de uma máquina PIO
-    sm = pio_claim_unused_sm(np_pio, false);
-    if (sm < 0) {
-      np_pio = pio1;
-      sm = pio_claim_unused_sm(np_pio, true); 
+// As telas vêm prontas da flash (telas.txt -> telas.h, gerado no build). Ao
+// entrar na tela ela é copiada inteira; depois só a barra do volume muda, e
+// SSD1306_blit() marca apenas as colunas que ficaram diferentes.
+void updateOLED(uint16_t nivel) {
+    if (telaTrocada) {
+        SSD1306_blit(telaVolume, 0, 0, SSD1306_WIDTH, SSD1306_NUM_PAGES);
     }
-   
-    // Inicia programa na máquina PIO obtida
-    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
-   
-    // Limpa buffer de pixels
-    for (uint i = 0; i < LED_COUNT; ++i) {
-      leds[i].R = 0;
-      leds[i].G = 0;
-      leds[i].B = 0;
+    if (nivel >= TRECHO_VOLUME_NIVEL_VARIANTES) {
+        nivel = TRECHO_VOLUME_NIVEL_VARIANTES - 1;
     }
+    SSD1306_blit(trechoVolumeNivel[nivel], TRECHO_VOLUME_NIVEL_X, TRECHO_VOLUME_NIVEL_PAGINA,
+                 TRECHO_VOLUME_NIVEL_LARGURA, TRECHO_VOLUME_NIVEL_PAGINAS);
+    SSD1306_update(); // Envia apenas as colunas alteradas
 }
 
-// Atribui uma cor RGB a um LED
-void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b) {
-    uint8_t rI = inverter_byte(r); // Invertendo os comandos de intensidade dos LEDs
-    uint8_t gI = inverter_byte(g);
-    uint8_t bI = inverter_byte(b);
+// Trata os gestos dos botões no laço principal (o ISR só enfileira as bordas)
+// Quanto mais A: Maior o volume (segurando, continua aumentando)
+// Quanto mais B: Menor o volume
+// Segurando B: alterna entre a tela do volume, o gráfico do campo, o espectro, o gatilho e o perfil
+// Na tela do gatilho, A rearma o disparo
+// A soma de A e B sempre deve ser 5
+static void tratarBotao(uint8_t gpio, BotaoEvento evento) {
+    if (gpio == BUTTON_B && evento == BOTAO_LONGO) {
+        if (telaAtual == TELA_VOLUME) {
+            telaAtual = TELA_GRAFICO;
+        } else if (telaAtual == TELA_GRAFICO) {
+            telaAtual = TELA_ESPECTRO;
+        } else if (telaAtual == TELA_ESPECTRO) {
+            telaAtual = TELA_GATILHO;
+        } else if (telaAtual == TELA_GATILHO && PERFIL_HABILITADO) {
+            telaAtual = TELA_PERFIL;
+        } else {
+            telaAtual = TELA_VOLUME;
+        }
+        espectroLigado = telaAtual == TELA_ESPECTRO; // O núcleo 1 só calcula a FFT com a tela aberta
+        telaTrocada = true;
+        oledPendente = true;
+        return;
+    }
+    if (gpio == BUTTON_A && telaAtual == TELA_GATILHO) {
+        gatilhoLiberar();
+        exportandoGatilho = GATILHO_AMOSTRAS; // Uma exportação em andamento perderia a rajada
+        return;
+    }
+    if (gpio == BUTTON_A && valorA < 5) {
+        valorA++;
+        valorB--;
+    } else if (gpio == BUTTON_B && evento == BOTAO_CLIQUE && valorB < 5) {
+        valorB++;
+        valorA--;
+    } else {
+        return;
+    }
+    multiplicadorVolume = valorA * TOM_VOLUME_MAX / 5; // Calcula o multiplicador do volume baseado no valor de A
+    oledPendente = true; // O OLED é atualizado pelo laço principal, fora de interrupção
+}
 
-    leds[index].R = rI; // Colocando os comandos inversos no array de LEDs
-    leds[index].G = gI;
-    leds[index].B = bI;
+void setupBuzzer() {
+    // Os dois buzzers tocam o mesmo tom; a tabela de divisor/wrap fica pronta aqui
+    tomInit(BUZZER_1, BUZZER_2);
 }
 
-// Limpa o buffer dos pixels
-void npClear(){
-    for(uint i = 0; i < LED_COUNT; i++){
-        npSetLED(i, 0, 0, 0);
+void setupI2C() { 
+    // Fazendo a configuração do I2C para o OLED (baseado no código de exemplo do Github)
+    partidaInicio(PARTIDA_I2C, time_us_64());
+    i2c_init(i2c1, i2cKhz * 1000);
+    gpio_set_function(I2C_SDA_OLED, GPIO_FUNC_I2C);
+    gpio_set_function(I2C_SCL_OLED, GPIO_FUNC_I2C);
+    gpio_pull_up(I2C_SDA_OLED);
+    gpio_pull_up(I2C_SCL_OLED);
+    partidaFim(PARTIDA_I2C, time_us_64());
+
+    partidaInicio(PARTIDA_OLED, time_us_64());
+    SSD1306_init(); // Já deixa o framebuffer e a tela limpos (uma transação só de comandos, outra de dados)
+
+    if (SPLASH_MS > 0) {
+        SSD1306_scroll(true);
+        sleep_ms(SPLASH_MS);
+        SSD1306_scroll(false);
     }
+
+    valorA = 5;
+    valorB = 0;
+    telaTrocada = true; // Primeira tela: copiada inteira
+    updateOLED(valorA); // Só enfileira: o envio segue por DMA enquanto o resto da partida continua
+    telaTrocada = false;
+    partidaFim(PARTIDA_OLED, time_us_64());
 }
 
-// Escreve os dados do buffer nos LEDs
-void npWrite(){
-    for(uint i = 0; i < LED_COUNT; i++){
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
-    }
+// A USB fica por último: a enumeração continua no fundo (TinyUSB), sem segurar
+// a amostragem nem a interface
+void setupUsb() {
+    partidaInicio(PARTIDA_USB, time_us_64());
+    stdio_init_all();
+    partidaFim(PARTIDA_USB, time_us_64());
 }
 
-void ativarLedADC(uint16_t val) {
-    // Valor máximo capturado pela antena: 2600
-    if (val > 2600) {
-        val = 2600;
-    }
+void setup() {
+    //gpio_set_function(LED_PIN, GPIO_FUNC_PWM); // Configura o pino do LED RGB (de teste) para PWM
+    //uint slice_num = pwm_gpio_to_slice_num(LED_PIN);
+    //pwm_set_wrap(slice_num, 255);  
+    //pwm_set_enabled(slice_num, true);
+
+    partidaInicio(PARTIDA_REGISTRO, time_us_64());
+    registroInit(); // Retoma o registro na flash numa sessão nova
+    partidaFim(PARTIDA_REGISTRO, time_us_64());
 
-    // Definindo limites de brilho (o brilho aumenta de acordo com o valor do ADC)
-    uint8_t brilho1 = (brilhoMaximo * val) / 520;
-    uint8_t brilho2 = (brilhoMaximo * val) / 1040;
-    uint8_t brilho3 = (brilhoMaximo * val) / 1560;
-    uint8_t brilho4 = (brilhoMaximo * val) / 2080;
-    uint8_t brilho5 = (brilhoMaximo * val) / 2600;
+    ciclosInit(); // Para medir o ISR dos botões e as etapas deste núcleo
+    botoesAdicionar(BUTTON_A, true);  // A repete enquanto segurado
+    botoesAdicionar(BUTTON_B, false); // B tem pressão longa
+
+    partidaInicio(PARTIDA_PIO, time_us_64());
+    npInit(LED_MATRIX_PIN);
+    matrizInit(brilhoMaximo, 4095); // A calibração já entrega a intensidade na escala cheia
+    partidaFim(PARTIDA_PIO, time_us_64());
+    calibradorInit(&calibrador, ADC_THRESHOLD, TETO_INICIAL);
+    graficoInit(GRAFICO_VARREDURA);
+    TextLabelInit(&rotuloEspectro, 5, 0);
+    TextLabelInit(&rotuloGatilho, 5, 0);
+}
+
+void pwmBuzzer(uint16_t val) {
+    // Mapeia o ADC (0-4095) para uma frequência entre 200 Hz e 2000 Hz
+    uint16_t freq = TOM_FREQ_MIN + (val * (TOM_FREQ_MAX - TOM_FREQ_MIN)) / 4095;
 
-    // Limpa todos os LEDs
-    npClear();
+    // O duty cresce com o sinal e com o volume escolhido; val 0 silencia
+    uint16_t volume = ((uint32_t)val * multiplicadorVolume) >> 12;
 
-    if (val > 0 && val < 520) {
-        for (uint i = 0; i < 5; i++) {
-            npSetLED(i, brilho1, 0, 0); // Determinando brilho de acordo com valor do ADC
+    tomDefinir(freq, volume); // O glide até a nova frequência roda no temporizador do tom
+}
+
+void processarLeitura(uint16_t val) {
+    // Abaixo do limiar adaptativo vira 0 (com histerese, para não piscar);
+    // acima dele, a faixa até o teto acompanhado é mapeada para 1-4095
+    val = calibradorAplicar(&calibrador, val);
+    if (val == 0) {
+        pwm_set_gpio_level(LED_PIN, 0);
+    }
+    //pwm_set_gpio_level(LED_PIN, val / 16); // Divide o valor do ADC por 16 para caber na resolução do PWM (0-255)
+
+    if (telemetriaTexto()) { // Com a telemetria binária o valor já vai no pacote de resultados
+        printf("ADC: %d (%lu ciclos/bloco)\n", val, (unsigned long)detector[0].ciclosUltimo);
+    }
+    valorLed = val; // Matriz e buzzer são atualizados pelas próprias tarefas
+}
+
+// Junta as janelas das antenas: a mais forte vira o resultado principal e a
+// razão de cada uma indica de que lado está a fonte
+static void montarLeitura(Leitura *l, const DetectorResultado *res) {
+    uint32_t soma = 0;
+    l->dominante = 0;
+    for (uint8_t a = 0; a < NUM_ANTENAS; a++) {
+        l->intensidade[a] = res[a].intensidade;
+        soma += res[a].intensidade;
+        if (res[a].intensidade > res[l->dominante].intensidade) {
+            l->dominante = a;
         }
-    } else if (val >= 520 && val < 1040) {
-        for (uint j = 0; j < 5; j++) {
-            npSetLED(j, brilhoMaximo, 0, 0); // Se ele chegar na próxima linha, o brilho da linha anterior é maximizado
+    }
+    for (uint8_t a = 0; a < NUM_ANTENAS; a++) {
+        l->razao[a] = soma ? ((uint32_t)l->intensidade[a] << 12) / soma : 4096 / NUM_ANTENAS;
+    }
+    l->res = res[l->dominante];
+    l->temperatura = contagemTemperatura ? capturaTemperatura(somaTemperatura / contagemTemperatura) : 0;
+}
+
+// Recebe cada bloco completo da captura (núcleo 1). Com vários canais, o bloco
+// é separado por canal e alinhado no instante do primeiro. Em cada antena o CIC
+// reduz as amostras a 16 bits na taxa do detector; a cada janela de 100 ms os
+// detectores entregam a intensidade do campo da rede (50/60 Hz), que vai para o
+// núcleo 0 pela fila.
+void processarBloco(const uint16_t *amostras, size_t n, uint32_t seq, void *ctx) {
+    uint64_t agora = time_us_64();
+    partidaMarco(PARTIDA_PRIMEIRO_BLOCO, agora);
+    if (NUM_CANAIS_ADC > 1) {
+        PERFIL_MEDIR(ETAPA_CANAIS) {
+            n = desentrelacadorProcessar(&desentrelacador, amostras, n, canais);
         }
-        for (uint i = 5; i < 10; i++) {
-            npSetLED(i, brilho2, 0, 0);
+        amostras = amostrasCanal[0];
+    }
+    PERFIL_MEDIR(ETAPA_AMOSTRAS) {
+        telemetriaAmostras(amostras, n); // Amostras da primeira antena para a USB (com a média da telemetria), se habilitado
+    }
+    PERFIL_MEDIR(ETAPA_GATILHO) {
+        gatilhoAlimentar(amostras, n, agora); // Primeira antena, na taxa do ADC; o núcleo 0 vê a rajada congelada
+    }
+    if (espectroLigado) {
+        EspectroQuadro espectro;
+        bool novo = false;
+        PERFIL_MEDIR(ETAPA_ESPECTRO) {
+            novo = espectroAlimentar(amostras, n, &espectro); // Primeira antena, na taxa do ADC
         }
-    } else if (val >= 1040 && val < 1560) {
-        for (uint j = 0; j < 10; j++) {
-            npSetLED(j, brilhoMaximo, 0, 0); // As linhas anteriores vão se juntando e ficando com o brilho máximo
+        if (novo) {
+            filaSpscPush(&filaEspectros, &espectro);
         }
-        for (uint i = 10; i < 15; i++) {
-            npSetLED(i, brilho3, 0, 0);
+    }
+    if (COM_TEMPERATURA) {
+        for (size_t i = 0; i < n; i++) {
+            somaTemperatura += amostrasCanal[NUM_CANAIS_ADC - 1][i];
         }
-    } else if (val >= 1560 && val < 2080) {
-        for (uint j = 0; j < 15; j++) {
-            npSetLED(j, brilhoMaximo, 0, 0);
+        contagemTemperatura += n;
+    }
+
+    DetectorResultado res[NUM_ANTENAS];
+    bool pronto = false;
+    for (uint8_t a = 0; a < NUM_ANTENAS; a++) {
+        size_t m = 0;
+        PERFIL_MEDIR(ETAPA_DIZIMADOR) {
+            m = dizimadorProcessar(&dizimador[a], NUM_CANAIS_ADC > 1 ? amostrasCanal[a] : amostras, n, amostrasDizimadas);
         }
-        for (uint i = 15; i < 20; i++) {
-            npSetLED(i, brilho4, 0, 0);
+        PERFIL_MEDIR(ETAPA_DETECTOR) {
+            pronto = detectorProcessar(&detector[a], amostrasDizimadas, m, &res[a]); // Janelas fecham juntas
         }
-    } else if (val >= 2080 && val <= 2600) {
-        for (uint j = 0; j < 20; j++) {
-            npSetLED(j, brilhoMaximo, 0, 0);
+    }
+    if (pronto) {
+        Leitura leitura;
+        montarLeitura(&leitura, res);
+        somaTemperatura = contagemTemperatura = 0;
+        leitura.provisoria = false;
+        // A janela fechou antes do fim do bloco: as amostras que já entraram
+        // na seguinte saem do instante. Marcado aqui, e não quando o núcleo 0
+        // tira a leitura da fila, o intervalo entre janelas não pega o atraso
+        // das tarefas.
+        leitura.instante = agora - (uint64_t)detector[0].contagem * RAZAO_DIZIMACAO * 1000000 / capturaTaxa();
+        filaSpscPush(&filaResultados, &leitura);
+        semLeitura = false;
+    } else if (semLeitura) {
+        // Primeira janela ainda aberta: uma estimativa já com LEITURA_PROVISORIA_MS,
+        // para a interface reagir logo depois do reset
+        bool parcial = true;
+        for (uint8_t a = 0; a < NUM_ANTENAS; a++) {
+            parcial = detectorParcial(&detector[a], TAXA_AMOSTRAGEM * LEITURA_PROVISORIA_MS / 1000, &res[a]) && parcial;
         }
-        for (uint i = 20; i < 25; i++) {
-            npSetLED(i, brilho5, 0, 0);
+        if (parcial) {
+            Leitura leitura;
+            montarLeitura(&leitura, res);
+            leitura.provisoria = true;
+            leitura.instante = agora;
+            filaSpscPush(&filaResultados, &leitura);
+            semLeitura = false;
         }
     }
 }
 
-typedef struct {
-    char **text;
-    size_t lines;
-} OLEDText; // Criando uma nova estrutura para os textos do OLED
-
-OLEDText outputOLED(uint16_t botaoA, uint16_t botaoB) { // Função que retorna um texto para ser exibido no OLED
-    if(botaoA == 0 && botaoB == 5){
-        static char *text[] = {
-            "Volume Buzzer:",
-            "- - - - - ",
-            "AUMENTAR A",  
-            "DIMINUIR B",
-        };
-        OLEDText oledText = { text, sizeof(text) / sizeof(text[0]) };
-        return oledText;
-    } else if(botaoA == 1 && botaoB == 4){
-        static char *text[] = {
-            "Volume Buzzer:",
-            "X - - - - ",
-            "AUMENTAR A",  
-            "DIMINUIR B",
-        };
-        OLEDText oledText = { text, sizeof(text) / sizeof(text[0]) };
-        return oledText;
-    } else if(botaoA == 2 && botaoB == 3){
-        static char *text[] = {
-            "Volume Buzzer:",
-            "X X - - - ",
-            "AUMENTAR A",  
-            "DIMINUIR B",
-        };
-        OLEDText oledText = { text, sizeof(text) / sizeof(text[0]) };
-        return oledText;
-    } else if(botaoA == 3 && botaoB == 2){
-        static char *text[] = {
-            "Volume Buzzer:",
-            "X X X - - ",
-            "AUMENTAR A",  
-            "DIMINUIR B",
-        };
-        OLEDText oledText = { text, sizeof(text) / sizeof(text[0]) };
-        return oledText; 
-    } else if(botaoA == 4 && botaoB == 1){
-        static char *text[] = {
-            "Volume Buzzer:",
-            "X X X X - ",
-            "AUMENTAR A",  
-            "DIMINUIR B",
-        };
-        OLEDText oledText = { text, sizeof(text) / sizeof(text[0]) };
-        return oledText;
-    } else if(botaoA == 5 && botaoB == 0){
-        static char *text[] = {
-            "Volume Buzzer:",
-            "X X X X X ",
-            "AUMENTAR A",  
-            "DIMINUIR B",
-        };
-        OLEDText oledText = { text, sizeof(text) / sizeof(text[0]) };
-        return oledText;
-    }
-}
-
-void updateOLED(uint16_t botaoA, uint16_t botaoB) {
-    
-    struct render_area frame_area = {
-        start_col : 0,
-        end_col : SSD1306_WIDTH - 1,
-        start_page : 0,
-        end_page : SSD1306_NUM_PAGES - 1
+// Estado usado pelos dois núcleos: precisa estar pronto antes do núcleo 1
+// partir. Inclui a configuração da captura, do processamento de sinal e da
+// telemetria, que o núcleo 1 usa desde o primeiro bloco; o setup() do núcleo
+// 0 roda em paralelo com ele e não pode mexer nesse estado.
+void setupCompartilhado() {
+    filaSpscInit(&filaResultados, resultadosDados, resultadosSeq, sizeof(Leitura), TAM_FILA_RESULTADOS,
+                 FILA_SOBRESCREVER);
+    filaSpscInit(&filaEspectros, espectrosDados, espectrosSeq, sizeof(EspectroQuadro), TAM_FILA_ESPECTROS,
+                 FILA_SOBRESCREVER);
+    perfilInit(nomesEtapas, NUM_ETAPAS);
+
+    partidaInicio(PARTIDA_ADC, time_us_64());
+    uint32_t taxa = capturaInitCanais(CANAIS_ADC, TAXA_AMOSTRAGEM * RAZAO_DIZIMACAO); // ADC rodando livre com DMA
+    desentrelacadorInit(&desentrelacador, NUM_CANAIS_ADC, true); // Compensa a defasagem de capturaDefasagemNs()
+    for (uint8_t i = 0; i < NUM_CANAIS_ADC; i++) {
+        canais[i] = amostrasCanal[i];
+    }
+    espectroInit(taxa, ESPECTROS_POR_SEGUNDO);
+    GatilhoConfig gatilho = {
+        .tipo = GATILHO_JANELA,
+        .baixo = GATILHO_BAIXO,
+        .alto = GATILHO_ALTO,
+        .preDisparo = GATILHO_PRE,
+        .holdoff = (uint32_t)((uint64_t)taxa * GATILHO_HOLDOFF_US / 1000000),
+        .taxa = taxa,
     };
+    gatilhoInit(&gatilho);
+    for (uint8_t a = 0; a < NUM_ANTENAS; a++) {
+        dizimadorInit(&dizimador[a], RAZAO_DIZIMACAO);
+        detectorInit(&detector[a], taxa / RAZAO_DIZIMACAO, DIZIMADOR_BITS_SAIDA);
+    }
+    capturaSetCallback(processarBloco, NULL);
+    telemetriaInit(MODO_TELEMETRIA, DECIMACAO_TELEMETRIA, taxa, PERIODO_TELEMETRIA);
+    partidaFim(PARTIDA_ADC, time_us_64());
+}
 
-    calc_render_area_buflen(&frame_area);
+// Núcleo 1: dono da captura e do processamento de sinal. Nada aqui bloqueia
+// em periféricos lentos, então a amostragem não é atrasada pela interface.
+void setupNucleo1() {
+    ciclosInit();
+    multicore_lockout_victim_init(); // Permite ao núcleo 0 pausar este núcleo para gravar a flash
+    capturaStart(); // O IRQ do DMA fica neste núcleo
+}
 
-    uint8_t buf[SSD1306_BUF_LEN];
-    memset(buf, 0, SSD1306_BUF_LEN);
-    render(buf, &frame_area);
+void nucleo1() {
+    setupNucleo1();
+    while (1) {
+        capturaPoll(); // Entrega os blocos prontos para processarBloco()
+        __wfi();       // Dorme até o próximo bloco
+    }
+}
 
-    restart:
+static void exportarRegistro(uint16_t sessao, uint32_t instanteMs, uint16_t valor, void *ctx) {
+    if (telemetriaTexto()) {
+        printf("REG,%u,%lu,%u\n", sessao, (unsigned long)instanteMs, valor);
+    } else {
+        telemetriaRegistro(sessao, instanteMs, valor);
+    }
+}
 
-    OLEDText oledText = outputOLED(botaoA, botaoB);
-    char **text = oledText.text;
-    size_t lines = oledText.lines;
+static void imprimirLinha(const char *linha, void *ctx) {
+    if (telemetriaTexto()) {
+        printf("%s\n", linha);
+    } else {
+        telemetriaLinha(linha);
+    }
+}
 
-    int y = 0;
-    for (size_t i = 0; i < lines; i++) {
-        WriteString(buf, 5, y, text[i]);
-        y += 8;
+// Troca o clk_sys e refaz os divisores de tudo que depende dele. A matriz e o
+// OLED terminam o que estão enviando no clock antigo; o núcleo 1 segue
+// capturando (o ADC e o DMA não dependem do clk_sys).
+static bool mudarRelogio(RelogioModo modo) {
+    RelogioDivisores d;
+    if (modo == relogioModo() || !relogioCalcular(relogioFrequencia(modo), i2cKhz * 1000, &d)) {
+        return false;
+    }
+    uint64_t inicio = time_us_64();
+    while (!npQuadroConcluido()) {
+        tight_loop_contents();
     }
-    render(buf, &frame_area);
+    while (SSD1306_busy()) {
+        SSD1306_poll();
+    }
+    if (!relogioMudar(modo)) {
+        return false;
+    }
+    npAjustarRelogio(d.pioDivInt, d.pioDivFrac);
+    tomAjustarRelogio(d.sysHz);
+    SSD1306_set_clock_khz(i2cKhz);
+    capturaAjustarRelogio();
+    relogioTrocaConcluida(time_us_64() - inicio);
+    return true;
 }
 
-static void apertarBotao(uint gpio, uint32_t events) {
-    // Primeiramente, obtém o valor de quando botão foi apertado
-    uint32_t tempoAtual = to_ms_since_boot(get_absolute_time());
-    // Para depois fazer um if e verificar se esse tempo está dentro do limite do debounce
-    // (200ms desde a última vez que o botão foi apertado)
+// Troca a velocidade do I2C do OLED entre 400 kHz e 1 MHz (Fast-mode Plus),
+// desde que os divisores fiquem válidos no clock atual. As próximas trocas de
+// clock refazem o divisor com a velocidade nova.
+static void alternarI2c() {
+    uint32_t khz = i2cKhz == SSD1306_I2C_CLK ? SSD1306_I2C_CLK_FAST_PLUS : SSD1306_I2C_CLK;
+    RelogioDivisores d;
+    char linha[48];
+    if (relogioCalcular(relogioFrequencia(relogioModo()), khz * 1000, &d)) {
+        i2cKhz = khz;
+        SSD1306_set_clock_khz(khz);
+        snprintf(linha, sizeof(linha), "I2C %lu kHz (%lu Hz reais)", (unsigned long)khz, (unsigned long)d.i2cHz);
+    } else {
+        snprintf(linha, sizeof(linha), "I2C %lu kHz invalido em %s", (unsigned long)khz, relogioNome(relogioModo()));
+    }
+    imprimirLinha(linha, NULL);
+}
 
-    // Interrupção (callback) para quando os botões forem apertados
-    // Quanto mais A: Maior o volume
-    // Quanto mais B: Menor o volume
-    // A soma de A e B sempre deve ser 5
-    if (gpio == BUTTON_A && valorA < 5 && (tempoAtual - ultimoTempoA) > debounceDelay) {
-        ultimoTempoA = tempoAtual; // Atualiza o tempo do último botão A
-        valorA++;
-        valorB--;
-    } else if (gpio == BUTTON_B && valorB < 5 && (tempoAtual - ultimoTempoB) > debounceDelay) {
-        ultimoTempoB = tempoAtual; // Atualiza o tempo do último botão B
-        valorB++;
-        valorA--;
+static RelogioModo escolherRelogio(uint64_t agora) {
+    if (telaAtual == TELA_ESPECTRO) {
+        return RELOGIO_TURBO; // FFT a 25 quadros/s no núcleo 1
+    }
+    if (agora - ultimoCampo >= RELOGIO_ECONOMIA_APOS_US) {
+        return RELOGIO_ECONOMIA;
     }
-    multiplicadorVolume = valorA * 0.2; // Calcula o multiplicador do volume baseado no valor de A
-    updateOLED(valorA, valorB);
-} 
+    return RELOGIO_NORMAL;
+}
 
-void setupBuzzer() {
-    // Configuração do buzzer
-    gpio_init(BUZZER_1);
-    gpio_set_dir(BUZZER_1, GPIO_OUT);
-    gpio_put(BUZZER_1, 0);
-    gpio_init(BUZZER_2);
-    gpio_set_dir(BUZZER_2, GPIO_OUT);
-    gpio_put(BUZZER_2, 0);
-
-    // Configuração do PWM do buzzer
-    gpio_set_function(BUZZER_1, GPIO_FUNC_PWM);
-    gpio_set_function(BUZZER_2, GPIO_FUNC_PWM);
-    uint slice1 = pwm_gpio_to_slice_num(BUZZER_1);
-    uint slice2 = pwm_gpio_to_slice_num(BUZZER_2);
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, 4.0f);
-    pwm_init(slice1, &config, true);
-    pwm_init(slice2, &config, true);
-    pwm_set_gpio_level(BUZZER_1, 0);
-    pwm_set_gpio_level(BUZZER_2, 0);    
+// Um trecho da rajada por execução da tarefa, para não segurar a agenda: uma
+// linha "GAT,<índice>,<valor>" por amostra no modo texto ou um pacote de
+// TIPO_DISPARO. O índice é relativo ao disparo.
+static void exportarTrechoGatilho() {
+    uint16_t trecho[TELEMETRIA_AMOSTRAS_DISPARO];
+    size_t n = gatilhoCopiar(exportandoGatilho, trecho, TELEMETRIA_AMOSTRAS_DISPARO);
+    int16_t primeira = (int16_t)((int32_t)exportandoGatilho - GATILHO_PRE);
+    if (telemetriaTexto()) {
+        for (size_t i = 0; i < n; i++) {
+            printf("GAT,%d,%u\n", primeira + (int)i, trecho[i]);
+        }
+    } else {
+        telemetriaDisparo(gatilhoInstante(), primeira, trecho, n);
+    }
+    exportandoGatilho += n;
+    if (exportandoGatilho == GATILHO_AMOSTRAS && telemetriaTexto()) {
+        printf("GAT fim: disparo em %llu us\n", (unsigned long long)gatilhoInstante());
+    }
 }
 
-void setupI2C() { 
-    // Fazendo a configuração do I2C para o OLED (baseado no código de exemplo do Github)
-    i2c_init(i2c1, SSD1306_I2C_CLK * 1000);
-    gpio_set_function(I2C_SDA_OLED, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL_OLED, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA_OLED);
-    gpio_pull_up(I2C_SCL_OLED);
+// Comandos de um caractere pela USB:
+// 'e' exporta o registro da flash, 'x' apaga o registro,
+// 'p' despeja os histogramas do perfilador, 'z' zera os histogramas,
+// 'b' repete a linha do tempo da partida, 'c' mostra o tempo em cada modo de clock,
+// 'i' alterna o I2C do OLED entre 400 kHz e 1 MHz,
+// 'g' exporta a rajada congelada pelo gatilho, 'r' rearma o gatilho
+static void tratarComando() {
+    int c = getchar_timeout_us(0);
+    if (c == 'b') {
+        partidaRelatorio(imprimirLinha, NULL);
+    } else if (c == 'c') {
+        relogioRelatorio(imprimirLinha, NULL);
+    } else if (c == 'i') {
+        alternarI2c();
+    } else if (c == 'g') {
+        if (gatilhoCongelado()) {
+            exportandoGatilho = 0; // Segue em trechos pela tarefa do gatilho
+        } else {
+            imprimirLinha("GAT sem rajada", NULL);
+        }
+    } else if (c == 'r') {
+        gatilhoLiberar();
+        exportandoGatilho = GATILHO_AMOSTRAS;
+    }
+#if PERFIL_HABILITADO
+    if (c == 'p') {
+        perfilDespejar(imprimirLinha, NULL);
+    } else if (c == 'z') {
+        perfilZerar();
+    }
+#endif
+    if (c == 'e') {
+        uint32_t total = registroExportar(exportarRegistro, NULL);
+        telemetriaRegistroFim();
+        if (telemetriaTexto()) {
+            printf("REG fim: %lu registros\n", (unsigned long)total);
+        }
+    } else if (c == 'x') {
+        registroApagar(); // Feito em segundo plano, um setor por execução da tarefa do registro
+    }
+}
 
-    SSD1306_init();
-    struct render_area frame_area = {
-        start_col : 0,
-        end_col : SSD1306_WIDTH - 1,
-        start_page : 0,
-        end_page : SSD1306_NUM_PAGES - 1
-    };
+// Núcleo 0: OLED, matriz de LEDs, buzzer e USB, cada um como tarefa da agenda
+// com o próprio período (em us)
+#define PERIODO_BOTOES 10000
+#define PERIODO_OLED 20000
+#define PERIODO_RESULTADOS 20000 // O detector entrega um resultado a cada 100 ms
+#define PERIODO_ESPECTRO 20000 // Acompanha os 25 espectros/s do núcleo 1
+#define PERIODO_GATILHO 20000 // Também o ritmo da exportação, um pacote por execução
+#define PERIODO_BUZZER 20000
+#define PERIODO_MATRIZ 20000     // 50 quadros/s para o dithering temporal
+#define PERIODO_REGISTRO 50000
+#define PERIODO_ESTATISTICAS 1000000
+
+static void tarefaBotoes(uint64_t agora, void *ctx) {
+    botoesProcessar(agora, tratarBotao);
+}
 
-    calc_render_area_buflen(&frame_area);
+static void tarefaOled(uint64_t agora, void *ctx) {
+    if (oledPendente) {
+        oledPendente = false;
+        PERFIL_MEDIR(ETAPA_OLED) {
+            if (telaAtual == TELA_GRAFICO) {
+                graficoDesenhar(); // Só acontece ao entrar na tela
+            } else if (telaAtual == TELA_VOLUME) {
+                updateOLED(valorA); // Só enfileira: o envio é feito por DMA
+            } else if (telaAtual == TELA_ESPECTRO) {
+                desenharEspectro(&ultimoEspectro);
+            } else if (telaAtual == TELA_GATILHO) {
+                desenharGatilho();
+            }
+#if PERFIL_HABILITADO
+            else {
+                perfilDesenhar(SSD1306_framebuffer(), primeiraEtapaTela);
+                SSD1306_update();
+            }
+#endif
+        }
+        telaTrocada = false;
+    }
+    PERFIL_MEDIR(ETAPA_I2C) {
+        SSD1306_poll(); // Conclui o quadro do OLED e envia o que ficou pendente
+    }
+}
 
-    uint8_t buf[SSD1306_BUF_LEN];
-    memset(buf, 0, SSD1306_BUF_LEN);
-    render(buf, &frame_area);
+static void tarefaResultados(uint64_t agora, void *ctx) {
+    Leitura leitura;
+    while (filaSpscPop(&filaResultados, &leitura)) {
+        partidaMarco(PARTIDA_PRIMEIRA_LEITURA, agora);
+        PERFIL_MEDIR(ETAPA_RESULTADOS) {
+            processarLeitura(leitura.res.intensidade);
+        }
+        if (leitura.provisoria) {
+            continue; // Gráfico, telemetria e registro contam uma entrada por janela de 100 ms
+        }
+        graficoAdicionar(leitura.res.intensidade, telaAtual == TELA_GRAFICO); // Uma coluna por janela de 100 ms
+        telemetriaResultado(&leitura.res);
+        registroAdicionar(leitura.res.intensidade, leitura.instante / 1000);
+        ultimaLeitura = leitura;
+        if (valorLed) {
+            ultimoCampo = agora;
+        }
+    }
+}
 
-    restart:
+static void tarefaEspectro(uint64_t agora, void *ctx) {
+    bool novo = false;
+    while (filaSpscPop(&filaEspectros, &ultimoEspectro)) {
+        novo = true;
+    }
+    if (novo && telaAtual == TELA_ESPECTRO) {
+        oledPendente = true; // Desenhado pela tarefa do OLED
+    }
+}
 
-    SSD1306_scroll(true);
-    sleep_ms(1500); // Diminui esse tempo para inicializar o OLED mais rapidamente
-    SSD1306_scroll(false);
+static void tarefaGatilho(uint64_t agora, void *ctx) {
+    static bool congeladoAnterior = false;
+    bool congelado = gatilhoCongelado();
+    if (congelado != congeladoAnterior) {
+        congeladoAnterior = congelado;
+        if (telaAtual == TELA_GATILHO) {
+            oledPendente = true; // Rajada nova ou rearme
+        }
+    }
+    if (congelado && exportandoGatilho < GATILHO_AMOSTRAS) {
+        exportarTrechoGatilho();
+    }
+}
 
-    OLEDText oledText = outputOLED(5, 0);
-    valorA = 5;
-    valorB = 0;
-    char **text = oledText.text;
-    size_t lines = oledText.lines;
+static void tarefaBuzzer(uint64_t agora, void *ctx) {
+    static uint16_t valorAnterior = 0;
+    static uint16_t volumeAnterior = UINT16_MAX;
+    if (valorLed != valorAnterior || multiplicadorVolume != volumeAnterior) {
+        valorAnterior = valorLed;
+        volumeAnterior = multiplicadorVolume;
+        PERFIL_MEDIR(ETAPA_BUZZER) {
+            pwmBuzzer(valorLed); // Só reprograma o PWM quando algo mudou
+        }
+    }
+}
 
-    int y = 0;
-    for (size_t i = 0; i < lines; i++) {
-        WriteString(buf, 5, y, text[i]);
-        y += 8;
+static void tarefaMatriz(uint64_t agora, void *ctx) {
+    PERFIL_MEDIR(ETAPA_MATRIZ) {
+        if (telaAtual == TELA_ESPECTRO) {
+            matrizRenderizarColunas(ultimoEspectro.bandas); // Cinco bandas no lugar do nível
+        } else {
+            ativarLedADC(valorLed); // Só envia quando o quadro muda (inclui o dithering)
+        }
     }
-    render(buf, &frame_area);
 }
 
-void setup() {
-    stdio_init_all();
-    adc_init();
-    adc_gpio_init(IN_PIN);  // Inicializa o ADC no GP28
-    adc_select_input(2);    // Seleciona o ADC2 para o GP28
-    //gpio_set_function(LED_PIN, GPIO_FUNC_PWM); // Configura o pino do LED RGB (de teste) para PWM
-    //uint slice_num = pwm_gpio_to_slice_num(LED_PIN);
-    //pwm_set_wrap(slice_num, 255);  
-    //pwm_set_enabled(slice_num, true);
+static void tarefaTelemetria(uint64_t agora, void *ctx) {
+    PERFIL_MEDIR(ETAPA_USB) {
+        telemetriaEnviar(agora); // Quadros COBS prontos vão para a USB
+    }
+    tratarComando();
+}
 
-    gpio_init(BUTTON_A);
-    gpio_set_dir(BUTTON_A, GPIO_IN);
-    gpio_pull_up(BUTTON_A);
+static void tarefaRegistro(uint64_t agora, void *ctx) {
+    registroProcessar(agora / 1000); // No máximo uma operação de flash por execução
+}
 
-    gpio_init(BUTTON_B);
-    gpio_set_dir(BUTTON_B, GPIO_IN);
-    gpio_pull_up(BUTTON_B);
+static void tarefaEstatisticas(uint64_t agora, void *ctx) {
+    static uint32_t overrunsAnteriores = 0;
+    static uint32_t sobrescritosAnteriores = 0;
+    static uint32_t isrCiclosAnterior = 0;
+    static uint32_t graficoCiclosAnterior = 0;
 
-    gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &apertarBotao);
-    gpio_set_irq_enabled(BUTTON_B, GPIO_IRQ_EDGE_FALL, true);
+#if PERFIL_HABILITADO
+    if (telaAtual == TELA_PERFIL) { // Atualiza a tela do perfil, alternando entre grupos de quatro etapas
+        primeiraEtapaTela = primeiraEtapaTela + SSD1306_NUM_PAGES < NUM_ETAPAS ? primeiraEtapaTela + SSD1306_NUM_PAGES : 0;
+        oledPendente = true;
+    }
+#endif
 
-    npInit(LED_MATRIX_PIN);
-    npClear();
-}
+    static bool partidaRelatada = false;
+    if (!partidaRelatada && partidaCompleta()) { // Uma vez, assim que houver a primeira leitura
+        partidaRelatada = true;
+        partidaRelatorio(imprimirLinha, NULL);
+    }
 
-void pwmBuzzer() {
-    uint slice1 = pwm_gpio_to_slice_num(BUZZER_1);
-    uint slice2 = pwm_gpio_to_slice_num(BUZZER_2);
-    
-    uint16_t val = adc_read(); // Lê o ADC
-    if (val < ADC_THRESHOLD) val = 0; // Ignora ruídos baixos
+    AgendaStats agendaStats;
+    agendaGetStats(&agendaStats);
+    // O modo do clock só muda aqui, logo depois de fechar a janela de
+    // ocupação, para que cada janela conte inteira para um modo
+    relogioContabilizar(agora, agendaStats.ociosoPorMil);
+    if (RELOGIO_DINAMICO) {
+        mudarRelogio(escolherRelogio(agora));
+    }
+    if (!telemetriaTexto()) {
+        return; // Texto no meio do fluxo binário corromperia os quadros
+    }
 
-    // Mapeia o ADC (0-4095) para uma frequência entre 200 Hz e 2000 Hz
-    uint freq = 200 + ((val * 1800) / 4095);
+    printf("Agenda: %lu.%lu%% ocioso, %lu despertares/s\n", (unsigned long)agendaStats.ociosoPorMil / 10,
+           (unsigned long)agendaStats.ociosoPorMil % 10, (unsigned long)agendaStats.despertares);
+    printf("Clock: %s, %lu MHz\n", relogioNome(relogioModo()), (unsigned long)relogioFrequencia(relogioModo()) / 1000000);
+    printf("OLED: %lu quadros/s, I2C %lu kHz\n", (unsigned long)SSD1306_fps(), (unsigned long)i2cKhz);
+    for (uint32_t i = 0; i < agendaNumTarefas(); i++) { // Jitter e custo de cada tarefa
+        const AgendaTarefa *t = agendaTarefa(i);
+        printf("  %-12s atraso max %lu us, duracao max %lu us, prazos perdidos %lu\n", t->nome,
+               (unsigned long)t->atrasoMax, (unsigned long)t->duracaoMax, (unsigned long)t->prazosPerdidos);
+    }
 
-    // Calcula os valores de PWM para configurar a frequência
-    uint32_t clock_sys = clock_get_hz(clk_sys);
-    uint32_t wrap = clock_sys / freq;
+    printf("Calibracao: piso %u, limiar %u, teto %u, %lu transicoes\n", calibradorPiso(&calibrador),
+           calibradorLimiar(&calibrador), calibradorTeto(&calibrador), (unsigned long)calibrador.transicoes);
 
-    pwm_set_wrap(slice1, wrap);
-    pwm_set_wrap(slice2, wrap);
+    printf("CIC: %lu ciclos/saida\n", (unsigned long)dizimadorCiclosPorSaida(&dizimador[0]));
+    if (espectroCiclosMax()) {
+        printf("FFT %u pontos: %lu ciclos (ultima), %lu ciclos (max)\n", ESPECTRO_PONTOS,
+               (unsigned long)ultimoEspectro.ciclos, (unsigned long)espectroCiclosMax());
+    }
+    GatilhoStats gatilho;
+    gatilhoGetStats(&gatilho);
+    printf("Gatilho: %lu disparos, %lu ciclos/%lu amostras (max %lu)\n", (unsigned long)gatilho.disparos,
+           (unsigned long)gatilho.ciclosUltimo, (unsigned long)gatilho.amostrasUltimo, (unsigned long)gatilho.ciclosMax);
+    if (NUM_ANTENAS > 1 || COM_TEMPERATURA) { // Intensidade e fração do campo em cada antena
+        printf("Antenas:");
+        for (uint8_t a = 0; a < NUM_ANTENAS; a++) {
+            printf(" %u (%lu%%)", ultimaLeitura.intensidade[a], ((unsigned long)ultimaLeitura.razao[a] * 100) >> 12);
+        }
+        printf(", dominante %u", ultimaLeitura.dominante);
+        if (COM_TEMPERATURA) {
+            printf(", %d.%d C", ultimaLeitura.temperatura / 10, abs(ultimaLeitura.temperatura % 10));
+        }
+        printf("\n");
+    }
 
-    // Define o nível PWM baseado no volume
-    uint16_t volume = (val * multiplicadorVolume);
-    
-    pwm_set_gpio_level(BUZZER_1, volume);
-    pwm_set_gpio_level(BUZZER_2, volume);
+    CapturaStats stats;
+    capturaGetStats(&stats);
+    if (stats.overruns != overrunsAnteriores) { // Avisa quando blocos foram perdidos
+        overrunsAnteriores = stats.overruns;
+        printf("Overruns: %lu\n", (unsigned long)stats.overruns);
+    }
+    if (filaResultados.sobrescritos != sobrescritosAnteriores) { // Resultados que o núcleo 0 não chegou a usar
+        sobrescritosAnteriores = filaResultados.sobrescritos;
+        printf("Resultados sobrescritos: %lu\n", (unsigned long)sobrescritosAnteriores);
+    }
+    if (botoesIsrCiclosMax() != isrCiclosAnterior) { // Pior caso do ISR dos botões
+        isrCiclosAnterior = botoesIsrCiclosMax();
+        printf("ISR botoes: %lu ciclos (max)\n", (unsigned long)isrCiclosAnterior);
+    }
+    if (graficoCiclosAmostra() > graficoCiclosAnterior) { // Custo por amostra contra o redesenho completo
+        graficoCiclosAnterior = graficoCiclosAmostra();
+        printf("Grafico: %lu ciclos/amostra, %lu ciclos/redesenho\n", (unsigned long)graficoCiclosAnterior,
+               (unsigned long)graficoCiclosRedesenho());
+    }
 }
 
-void loopLeitura() {
-    uint16_t val = adc_read(); // Lê o valor do ADC
-
-    if (val >= ADC_THRESHOLD) { // Se o valor do ADC for maior que 60, o sistema ativa. Isso é para evitar que o ruído presente no ADC interfira no sistema
-        val = val > 4000 ? 4000 : val; // Limita o valor do ADC a 4000
-        val = (val - ADC_THRESHOLD) * (4095 - 1) / (4000 - ADC_THRESHOLD) + 1; // Mapeia 60-4000 para 1-4095
-        //pwm_set_gpio_level(LED_PIN, val / 16); // Divide o valor do ADC por 16 para caber na resolução do PWM (0-255)
-    } else {
-        pwm_set_gpio_level(LED_PIN, 0);
-        val = 0;  // Qualquer valor abaixo de 60 é tratado como 0
-    } 
-
-    pwmBuzzer(val); // Atualiza o volume do buzzer
-    printf("ADC: %d\n", val); // Imprime o valor do ADC
-    ativarLedADC(val); // Ativa os LEDs da matriz baseado no valor do ADC
-    npWrite(); // Escreve os dados do buffer nos LEDs
-    sleep_ms(100);
+void setupAgenda() {
+    agendaInit();
+    agendaAdicionar("botoes", PERIODO_BOTOES, 0, tarefaBotoes, NULL);
+    agendaAdicionar("resultados", PERIODO_RESULTADOS, 0, tarefaResultados, NULL);
+    agendaAdicionar("espectro", PERIODO_ESPECTRO, 0, tarefaEspectro, NULL);
+    agendaAdicionar("gatilho", PERIODO_GATILHO, 0, tarefaGatilho, NULL);
+    agendaAdicionar("buzzer", PERIODO_BUZZER, 0, tarefaBuzzer, NULL);
+    agendaAdicionar("matriz", PERIODO_MATRIZ, 0, tarefaMatriz, NULL);
+    agendaAdicionar("oled", PERIODO_OLED, 0, tarefaOled, NULL);
+    agendaAdicionar("telemetria", PERIODO_TELEMETRIA, 0, tarefaTelemetria, NULL);
+    agendaAdicionar("registro", PERIODO_REGISTRO, 0, tarefaRegistro, NULL);
+    agendaAdicionar("estatisticas", PERIODO_ESTATISTICAS, 0, tarefaEstatisticas, NULL);
 }
 
+// No build de simulação (sim/) o laço principal é o do simulador, que chama
+// as mesmas funções de setup e alimenta a captura com um traço gravado
+#if PICO_ON_DEVICE
+// A amostragem parte primeiro; o resto da inicialização corre no núcleo 0
+// enquanto o núcleo 1 já processa blocos (linha do tempo em partida.h)
 int main() {
+    setupCompartilhado();
+    multicore_launch_core1(nucleo1);
     setup();
     setupBuzzer();
     setupI2C();
+    setupUsb();
+    setupAgenda();
     while (1) {
-        loopLeitura();
+        agendaExecutar(); // Roda as tarefas vencidas e dorme até a próxima
     }
     return 0;
 }
+#endif
@@ -0,0 +1,191 @@
+#include "agenda.h"
+#include "ciclos.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/timer.h"
+#include "hardware/sync.h"
+#endif
+
+static AgendaTarefa tarefas[AGENDA_MAX_TAREFAS];
+static uint32_t numTarefas = 0;
+
+static uint64_t janelaInicio;
+static uint64_t ocioso;
+static uint32_t despertares;
+
+static void relogioInit();
+static void dormirAte(uint64_t instante);
+
+void agendaInit() {
+    numTarefas = 0;
+    relogioInit();
+    janelaInicio = agendaAgora();
+    ocioso = 0;
+    despertares = 0;
+}
+
+int agendaAdicionar(const char *nome, uint32_t periodoUs, uint32_t prazoUs, AgendaFuncao funcao, void *ctx) {
+    if (numTarefas == AGENDA_MAX_TAREFAS || periodoUs == 0) {
+        return -1;
+    }
+    AgendaTarefa *t = &tarefas[numTarefas];
+    t->nome = nome;
+    t->funcao = funcao;
+    t->ctx = ctx;
+    t->periodo = periodoUs;
+    t->prazo = prazoUs ? prazoUs : periodoUs;
+    t->liberacao = agendaAgora(); // Primeira execução já na próxima volta
+    t->execucoes = 0;
+    t->perdidos = 0;
+    t->prazosPerdidos = 0;
+    t->atrasoMax = 0;
+    t->duracaoMax = 0;
+    t->ciclosMax = 0;
+    return numTarefas++;
+}
+
+// Tarefa pronta com o prazo absoluto mais próximo, ou NULL
+static AgendaTarefa *proximaPronta(uint64_t agora) {
+    AgendaTarefa *escolhida = NULL;
+    for (uint32_t i = 0; i < numTarefas; i++) {
+        AgendaTarefa *t = &tarefas[i];
+        if ((int64_t)(agora - t->liberacao) < 0) {
+            continue;
+        }
+        if (!escolhida || (int64_t)((t->liberacao + t->prazo) - (escolhida->liberacao + escolhida->prazo)) < 0) {
+            escolhida = t;
+        }
+    }
+    return escolhida;
+}
+
+static void executar(AgendaTarefa *t, uint64_t agora) {
+    uint32_t atraso = agora - t->liberacao;
+    if (atraso > t->atrasoMax) {
+        t->atrasoMax = atraso;
+    }
+
+    uint32_t inicio = ciclosAgora();
+    t->funcao(agora, t->ctx);
+    uint32_t ciclos = ciclosDesde(inicio);
+    if (ciclos > t->ciclosMax) {
+        t->ciclosMax = ciclos;
+    }
+
+    uint64_t fim = agendaAgora();
+    uint32_t duracao = fim - agora;
+    if (duracao > t->duracaoMax) {
+        t->duracaoMax = duracao;
+    }
+    if ((int64_t)(fim - (t->liberacao + t->prazo)) > 0) {
+        t->prazosPerdidos++;
+    }
+    t->execucoes++;
+
+    // Próxima liberação na grade; liberações que já passaram inteiras são puladas
+    t->liberacao += t->periodo;
+    if ((int64_t)(fim - t->liberacao) >= (int64_t)t->periodo) {
+        uint64_t atrasadas = (fim - t->liberacao) / t->periodo;
+        t->perdidos += atrasadas;
+        t->liberacao += atrasadas * t->periodo;
+    }
+}
+
+void agendaExecutar() {
+    uint64_t agora = agendaAgora();
+    AgendaTarefa *t;
+    while ((t = proximaPronta(agora)) != NULL) {
+        executar(t, agora);
+        agora = agendaAgora();
+    }
+
+    if (numTarefas == 0) {
+        return;
+    }
+    uint64_t proxima = tarefas[0].liberacao;
+    for (uint32_t i = 1; i < numTarefas; i++) {
+        if ((int64_t)(tarefas[i].liberacao - proxima) < 0) {
+            proxima = tarefas[i].liberacao;
+        }
+    }
+
+    dormirAte(proxima);
+    ocioso += agendaAgora() - agora;
+    despertares++;
+}
+
+const AgendaTarefa *agendaTarefa(int indice) {
+    return (indice >= 0 && (uint32_t)indice < numTarefas) ? &tarefas[indice] : NULL;
+}
+
+uint32_t agendaNumTarefas() {
+    return numTarefas;
+}
+
+void agendaGetStats(AgendaStats *stats) {
+    uint64_t agora = agendaAgora();
+    uint64_t total = agora - janelaInicio;
+    stats->ociosoPorMil = total ? (uint32_t)(ocioso * 1000 / total) : 0;
+    stats->despertares = despertares;
+    janelaInicio = agora;
+    ocioso = 0;
+    despertares = 0;
+}
+
+#if PICO_ON_DEVICE
+
+static int alarme = -1;
+
+// Só acorda o núcleo. O SEV deixa o evento marcado mesmo que o alarme dispare
+// entre a programação e o WFE, que então retorna na hora (com WFI o núcleo
+// dormiria até a próxima interrupção qualquer).
+static void __not_in_flash_func(alarmeDisparou)(uint numAlarme) {
+    __sev();
+}
+
+static void relogioInit() {
+    if (alarme < 0) {
+        alarme = hardware_alarm_claim_unused(true);
+        hardware_alarm_set_callback(alarme, alarmeDisparou);
+    }
+}
+
+uint64_t agendaAgora() {
+    return time_us_64();
+}
+
+// Qualquer outra interrupção (USB, DMA, botões) também acorda o núcleo; a
+// volta seguinte do laço simplesmente não encontra tarefa pronta e dorme de novo
+static void dormirAte(uint64_t instante) {
+    if (hardware_alarm_set_target(alarme, from_us_since_boot(instante))) {
+        return; // O instante já passou
+    }
+    __wfe();
+}
+
+#else
+
+static uint64_t relogioVirtual = 0;
+
+static void relogioInit() {
+}
+
+uint64_t agendaAgora() {
+    return relogioVirtual;
+}
+
+static void dormirAte(uint64_t instante) {
+    if ((int64_t)(instante - relogioVirtual) > 0) {
+        relogioVirtual = instante;
+    }
+}
+
+void agendaDefinirRelogio(uint64_t agora) {
+    relogioVirtual = agora;
+}
+
+void agendaConsumir(uint32_t us) {
+    relogioVirtual += us;
+}
+
+#endif
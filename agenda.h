@@ -0,0 +1,65 @@
+#ifndef AGENDA_H
+#define AGENDA_H
+
+#include "plataforma.h"
+
+// Escalonador cooperativo por tempo para o laço do núcleo 0. Cada tarefa tem
+// período e prazo próprios; entre as tarefas prontas roda primeiro a de prazo
+// mais próximo. Sem nada pronto, o núcleo dorme até a próxima liberação
+// (alarme de hardware + WFE) em vez de girar no laço.
+//
+// As liberações seguem uma grade fixa (liberação anterior + período), então o
+// atraso de uma execução não se acumula nas seguintes. Se uma tarefa perde
+// liberações inteiras, elas são contadas em 'perdidos' e a grade é realinhada.
+//
+// No host o tempo é um relógio virtual: dormir apenas avança o relógio até a
+// próxima liberação, o que torna o comportamento determinístico.
+
+#define AGENDA_MAX_TAREFAS 12
+
+typedef void (*AgendaFuncao)(uint64_t agora, void *ctx);
+
+typedef struct {
+    const char *nome;
+    AgendaFuncao funcao;
+    void *ctx;
+    uint32_t periodo;       // us
+    uint32_t prazo;         // us após a liberação
+    uint64_t liberacao;     // Próxima liberação
+    uint32_t execucoes;
+    uint32_t perdidos;      // Liberações puladas inteiras
+    uint32_t prazosPerdidos; // Execuções que terminaram depois do prazo
+    uint32_t atrasoMax;     // Jitter: maior atraso entre a liberação e o início, em us
+    uint32_t duracaoMax;    // Maior duração de uma execução, em us
+    uint32_t ciclosMax;     // A mesma duração em ciclos (ver ciclos.h), para tarefas curtas
+} AgendaTarefa;
+
+typedef struct {
+    uint32_t ociosoPorMil;  // Fração do tempo dormindo desde a última consulta
+    uint32_t despertares;   // Vezes que o núcleo dormiu desde a última consulta
+} AgendaStats;
+
+void agendaInit();
+
+// 'prazo' 0 usa o próprio período. Retorna o índice da tarefa ou -1.
+int agendaAdicionar(const char *nome, uint32_t periodoUs, uint32_t prazoUs, AgendaFuncao funcao, void *ctx);
+
+// Roda as tarefas prontas e dorme até a próxima liberação
+void agendaExecutar();
+
+const AgendaTarefa *agendaTarefa(int indice);
+uint32_t agendaNumTarefas();
+
+// Lê e zera a janela de ocupação
+void agendaGetStats(AgendaStats *stats);
+
+uint64_t agendaAgora();
+
+#if !PICO_ON_DEVICE
+// Relógio virtual do host. Uma tarefa chama agendaConsumir() para simular o
+// próprio custo.
+void agendaDefinirRelogio(uint64_t agora);
+void agendaConsumir(uint32_t us);
+#endif
+
+#endif
@@ -0,0 +1,190 @@
+#include "botoes.h"
+#include "ciclos.h"
+#include "fila_spsc.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/gpio.h"
+#endif
+
+typedef struct {
+    uint64_t instante;
+    uint8_t gpio;
+    bool nivel;
+} BotaoBorda;
+
+typedef struct {
+    uint8_t gpio;
+    bool repetir;
+    bool nivelBruto;        // Último nível visto pelo ISR (true = solto, pull-up)
+    bool pressionado;       // Estado já filtrado pelo debounce
+    bool longoEmitido;
+    uint64_t mudanca;       // Instante da última borda
+    uint64_t pressao;       // Instante em que a pressão atual começou
+    uint64_t proximaRepeticao;
+} Botao;
+
+#define TAM_FILA_BORDAS 32
+FILA_SPSC_ARMAZENAMENTO(bordas, BotaoBorda, TAM_FILA_BORDAS);
+static FilaSpsc filaBordas;
+
+static Botao botoes[BOTOES_MAX];
+static uint8_t numBotoes = 0;
+static volatile uint32_t isrCiclosMax = 0;
+static uint32_t descartadosVistos = 0; // Bordas perdidas já compensadas pela releitura dos pinos
+
+static void registrarBorda(uint8_t gpio, bool nivel, uint64_t instante) {
+    BotaoBorda borda = {instante, gpio, nivel};
+    filaSpscPush(&filaBordas, &borda);
+}
+
+static Botao *procurarBotao(uint8_t gpio) {
+    for (uint8_t i = 0; i < numBotoes; i++) {
+        if (botoes[i].gpio == gpio) {
+            return &botoes[i];
+        }
+    }
+    return NULL;
+}
+
+static bool nivelAtual(uint8_t gpio);
+static void habilitarIrq(uint8_t gpio, bool primeiro);
+
+void botoesAdicionar(uint8_t gpio, bool repetir) {
+    if (numBotoes == BOTOES_MAX) {
+        return;
+    }
+    if (numBotoes == 0) {
+        filaSpscInit(&filaBordas, bordasDados, NULL, sizeof(BotaoBorda), TAM_FILA_BORDAS, FILA_DESCARTAR);
+    }
+
+    Botao *b = &botoes[numBotoes];
+    b->gpio = gpio;
+    b->repetir = repetir;
+    b->pressionado = false;
+    b->longoEmitido = false;
+    habilitarIrq(gpio, numBotoes == 0);
+    b->nivelBruto = nivelAtual(gpio);
+    b->mudanca = 0;
+    numBotoes++;
+}
+
+void botoesProcessar(uint64_t agora, BotaoCallback cb) {
+    BotaoBorda borda;
+    while (filaSpscPop(&filaBordas, &borda)) {
+        Botao *b = procurarBotao(borda.gpio);
+        if (b) {
+            b->nivelBruto = borda.nivel;
+            b->mudanca = borda.instante;
+        }
+    }
+
+    // Com a fila cheia (núcleo 0 parado por mais que um período, com um botão
+    // trepidando) as bordas mais novas se perdem, e a última delas pode ser a
+    // que solta o botão. Nesse caso o nível vem direto do pino, e o debounce
+    // recomeça agora
+    uint32_t descartados = filaBordas.descartados;
+    if (descartados != descartadosVistos) {
+        descartadosVistos = descartados;
+        for (uint8_t i = 0; i < numBotoes; i++) {
+            bool nivel = nivelAtual(botoes[i].gpio);
+            if (nivel != botoes[i].nivelBruto) {
+                botoes[i].nivelBruto = nivel;
+                botoes[i].mudanca = agora;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < numBotoes; i++) {
+        Botao *b = &botoes[i];
+        bool pressionadoBruto = !b->nivelBruto;
+
+        // Debounce: só aceita o novo nível depois que ele ficou estável
+        if (pressionadoBruto != b->pressionado && (int64_t)(agora - b->mudanca) >= BOTAO_DEBOUNCE_US) {
+            b->pressionado = pressionadoBruto;
+            if (b->pressionado) {
+                b->pressao = b->mudanca;
+                b->longoEmitido = false;
+                if (b->repetir) {
+                    b->proximaRepeticao = b->pressao + BOTAO_REPETICAO_INICIO_US;
+                    cb(b->gpio, BOTAO_CLIQUE);
+                }
+            } else if (!b->repetir && !b->longoEmitido) {
+                cb(b->gpio, BOTAO_CLIQUE);
+            }
+        }
+
+        if (!b->pressionado) {
+            continue;
+        }
+        if (b->repetir) {
+            if ((int64_t)(agora - b->proximaRepeticao) >= 0) {
+                b->proximaRepeticao = agora + BOTAO_REPETICAO_US;
+                cb(b->gpio, BOTAO_REPETICAO);
+            }
+        } else if (!b->longoEmitido && (int64_t)(agora - b->pressao) >= BOTAO_LONGO_US) {
+            b->longoEmitido = true;
+            cb(b->gpio, BOTAO_LONGO);
+        }
+    }
+}
+
+uint32_t botoesIsrCiclosMax() {
+    return isrCiclosMax;
+}
+
+uint32_t botoesEventosPerdidos() {
+    return filaBordas.descartados;
+}
+
+#if PICO_ON_DEVICE
+
+// Só registra a borda; todo o resto acontece em botoesProcessar()
+static void botoesIsr(uint gpio, uint32_t events) {
+    uint32_t inicio = ciclosAgora();
+    registrarBorda(gpio, gpio_get(gpio), time_us_64());
+    uint32_t ciclos = ciclosDesde(inicio);
+    if (ciclos > isrCiclosMax) {
+        isrCiclosMax = ciclos;
+    }
+}
+
+static bool nivelAtual(uint8_t gpio) {
+    return gpio_get(gpio);
+}
+
+static void habilitarIrq(uint8_t gpio, bool primeiro) {
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_IN);
+    gpio_pull_up(gpio);
+    if (primeiro) {
+        gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &botoesIsr);
+    } else {
+        gpio_set_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true);
+    }
+}
+
+#else
+
+// Nível dos pinos no host: o último injetado (todos começam soltos)
+static bool pinoPressionado[32];
+
+static bool nivelAtual(uint8_t gpio) {
+    return !pinoPressionado[gpio & 31];
+}
+
+static void habilitarIrq(uint8_t gpio, bool primeiro) {
+    (void)gpio;
+    (void)primeiro;
+}
+
+void botoesInjetarBorda(uint8_t gpio, bool nivel, uint64_t instante) {
+    uint32_t inicio = ciclosAgora();
+    pinoPressionado[gpio & 31] = !nivel;
+    registrarBorda(gpio, nivel, instante);
+    uint32_t ciclos = ciclosDesde(inicio);
+    if (ciclos > isrCiclosMax) {
+        isrCiclosMax = ciclos;
+    }
+}
+
+#endif
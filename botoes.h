@@ -0,0 +1,40 @@
+#ifndef BOTOES_H
+#define BOTOES_H
+
+#include "plataforma.h"
+
+// Entrada dos botões em duas partes:
+//  - o ISR de GPIO só registra (gpio, nível, instante) numa fila sem trava;
+//  - botoesProcessar(), no laço principal, faz o debounce e reconhece os
+//    gestos (clique, pressão longa e repetição automática).
+
+#define BOTOES_MAX 4
+#define BOTAO_DEBOUNCE_US 20000      // Nível precisa ficar estável por 20 ms
+#define BOTAO_LONGO_US 800000        // Pressão longa
+#define BOTAO_REPETICAO_INICIO_US 500000
+#define BOTAO_REPETICAO_US 150000
+
+typedef enum {
+    BOTAO_CLIQUE,     // Com repetição: ao pressionar. Sem repetição: ao soltar antes da pressão longa
+    BOTAO_REPETICAO,  // Só em botões com repetição, enquanto seguram
+    BOTAO_LONGO       // Só em botões sem repetição, uma vez ao atingir BOTAO_LONGO_US
+} BotaoEvento;
+
+typedef void (*BotaoCallback)(uint8_t gpio, BotaoEvento evento);
+
+// Configura o pino como entrada com pull-up e habilita o IRQ nas duas bordas
+void botoesAdicionar(uint8_t gpio, bool repetir);
+
+// Trata os eventos pendentes e os temporizadores. 'agora' em microssegundos.
+void botoesProcessar(uint64_t agora, BotaoCallback cb);
+
+// Pior duração medida do ISR, em ciclos (ver ciclos.h)
+uint32_t botoesIsrCiclosMax();
+uint32_t botoesEventosPerdidos();
+
+#if !PICO_ON_DEVICE
+// Faz o papel do pino e do ISR no build de host ('nivel' false = pressionado)
+void botoesInjetarBorda(uint8_t gpio, bool nivel, uint64_t instante);
+#endif
+
+#endif
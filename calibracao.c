@@ -0,0 +1,67 @@
+#include "calibracao.h"
+
+// Aproxima 'atual' de 'alvo' em 1/2^deslocamento da diferença
+static int32_t seguir(int32_t atual, int32_t alvo, int deslocamento) {
+    return atual + ((alvo - atual) >> deslocamento);
+}
+
+static int32_t margem(const Calibrador *c, int32_t k, int32_t minimo) {
+    int32_t m = k * c->ruido;
+    return m > (minimo << CALIBRACAO_FRACAO) ? m : (minimo << CALIBRACAO_FRACAO);
+}
+
+static int32_t limiarLiga(const Calibrador *c) {
+    return c->piso + margem(c, CALIBRACAO_K_LIGA, CALIBRACAO_MARGEM_MIN);
+}
+
+static int32_t limiarDesliga(const Calibrador *c) {
+    return c->piso + margem(c, CALIBRACAO_K_DESLIGA, CALIBRACAO_MARGEM_MIN / 2);
+}
+
+void calibradorInit(Calibrador *c, uint16_t pisoInicial, uint16_t tetoInicial) {
+    c->piso = (int32_t)pisoInicial << CALIBRACAO_FRACAO;
+    c->ruido = 0;
+    c->teto = (int32_t)tetoInicial << CALIBRACAO_FRACAO;
+    c->ativo = false;
+    c->transicoes = 0;
+}
+
+uint16_t calibradorAplicar(Calibrador *c, uint16_t intensidade) {
+    int32_t x = (int32_t)intensidade << CALIBRACAO_FRACAO;
+
+    c->piso = seguir(c->piso, x, x < c->piso ? CALIBRACAO_DESCIDA_PISO : CALIBRACAO_SUBIDA_PISO);
+    if (!c->ativo) {
+        int32_t desvio = x > c->piso ? x - c->piso : c->piso - x;
+        c->ruido = seguir(c->ruido, desvio, CALIBRACAO_MEDIA_RUIDO);
+    }
+
+    bool ativo = c->ativo ? x >= limiarDesliga(c) : x >= limiarLiga(c);
+    if (ativo != c->ativo) {
+        c->ativo = ativo;
+        c->transicoes++;
+    }
+
+    int32_t base = limiarDesliga(c);
+    c->teto = seguir(c->teto, x, x > c->teto ? CALIBRACAO_SUBIDA_TETO : CALIBRACAO_DESCIDA_TETO);
+    if (c->teto < base + (CALIBRACAO_FAIXA_MIN << CALIBRACAO_FRACAO)) {
+        c->teto = base + (CALIBRACAO_FAIXA_MIN << CALIBRACAO_FRACAO);
+    }
+
+    if (!c->ativo) {
+        return 0;
+    }
+    int32_t val = 1 + (int32_t)((int64_t)(x - base) * 4094 / (c->teto - base));
+    return val < 1 ? 1 : (val > 4095 ? 4095 : (uint16_t)val);
+}
+
+uint16_t calibradorPiso(const Calibrador *c) {
+    return c->piso >> CALIBRACAO_FRACAO;
+}
+
+uint16_t calibradorLimiar(const Calibrador *c) {
+    return limiarLiga(c) >> CALIBRACAO_FRACAO;
+}
+
+uint16_t calibradorTeto(const Calibrador *c) {
+    return c->teto >> CALIBRACAO_FRACAO;
+}
@@ -0,0 +1,55 @@
+#ifndef CALIBRACAO_H
+#define CALIBRACAO_H
+
+#include "plataforma.h"
+
+// Calibração contínua da intensidade do detector, no lugar do limiar e do
+// teto fixos. Três estimadores exponenciais, com memória O(1):
+//  - piso: envelope inferior, desce rápido e sobe devagar (acompanha a deriva
+//    do ruído ambiente sem absorver um campo forte de poucos segundos);
+//  - ruído: desvio médio acima do piso, medido só enquanto não há campo;
+//  - teto: envelope superior, sobe rápido e desce devagar, para que uma fonte
+//    forte não sature a escala.
+// O campo liga acima de piso + CALIBRACAO_K_LIGA * ruído e só desliga abaixo
+// de piso + CALIBRACAO_K_DESLIGA * ruído (histerese). Com o campo ligado, a
+// faixa entre o limiar de desligar e o teto é mapeada para 1-4095.
+//
+// Valores internos em Q12: com menos bits de fração, a subida lenta do piso
+// (1/1024 da diferença) pararia a dezenas de contagens do alvo. Chamada uma vez
+// por janela do detector (10/s), então os deslocamentos abaixo definem
+// constantes de tempo em janelas.
+
+#define CALIBRACAO_FRACAO 12
+
+#define CALIBRACAO_DESCIDA_PISO 2   // ~0,4 s
+#define CALIBRACAO_SUBIDA_PISO 10   // ~100 s
+#define CALIBRACAO_MEDIA_RUIDO 4    // ~1,6 s
+#define CALIBRACAO_SUBIDA_TETO 1
+#define CALIBRACAO_DESCIDA_TETO 9   // ~50 s
+#define CALIBRACAO_K_LIGA 4
+#define CALIBRACAO_K_DESLIGA 2
+#define CALIBRACAO_MARGEM_MIN 16    // Margem mínima acima do piso, em contagens
+#define CALIBRACAO_FAIXA_MIN 256    // Distância mínima entre o limiar e o teto
+
+typedef struct {
+    int32_t piso;       // Q12
+    int32_t ruido;      // Q12
+    int32_t teto;       // Q12
+    bool ativo;         // Campo acima do limiar (com histerese)
+    uint32_t transicoes; // Mudanças de 'ativo', para avaliar o flicker
+} Calibrador;
+
+// 'pisoInicial' e 'tetoInicial' (contagens) são só o ponto de partida; os
+// estimadores convergem a partir deles
+void calibradorInit(Calibrador *c, uint16_t pisoInicial, uint16_t tetoInicial);
+
+// Atualiza os estimadores com a intensidade de uma janela e devolve a
+// intensidade remapeada: 0 sem campo, 1-4095 com campo
+uint16_t calibradorAplicar(Calibrador *c, uint16_t intensidade);
+
+// Estado atual em contagens, para diagnóstico
+uint16_t calibradorPiso(const Calibrador *c);
+uint16_t calibradorLimiar(const Calibrador *c); // Limiar para ligar
+uint16_t calibradorTeto(const Calibrador *c);
+
+#endif
@@ -0,0 +1,349 @@
+#include <string.h>
+#include "captura_adc.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+#endif
+
+// O anel inteiro fica alinhado ao próprio tamanho para que o DMA use o modo
+// "ring" na escrita: se o IRQ atrasar e um canal for disparado sem ter sido
+// rearmado, ele sobrescreve um bloco do anel, mas nunca escreve fora dele.
+#define CAPTURA_BITS_ANEL 12
+#define CAPTURA_TAM_ANEL (CAPTURA_NUM_BLOCOS * CAPTURA_TAM_BLOCO * sizeof(uint16_t))
+
+_Static_assert((CAPTURA_NUM_BLOCOS & (CAPTURA_NUM_BLOCOS - 1)) == 0, "CAPTURA_NUM_BLOCOS deve ser potência de 2");
+_Static_assert(CAPTURA_NUM_BLOCOS >= 3, "São necessários ao menos 3 blocos (2 no DMA + 1 com o consumidor)");
+_Static_assert((1u << CAPTURA_BITS_ANEL) == CAPTURA_TAM_ANEL, "CAPTURA_BITS_ANEL não corresponde ao tamanho do anel");
+
+static uint16_t amostras[CAPTURA_NUM_BLOCOS][CAPTURA_TAM_BLOCO] __attribute__((aligned(CAPTURA_TAM_ANEL)));
+static uint32_t seqBloco[CAPTURA_NUM_BLOCOS];
+
+// Fila de blocos prontos (produtor: IRQ do DMA, consumidor: capturaPoll)
+static uint8_t filaProntos[CAPTURA_NUM_BLOCOS];
+static volatile uint32_t prontosCabeca, prontosCauda;
+
+// Fila de blocos livres (produtor: capturaPoll, consumidor: IRQ do DMA)
+static uint8_t filaLivres[CAPTURA_NUM_BLOCOS];
+static volatile uint32_t livresCabeca, livresCauda;
+
+static uint8_t blocoCanal[2]; // Bloco que cada canal do ping-pong está preenchendo
+static uint32_t seqAtual;
+static volatile CapturaStats stats;
+
+static CapturaCallback callback;
+static void *callbackCtx;
+static uint32_t taxaReal;
+static uint32_t taxaPedida; // Por canal, para refazer o divisor
+static uint8_t mascaraCanais;
+static uint8_t numCanais;
+static size_t tamBloco = CAPTURA_TAM_BLOCO; // Múltiplo de numCanais
+
+static void __not_in_flash_func(rearmarCanal)(int ch);
+
+// Chamado quando o canal 'ch' termina de preencher seu bloco
+static void __not_in_flash_func(blocoCompleto)(int ch) {
+    uint8_t bloco = blocoCanal[ch];
+    uint32_t seq = seqAtual++;
+    stats.blocosCompletos++;
+
+    uint32_t cauda = livresCauda;
+    if (cauda != __atomic_load_n(&livresCabeca, __ATOMIC_ACQUIRE)) {
+        // Publica o bloco cheio e arma o canal com um bloco livre
+        blocoCanal[ch] = filaLivres[cauda % CAPTURA_NUM_BLOCOS];
+        __atomic_store_n(&livresCauda, cauda + 1, __ATOMIC_RELEASE);
+
+        seqBloco[bloco] = seq;
+        uint32_t cabeca = prontosCabeca;
+        filaProntos[cabeca % CAPTURA_NUM_BLOCOS] = bloco;
+        __atomic_store_n(&prontosCabeca, cabeca + 1, __ATOMIC_RELEASE);
+    } else {
+        // Consumidor atrasado: descarta o bloco recém-preenchido e o reutiliza
+        stats.overruns++;
+    }
+    rearmarCanal(ch);
+}
+
+static void reiniciarFilas() {
+    prontosCabeca = prontosCauda = 0;
+    livresCabeca = livresCauda = 0;
+    blocoCanal[0] = 0;
+    blocoCanal[1] = 1;
+    for (uint8_t i = 2; i < CAPTURA_NUM_BLOCOS; i++) {
+        filaLivres[livresCabeca++ % CAPTURA_NUM_BLOCOS] = i;
+    }
+}
+
+void capturaSetCallback(CapturaCallback cb, void *ctx) {
+    callback = cb;
+    callbackCtx = ctx;
+}
+
+uint32_t capturaPoll() {
+    uint32_t entregues = 0;
+    uint32_t cauda = prontosCauda;
+
+    while (cauda != __atomic_load_n(&prontosCabeca, __ATOMIC_ACQUIRE)) {
+        uint8_t bloco = filaProntos[cauda % CAPTURA_NUM_BLOCOS];
+        if (callback) {
+            callback(amostras[bloco], tamBloco, seqBloco[bloco], callbackCtx);
+        }
+        __atomic_store_n(&prontosCauda, ++cauda, __ATOMIC_RELEASE);
+
+        // Devolve o bloco para o DMA
+        uint32_t cabeca = livresCabeca;
+        filaLivres[cabeca % CAPTURA_NUM_BLOCOS] = bloco;
+        __atomic_store_n(&livresCabeca, cabeca + 1, __ATOMIC_RELEASE);
+        entregues++;
+    }
+    stats.blocosEntregues += entregues;
+    return entregues;
+}
+
+void capturaGetStats(CapturaStats *s) {
+    s->blocosCompletos = stats.blocosCompletos;
+    s->blocosEntregues = stats.blocosEntregues;
+    s->overruns = stats.overruns;
+}
+
+uint32_t capturaTaxa() {
+    return taxaReal;
+}
+
+uint8_t capturaCanais() {
+    return mascaraCanais;
+}
+
+uint8_t capturaNumCanais() {
+    return numCanais;
+}
+
+size_t capturaTamBloco() {
+    return tamBloco;
+}
+
+uint32_t capturaDefasagemNs(uint8_t indice) {
+    if (taxaReal == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)indice * 1000000000u / ((uint64_t)taxaReal * numCanais));
+}
+
+int16_t capturaTemperatura(uint16_t leitura) {
+    int32_t microvolts = (int32_t)((uint32_t)leitura * 3300000u / 4096);
+    return (int16_t)(270 - (microvolts - 706000) * 10 / 1721);
+}
+
+uint32_t capturaInit(uint8_t canal, uint32_t taxa) {
+    if (canal >= CAPTURA_CANAIS_MAX) {
+        return 0;
+    }
+    return capturaInitCanais(1u << canal, taxa);
+}
+
+// Parte comum do init: valida a máscara e a taxa total e fixa o tamanho do bloco
+static bool configurarCanais(uint8_t mascara, uint32_t taxa) {
+    uint8_t n = CAPTURA_NUM_CANAIS(mascara);
+    if (n == 0 || mascara >= (1u << CAPTURA_CANAIS_MAX) || taxa == 0 || taxa > CAPTURA_TAXA_MAX / n) {
+        return false;
+    }
+    mascaraCanais = mascara;
+    numCanais = n;
+    taxaPedida = taxa;
+    tamBloco = CAPTURA_TAM_BLOCO / n * n;
+    return true;
+}
+
+#if PICO_ON_DEVICE
+
+static int canalDma[2];
+
+static uint8_t primeiroCanal() {
+    uint8_t canal = 0;
+    while (!(mascaraCanais & (1u << canal))) {
+        canal++;
+    }
+    return canal;
+}
+
+static void __not_in_flash_func(rearmarCanal)(int ch) {
+    // Só ajusta o endereço: o disparo vem do encadeamento com o outro canal
+    dma_channel_set_write_addr(canalDma[ch], amostras[blocoCanal[ch]], false);
+}
+
+static uint32_t periodoBlocoNs;  // Tempo do DMA para encher um bloco
+static uint32_t ultimoIrqUs;     // Último IRQ que completou blocos
+
+// Com o IRQ parado por mais de um bloco (o núcleo 1 preso enquanto o registro
+// mexe na flash, por exemplo), o DMA continua encadeando pelo anel e
+// sobrescreve blocos que nunca chegam a ser publicados, mas as flags dos dois
+// canais só contam um bloco cada. O tempo desde o IRQ anterior diz quantos
+// blocos completaram de fato; os que faltam viram overruns e saltos em 'seq'.
+static void __not_in_flash_func(contarPerdidos)(uint32_t completos) {
+    uint32_t agora = timer_hw->timerawl;
+    uint32_t decorrido = agora - ultimoIrqUs;
+    ultimoIrqUs = agora;
+    if (decorrido > UINT32_MAX / 1000) {
+        decorrido = UINT32_MAX / 1000;
+    }
+    // Arredondado para baixo: um IRQ atrasado que ainda pegou os dois canais
+    // não conta bloco perdido
+    uint32_t esperados = decorrido * 1000 / periodoBlocoNs;
+    if (esperados > completos) {
+        stats.overruns += esperados - completos;
+        seqAtual += esperados - completos;
+    }
+}
+
+static void __not_in_flash_func(capturaIrq)() {
+    uint32_t flags = dma_hw->ints1 & ((1u << canalDma[0]) | (1u << canalDma[1]));
+    if (!flags) {
+        return; // IRQ de outro módulo na mesma linha
+    }
+    dma_hw->ints1 = flags;
+    bool completou[2] = {flags & (1u << canalDma[0]), flags & (1u << canalDma[1])};
+    contarPerdidos(completou[0] + completou[1]);
+    for (int i = 0; i < 2; i++) {
+        if (completou[i]) {
+            blocoCompleto(i);
+        }
+    }
+}
+
+// O ADC converte a cada (1 + div) ciclos do clk_adc, com mínimo de 96 ciclos;
+// cada canal recebe uma a cada numCanais conversões
+uint32_t capturaAjustarRelogio() {
+    uint32_t clkAdc = clock_get_hz(clk_adc);
+    uint32_t div = clkAdc / (taxaPedida * numCanais) - 1;
+    adc_set_clkdiv(div);
+    taxaReal = clkAdc / (div + 1) / numCanais;
+    periodoBlocoNs = (uint32_t)((uint64_t)tamBloco * 1000000000u / ((uint64_t)taxaReal * numCanais));
+    return taxaReal;
+}
+
+uint32_t capturaInitCanais(uint8_t mascara, uint32_t taxa) {
+    if (!configurarCanais(mascara, taxa)) {
+        return 0;
+    }
+
+    adc_init();
+    for (uint8_t canal = 0; canal < 4; canal++) {
+        if (mascara & (1u << canal)) {
+            adc_gpio_init(26 + canal); // ADC0-3 ficam nos GP26-GP29
+        }
+    }
+    adc_set_temp_sensor_enabled(mascara & (1u << CAPTURA_CANAL_TEMPERATURA));
+    adc_select_input(primeiroCanal());
+    adc_set_round_robin(numCanais > 1 ? mascara : 0);
+    // FIFO ligado, DREQ a cada amostra, sem bit de erro e sem reduzir para 8 bits
+    adc_fifo_setup(true, true, 1, false, false);
+
+    capturaAjustarRelogio();
+
+    canalDma[0] = dma_claim_unused_channel(true);
+    canalDma[1] = dma_claim_unused_channel(true);
+    for (int i = 0; i < 2; i++) {
+        dma_channel_config c = dma_channel_get_default_config(canalDma[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_ring(&c, true, CAPTURA_BITS_ANEL);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, canalDma[i ^ 1]); // Ping-pong
+        dma_channel_configure(canalDma[i], &c, amostras[i], &adc_hw->fifo, tamBloco, false);
+        dma_channel_set_irq1_enabled(canalDma[i], true);
+    }
+
+    return taxaReal;
+}
+
+void capturaStart() {
+    static bool irqInstalado = false;
+    if (!irqInstalado) {
+        // Handler compartilhado: outros módulos podem usar a mesma linha de IRQ
+        irq_add_shared_handler(DMA_IRQ_1, capturaIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        irqInstalado = true;
+    }
+    reiniciarFilas();
+    for (int i = 0; i < 2; i++) {
+        dma_channel_set_write_addr(canalDma[i], amostras[blocoCanal[i]], false);
+        dma_channel_set_trans_count(canalDma[i], tamBloco, false);
+    }
+    adc_select_input(primeiroCanal()); // A varredura pode ter parado no meio de um quadro
+    adc_fifo_drain();
+    ultimoIrqUs = timer_hw->timerawl;
+    dma_channel_start(canalDma[0]);
+    adc_run(true);
+}
+
+void capturaStop() {
+    adc_run(false);
+    // Desliga o IRQ antes de abortar para não rearmar nem encadear durante o abort
+    dma_channel_set_irq1_enabled(canalDma[0], false);
+    dma_channel_set_irq1_enabled(canalDma[1], false);
+    dma_hw->abort = (1u << canalDma[0]) | (1u << canalDma[1]);
+    while (dma_hw->abort) {
+        tight_loop_contents();
+    }
+    dma_hw->ints1 = (1u << canalDma[0]) | (1u << canalDma[1]);
+    dma_channel_set_irq1_enabled(canalDma[0], true);
+    dma_channel_set_irq1_enabled(canalDma[1], true);
+    adc_fifo_drain();
+}
+
+#else
+
+static bool rodando;
+static int canalAtivo;
+static size_t posicao;
+
+static void rearmarCanal(int ch) {
+    (void)ch;
+}
+
+uint32_t capturaInitCanais(uint8_t mascara, uint32_t taxa) {
+    if (!configurarCanais(mascara, taxa)) {
+        return 0;
+    }
+    taxaReal = taxa;
+    return taxaReal;
+}
+
+uint32_t capturaAjustarRelogio() {
+    return taxaReal;
+}
+
+void capturaStart() {
+    reiniciarFilas();
+    canalAtivo = 0;
+    posicao = 0;
+    rodando = true;
+}
+
+void capturaStop() {
+    rodando = false;
+}
+
+void capturaSinteticaAlimentar(const uint16_t *src, size_t n) {
+    while (rodando && n > 0) {
+        size_t livre = tamBloco - posicao;
+        size_t copiar = n < livre ? n : livre;
+        memcpy(&amostras[blocoCanal[canalAtivo]][posicao], src, copiar * sizeof(uint16_t));
+        posicao += copiar;
+        src += copiar;
+        n -= copiar;
+
+        if (posicao == tamBloco) {
+            // Mesma ordem do hardware: o canal completa e o outro assume
+            blocoCompleto(canalAtivo);
+            canalAtivo ^= 1;
+            posicao = 0;
+        }
+    }
+}
+
+#endif
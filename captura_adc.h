@@ -0,0 +1,78 @@
+#ifndef CAPTURA_ADC_H
+#define CAPTURA_ADC_H
+
+#include "plataforma.h"
+
+// Captura contínua do ADC: o ADC roda livre (adc_run) e o FIFO é esvaziado por
+// dois canais DMA encadeados (ping-pong), que se revezam preenchendo blocos de
+// amostras de um anel. Blocos completos são entregues a um callback no
+// contexto de thread por capturaPoll().
+//
+// Com vários canais o ADC faz a varredura round-robin (adc_set_round_robin):
+// converte os canais da máscara em ordem crescente, um após o outro, e o bloco
+// chega entrelaçado em quadros de capturaNumCanais() amostras, sempre começando
+// pelo canal mais baixo. O bloco passa a ter o maior múltiplo do número de
+// canais que cabe em CAPTURA_TAM_BLOCO, para que nenhum quadro fique dividido.
+// Para separar os canais e alinhá-los no tempo, ver desentrelacador.h.
+
+#define CAPTURA_TAM_BLOCO 256   // Amostras por bloco
+#define CAPTURA_NUM_BLOCOS 8    // Blocos no anel (potência de 2)
+#define CAPTURA_TAXA_MAX 500000 // Limite do ADC do RP2040 (96 ciclos de 48 MHz), somando todos os canais
+#define CAPTURA_CANAIS_MAX 5
+#define CAPTURA_CANAL_TEMPERATURA 4 // Sensor de temperatura interno (ADC4)
+
+// Número de canais numa máscara (bit i = ADCi), como expressão constante
+#define CAPTURA_NUM_CANAIS(mascara) \
+    (((mascara) & 1) + ((mascara) >> 1 & 1) + ((mascara) >> 2 & 1) + ((mascara) >> 3 & 1) + ((mascara) >> 4 & 1))
+
+// Recebe um bloco completo. 'seq' conta todos os blocos completados pelo DMA
+// (inclusive os descartados), então um salto em 'seq' indica perda de dados.
+typedef void (*CapturaCallback)(const uint16_t *amostras, size_t n, uint32_t seq, void *ctx);
+
+typedef struct {
+    uint32_t blocosCompletos; // Blocos preenchidos pelo DMA
+    uint32_t blocosEntregues; // Blocos entregues ao callback
+    uint32_t overruns;        // Blocos descartados por falta de bloco livre ou sobrescritos com o IRQ parado
+} CapturaStats;
+
+// Configura o ADC no canal 'canal' (0-4) com a taxa pedida em amostras/s.
+// Retorna a taxa real obtida pelo divisor do ADC (0 se a taxa for inválida).
+uint32_t capturaInit(uint8_t canal, uint32_t taxa);
+
+// Varredura dos canais de 'mascara' (bit i = ADCi; o bit 4 liga o sensor de
+// temperatura). 'taxa' é por canal: o ADC converte taxa * número de canais.
+// Retorna a taxa real por canal (0 se a máscara ou a taxa forem inválidas).
+uint32_t capturaInitCanais(uint8_t mascara, uint32_t taxa);
+void capturaSetCallback(CapturaCallback cb, void *ctx);
+
+// O IRQ do DMA fica no núcleo que chama capturaStart(); o init e o callback
+// podem ser configurados antes, por outro núcleo
+void capturaStart();
+void capturaStop();
+
+// Recalcula o divisor do ADC pelo clk_adc atual, mantendo a taxa pedida; usada
+// depois de mudanças de clock (relogio.h). Retorna a taxa real por canal.
+uint32_t capturaAjustarRelogio();
+
+// Entrega ao callback os blocos prontos. Retorna quantos foram entregues.
+uint32_t capturaPoll();
+void capturaGetStats(CapturaStats *stats);
+uint32_t capturaTaxa();         // Por canal
+uint8_t capturaCanais();        // Máscara configurada
+uint8_t capturaNumCanais();
+size_t capturaTamBloco();       // Amostras por bloco entregue (todos os canais)
+
+// Atraso do canal na posição 'indice' do quadro em relação ao primeiro, em ns
+uint32_t capturaDefasagemNs(uint8_t indice);
+
+// Converte a leitura do sensor de temperatura (0-4095) em décimos de grau
+// Celsius, pela fórmula do datasheet do RP2040 (0,706 V a 27 °C, -1,721 mV/°C)
+int16_t capturaTemperatura(uint16_t leitura);
+
+#if !PICO_ON_DEVICE
+// Fonte sintética para o build de host: faz o papel do DMA, copiando as
+// amostras para o bloco do canal ativo e completando os blocos cheios.
+void capturaSinteticaAlimentar(const uint16_t *amostras, size_t n);
+#endif
+
+#endif
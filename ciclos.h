@@ -0,0 +1,47 @@
+#ifndef CICLOS_H
+#define CICLOS_H
+
+#include "plataforma.h"
+
+// Contador de ciclos para medir custo de trechos curtos de código.
+// Na placa usa o SysTick do núcleo atual (24 bits, decrescente, no clk_sys),
+// então só mede intervalos menores que 2^24 ciclos (~134 ms a 125 MHz).
+// No host conta nanossegundos.
+
+#if PICO_ON_DEVICE
+#include "hardware/structs/systick.h"
+
+#define CICLOS_MASCARA 0x00FFFFFFu
+
+// Precisa ser chamada uma vez em cada núcleo que for medir
+static inline void ciclosInit() {
+    systick_hw->rvr = CICLOS_MASCARA;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5; // Habilitado, clock do processador, sem interrupção
+}
+
+static inline uint32_t ciclosAgora() {
+    return systick_hw->cvr;
+}
+
+static inline uint32_t ciclosDesde(uint32_t inicio) {
+    return (inicio - systick_hw->cvr) & CICLOS_MASCARA;
+}
+#else
+#include <time.h>
+
+static inline void ciclosInit() {
+}
+
+static inline uint32_t ciclosAgora() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+}
+
+static inline uint32_t ciclosDesde(uint32_t inicio) {
+    return ciclosAgora() - inicio;
+}
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+#include "desentrelacador.h"
+
+bool desentrelacadorInit(Desentrelacador *d, uint8_t numCanais, bool alinhar) {
+    if (numCanais == 0 || numCanais > DESENTRELACADOR_CANAIS_MAX) {
+        return false;
+    }
+    d->numCanais = numCanais;
+    d->alinhar = alinhar;
+    d->primeiro = true;
+    for (uint8_t i = 0; i < numCanais; i++) {
+        d->peso[i] = (uint16_t)((i << DESENTRELACADOR_FRACAO) / numCanais);
+        d->anterior[i] = 0;
+    }
+    return true;
+}
+
+// Um canal por vez: o laço interno anda de N em N na entrada e mantém a
+// amostra anterior em registrador
+size_t __not_in_flash_func(desentrelacadorProcessar)(Desentrelacador *d, const uint16_t *entrada, size_t n,
+                                                     uint16_t *const *saida) {
+    uint8_t canais = d->numCanais;
+    size_t quadros = n / canais;
+    if (quadros == 0) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < canais; i++) {
+        const uint16_t *src = entrada + i;
+        uint16_t *dst = saida[i];
+        int32_t peso = d->peso[i];
+
+        if (!d->alinhar || peso == 0) {
+            for (size_t k = 0; k < quadros; k++, src += canais) {
+                dst[k] = *src;
+            }
+        } else {
+            int32_t anterior = d->primeiro ? *src : d->anterior[i];
+            for (size_t k = 0; k < quadros; k++, src += canais) {
+                int32_t x = *src;
+                dst[k] = (uint16_t)(x - ((peso * (x - anterior) + (1 << (DESENTRELACADOR_FRACAO - 1))) >> DESENTRELACADOR_FRACAO));
+                anterior = x;
+            }
+        }
+        d->anterior[i] = entrada[(quadros - 1) * canais + i];
+    }
+    d->primeiro = false;
+    return quadros;
+}
@@ -0,0 +1,34 @@
+#ifndef DESENTRELACADOR_H
+#define DESENTRELACADOR_H
+
+#include "plataforma.h"
+
+// Separa os blocos da varredura round-robin do ADC (captura_adc.h) em um
+// bloco por canal e compensa a defasagem entre eles.
+//
+// Com N canais, o canal i de cada quadro é convertido i períodos do ADC depois
+// do canal 0, ou seja, atrasado de i/N do período do quadro. Com o alinhamento
+// ligado, cada canal é levado ao instante do canal 0 por interpolação linear
+// com a amostra anterior do mesmo canal (pesos em Q15, calculados no init):
+//   y[n] = x[n] - (i/N) * (x[n] - x[n-1])
+// A amostra anterior continua de um bloco para o outro.
+
+#define DESENTRELACADOR_CANAIS_MAX 5
+#define DESENTRELACADOR_FRACAO 15
+
+typedef struct {
+    uint8_t numCanais;
+    bool alinhar;
+    bool primeiro;                                  // Ainda não há amostra anterior
+    uint16_t peso[DESENTRELACADOR_CANAIS_MAX];      // i/N em Q15
+    uint16_t anterior[DESENTRELACADOR_CANAIS_MAX];  // Última amostra de cada canal
+} Desentrelacador;
+
+bool desentrelacadorInit(Desentrelacador *d, uint8_t numCanais, bool alinhar);
+
+// Consome 'n' amostras entrelaçadas (n múltiplo de numCanais, começando no
+// canal 0) e escreve n / numCanais amostras em cada saida[i]. Retorna quantas
+// amostras cada canal recebeu.
+size_t desentrelacadorProcessar(Desentrelacador *d, const uint16_t *entrada, size_t n, uint16_t *const *saida);
+
+#endif
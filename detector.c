@@ -0,0 +1,155 @@
+#include <math.h>
+#include "detector.h"
+#include "ciclos.h"
+
+static const uint16_t frequencias[DETECTOR_NUM_BINS] = {50, 60, 100, 120};
+
+static void reiniciarJanela(Detector *d) {
+    for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+        d->s1[b] = 0;
+        d->s2[b] = 0;
+    }
+    d->soma = 0;
+    d->somaQuad = 0;
+    d->minimo = UINT16_MAX;
+    d->maximo = 0;
+    d->contagem = 0;
+}
+
+bool detectorInit(Detector *d, uint32_t taxa, uint8_t bits) {
+    if (bits < 12 || bits > 16) {
+        return false;
+    }
+    uint8_t bitsExtra = bits - 12;
+    uint32_t taxaMax = DETECTOR_TAXA_MAX >> ((bitsExtra + 1) / 2);
+    if (taxa < 2 * frequencias[DETECTOR_NUM_BINS - 1] * DETECTOR_JANELAS_POR_SEG || taxa > taxaMax) {
+        return false;
+    }
+    d->janela = taxa / DETECTOR_JANELAS_POR_SEG;
+    d->bitsExtra = bitsExtra;
+
+    // Coeficientes calculados uma única vez; o processamento por amostra é todo inteiro
+    for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+        double w = 2.0 * M_PI * frequencias[b] / taxa;
+        d->cos[b] = (int32_t)lround(cos(w) * (1 << 30));
+        d->sen[b] = (int32_t)lround(sin(w) * (1 << 30));
+    }
+    d->dc = 2048 << bitsExtra; // Meio da escala até a primeira janela fechar
+    d->ciclosUltimo = 0;
+    d->ciclosMax = 0;
+    reiniciarJanela(d);
+    return true;
+}
+
+uint32_t isqrt64(uint64_t x) {
+    uint64_t r = 0;
+    uint64_t bit = 1ull << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= r + bit) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// |X(k)| = |s1 - e^(-jw) * s2|, e a amplitude de pico da senoide é 2|X(k)|/N
+static uint16_t amplitudeBin(const Detector *d, int b) {
+    int64_t re = d->s1[b] - (((int64_t)d->cos[b] * d->s2[b]) >> 30);
+    int64_t im = ((int64_t)d->sen[b] * d->s2[b]) >> 30;
+    uint64_t mag = isqrt64((uint64_t)(re * re) + (uint64_t)(im * im));
+    uint64_t amp = 2 * mag / d->janela;
+    return amp > UINT16_MAX ? UINT16_MAX : (uint16_t)amp;
+}
+
+// DC, RMS e pico das 'n' amostras acumuladas na janela
+static void medirJanela(const Detector *d, int32_t n, DetectorResultado *res) {
+    int32_t media = (int32_t)(d->soma / n);
+
+    // Variância sem o DC: (somaQuad - soma^2 / n) / n
+    uint64_t var = (d->somaQuad - (uint64_t)((d->soma * d->soma) / n)) / n;
+    res->dc = (uint16_t)(d->dc + media);
+    res->rms = (uint16_t)isqrt64(var);
+
+    int32_t desvioMax = (int32_t)d->maximo - res->dc;
+    int32_t desvioMin = (int32_t)res->dc - d->minimo;
+    res->pico = (uint16_t)(desvioMax > desvioMin ? desvioMax : desvioMin);
+}
+
+static void fecharJanela(Detector *d, DetectorResultado *res) {
+    medirJanela(d, (int32_t)d->janela, res);
+    for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+        res->amplitude[b] = amplitudeBin(d, b);
+    }
+
+    // Cada família de rede soma a fundamental e o primeiro harmônico
+    uint32_t familia50 = isqrt64((uint64_t)res->amplitude[DETECTOR_50HZ] * res->amplitude[DETECTOR_50HZ] +
+                                 (uint64_t)res->amplitude[DETECTOR_100HZ] * res->amplitude[DETECTOR_100HZ]);
+    uint32_t familia60 = isqrt64((uint64_t)res->amplitude[DETECTOR_60HZ] * res->amplitude[DETECTOR_60HZ] +
+                                 (uint64_t)res->amplitude[DETECTOR_120HZ] * res->amplitude[DETECTOR_120HZ]);
+    uint32_t familia = familia50 > familia60 ? familia50 : familia60;
+    res->rede = familia50 > familia60 ? 50 : 60;
+
+    // Senoide de escala cheia tem amplitude 2048 (em 12 bits): dobra para a escala 0-4095 do ADC
+    uint32_t intensidade = (familia * 2) >> d->bitsExtra;
+    res->intensidade = intensidade > 4095 ? 4095 : (uint16_t)intensidade;
+
+    d->dc = res->dc;
+    reiniciarJanela(d);
+}
+
+bool detectorParcial(const Detector *d, uint32_t minimo, DetectorResultado *res) {
+    if (d->contagem == 0 || d->contagem < minimo) {
+        return false;
+    }
+    medirJanela(d, (int32_t)d->contagem, res);
+    for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+        res->amplitude[b] = 0;
+    }
+    res->rede = 0;
+
+    // Amplitude sqrt(2) * RMS, dobrada como em fecharJanela(): 2 * sqrt(2) em Q7
+    uint32_t intensidade = ((uint32_t)res->rms * 362 >> 7) >> d->bitsExtra;
+    res->intensidade = intensidade > 4095 ? 4095 : (uint16_t)intensidade;
+    return true;
+}
+
+bool __not_in_flash_func(detectorProcessar)(Detector *d, const uint16_t *amostras, size_t n, DetectorResultado *res) {
+    uint32_t inicio = ciclosAgora();
+    bool fechou = false;
+
+    for (size_t i = 0; i < n; i++) {
+        uint16_t amostra = amostras[i];
+        int32_t x = (int32_t)amostra - d->dc;
+
+        if (amostra < d->minimo) d->minimo = amostra;
+        if (amostra > d->maximo) d->maximo = amostra;
+        d->soma += x;
+        d->somaQuad += (uint32_t)x * (uint32_t)x; // |x| < 2^16: o quadrado cabe em 32 bits sem sinal
+
+        // s[n] = x[n] + 2cos(w) s[n-1] - s[n-2]
+        for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+            int32_t s0 = x + (int32_t)(((int64_t)d->cos[b] * d->s1[b]) >> 29) - d->s2[b];
+            d->s2[b] = d->s1[b];
+            d->s1[b] = s0;
+        }
+
+        if (++d->contagem == d->janela) {
+            fecharJanela(d, res);
+            fechou = true;
+        }
+    }
+
+    d->ciclosUltimo = ciclosDesde(inicio);
+    if (d->ciclosUltimo > d->ciclosMax) {
+        d->ciclosMax = d->ciclosUltimo;
+    }
+    return fechou;
+}
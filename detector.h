@@ -0,0 +1,69 @@
+#ifndef DETECTOR_H
+#define DETECTOR_H
+
+#include "plataforma.h"
+
+// Detector de campo sincronizado com a rede elétrica. Processa as amostras em
+// janelas de 100 ms (resolução de 10 Hz, então 50, 60, 100 e 120 Hz caem em
+// bins inteiros) e calcula, só com aritmética inteira:
+//  - nível DC, RMS e pico sem o DC;
+//  - amplitude das componentes de 50/60 Hz e dos seus harmônicos (100/120 Hz)
+//    por um banco de filtros de Goertzel em ponto fixo (Q30).
+
+#define DETECTOR_TAXA_MAX 50000 // Com 12 bits; acima disso o estado do Goertzel estoura 32 bits
+#define DETECTOR_JANELAS_POR_SEG 10
+
+enum {
+    DETECTOR_50HZ,
+    DETECTOR_60HZ,
+    DETECTOR_100HZ,
+    DETECTOR_120HZ,
+    DETECTOR_NUM_BINS
+};
+
+typedef struct {
+    uint16_t dc;                             // Média da janela (na escala da entrada)
+    uint16_t rms;                            // RMS sem o DC
+    uint16_t pico;                           // Maior desvio em relação ao DC
+    uint16_t amplitude[DETECTOR_NUM_BINS];   // Amplitude de pico de cada bin
+    uint16_t intensidade;                    // Intensidade final, 0-4095 (escala de 12 bits)
+    uint8_t rede;                            // Família dominante: 50 ou 60 (Hz)
+} DetectorResultado;
+
+typedef struct {
+    uint32_t janela;                    // Amostras por janela
+    uint8_t bitsExtra;                  // Bits da entrada além dos 12 do ADC
+    int32_t cos[DETECTOR_NUM_BINS];     // cos(w) em Q30
+    int32_t sen[DETECTOR_NUM_BINS];     // sen(w) em Q30
+    int32_t s1[DETECTOR_NUM_BINS];      // Estado do Goertzel
+    int32_t s2[DETECTOR_NUM_BINS];
+    int32_t dc;                         // DC da janela anterior, removido antes do filtro
+    int64_t soma;                       // Soma de (x - dc)
+    uint64_t somaQuad;                  // Soma de (x - dc)^2
+    uint16_t minimo, maximo;            // Extremos da janela, para o pico
+    uint32_t contagem;
+    uint32_t ciclosUltimo;              // Custo da última chamada de detectorProcessar
+    uint32_t ciclosMax;
+} Detector;
+
+// 'bits' é a resolução das amostras: 12 para o ADC direto, até 16 depois do
+// dizimador (dizimador.h). O estado do Goertzel cresce com a amplitude e com o
+// quadrado da taxa, então a taxa máxima cai à metade a cada 2 bits extras (ou fração).
+// DC, RMS, pico e amplitudes ficam na escala da entrada; a intensidade é
+// sempre devolvida na escala de 12 bits.
+bool detectorInit(Detector *d, uint32_t taxa, uint8_t bits);
+
+// Consome 'n' amostras. Retorna true se ao menos uma janela foi fechada,
+// deixando em 'res' o resultado da última.
+bool detectorProcessar(Detector *d, const uint16_t *amostras, size_t n, DetectorResultado *res);
+
+// Estimativa da janela ainda aberta, para não esperar os 100 ms da primeira:
+// DC, RMS e pico das amostras que já entraram, e a intensidade pelo RMS (a de
+// uma senoide pura, sqrt(2) * RMS, na mesma escala). Com menos de um período
+// de 10 Hz os bins não se separam: amplitudes ficam zeradas e 'rede' em 0.
+// Retorna false se a janela tem menos de 'minimo' amostras.
+bool detectorParcial(const Detector *d, uint32_t minimo, DetectorResultado *res);
+
+uint32_t isqrt64(uint64_t x);
+
+#endif
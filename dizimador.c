@@ -0,0 +1,69 @@
+#include "dizimador.h"
+#include "ciclos.h"
+
+bool dizimadorInit(Dizimador *z, uint32_t razao) {
+    if (razao < DIZIMADOR_RAZAO_MIN || razao > DIZIMADOR_RAZAO_MAX || (razao & (razao - 1)) != 0) {
+        return false;
+    }
+    uint8_t log2Razao = 0;
+    while ((1u << log2Razao) < razao) {
+        log2Razao++;
+    }
+    z->razao = razao;
+    z->deslocamento = 12 + DIZIMADOR_ORDEM * log2Razao - DIZIMADOR_BITS_SAIDA;
+    z->fase = 0;
+    for (int i = 0; i < DIZIMADOR_ORDEM; i++) {
+        z->integrador[i] = 0;
+        z->atraso[i] = 0;
+    }
+    z->ciclosUltimo = 0;
+    z->saidasUltimo = 0;
+    return true;
+}
+
+// Os integradores ficam em registradores durante o bloco: três somas por
+// amostra. O interpolador do RP2040 não ajuda aqui, já que cada acumulação nele
+// custaria acessos ao barramento do SIO no lugar de uma soma em registrador.
+size_t __not_in_flash_func(dizimadorProcessar)(Dizimador *z, const uint16_t *entrada, size_t n, uint16_t *saida) {
+    uint32_t inicio = ciclosAgora();
+    uint32_t i1 = z->integrador[0], i2 = z->integrador[1], i3 = z->integrador[2];
+    size_t k = 0;
+
+    while (n > 0) {
+        // Trecho até a próxima saída (ou até o fim do bloco), sem teste por amostra
+        uint32_t trecho = z->razao - z->fase;
+        if (trecho > n) {
+            trecho = n;
+        }
+        for (uint32_t i = 0; i < trecho; i++) {
+            i1 += entrada[i];
+            i2 += i1;
+            i3 += i2;
+        }
+        entrada += trecho;
+        n -= trecho;
+        z->fase += trecho;
+
+        if (z->fase == z->razao) {
+            z->fase = 0;
+            uint32_t c1 = i3 - z->atraso[0];
+            z->atraso[0] = i3;
+            uint32_t c2 = c1 - z->atraso[1];
+            z->atraso[1] = c1;
+            uint32_t c3 = c2 - z->atraso[2];
+            z->atraso[2] = c2;
+            saida[k++] = (uint16_t)(c3 >> z->deslocamento);
+        }
+    }
+
+    z->integrador[0] = i1;
+    z->integrador[1] = i2;
+    z->integrador[2] = i3;
+    z->saidasUltimo = k;
+    z->ciclosUltimo = ciclosDesde(inicio);
+    return k;
+}
+
+uint32_t dizimadorCiclosPorSaida(const Dizimador *z) {
+    return z->saidasUltimo ? z->ciclosUltimo / z->saidasUltimo : 0;
+}
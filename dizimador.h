@@ -0,0 +1,42 @@
+#ifndef DIZIMADOR_H
+#define DIZIMADOR_H
+
+#include "plataforma.h"
+
+// Sobreamostragem e dizimação: o ADC roda 'razao' vezes mais rápido que a
+// taxa de saída e um filtro CIC (cascaded integrator-comb) de ordem 3 reduz a
+// taxa, somando as amostras. Com ruído branco cada fator 4 de razão ganha 1 bit
+// efetivo: 14 bits com razão 16, 15 bits com razão 64.
+//
+// Os integradores trabalham em aritmética módulo 2^32 (o estouro se cancela
+// nos pentes), então o resultado é exato enquanto 12 + 3*log2(razao) <= 32.
+// A saída é alinhada em 16 bits: 0-65520, ou seja, a escala 0-4095 do ADC
+// multiplicada por 16, com os bits extras abaixo.
+
+#define DIZIMADOR_ORDEM 3
+#define DIZIMADOR_RAZAO_MIN 4
+#define DIZIMADOR_RAZAO_MAX 64
+#define DIZIMADOR_BITS_SAIDA 16
+
+typedef struct {
+    uint32_t razao;
+    uint8_t deslocamento;                 // Tira o ganho razao^3 e deixa 16 bits
+    uint32_t fase;                        // Amostras acumuladas desde a última saída
+    uint32_t integrador[DIZIMADOR_ORDEM];
+    uint32_t atraso[DIZIMADOR_ORDEM];     // Entrada anterior de cada pente
+    uint32_t ciclosUltimo;                // Custo da última chamada de dizimadorProcessar
+    uint32_t saidasUltimo;                // Saídas produzidas nela
+} Dizimador;
+
+// 'razao' deve ser potência de 2 entre DIZIMADOR_RAZAO_MIN e DIZIMADOR_RAZAO_MAX
+bool dizimadorInit(Dizimador *z, uint32_t razao);
+
+// Consome 'n' amostras de 12 bits e escreve em 'saida' as amostras dizimadas
+// (até n / razao + 1). Retorna quantas foram escritas. Pode ser chamada com
+// blocos de qualquer tamanho: a fase continua entre as chamadas.
+size_t dizimadorProcessar(Dizimador *z, const uint16_t *entrada, size_t n, uint16_t *saida);
+
+// Custo da última chamada por amostra de saída, em ciclos (ver ciclos.h)
+uint32_t dizimadorCiclosPorSaida(const Dizimador *z);
+
+#endif
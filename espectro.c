@@ -0,0 +1,239 @@
+#include <math.h>
+#include <string.h>
+#include "espectro.h"
+#include "ciclos.h"
+
+#define ESPECTRO_METADE (ESPECTRO_PONTOS / 2)
+#define ESPECTRO_ESCALA_ENTRADA 3  // 12 bits centrados -> Q15
+// Um butterfly pode crescer até (1 + sqrt(2)) vezes. Até LIMITE_1 o estágio
+// fica sem escala (saída até 27146); até LIMITE_2 é dividido por 2 e acima
+// disso por 4, sempre abaixo de 32767
+#define ESPECTRO_LIMITE_1 11244
+#define ESPECTRO_LIMITE_2 27146
+#define ESPECTRO_BITS_LOG 5        // Bits de mantissa na tabela do log2
+
+static int16_t janela[ESPECTRO_PONTOS];          // Hann em Q15
+static int16_t cosseno[ESPECTRO_METADE];         // cos(2*pi*k/N) em Q15
+static int16_t seno[ESPECTRO_METADE];            // sen(2*pi*k/N) em Q15
+static uint16_t reverso[ESPECTRO_PONTOS];        // Índice com os bits invertidos
+static uint16_t tabelaLog[1 << ESPECTRO_BITS_LOG]; // log2(1 + i/32) em Q8
+static uint16_t inicioBarra[ESPECTRO_BARRAS + 1];
+static uint16_t inicioBanda[ESPECTRO_BANDAS + 1];
+static int32_t referencia;                       // log2 do |X|^2 de fundo de escala, em Q8
+
+static int16_t re[ESPECTRO_PONTOS], im[ESPECTRO_PONTOS];
+static uint8_t expoente;
+
+static uint16_t entrada[ESPECTRO_PONTOS];
+static uint32_t preenchidas; // Amostras já copiadas para 'entrada'
+static uint32_t espera;      // Amostras a ignorar até o próximo espectro
+static uint32_t intervalo;   // Amostras entre o início de dois espectros
+static uint32_t taxaEntrada;
+static uint32_t ciclosMax;
+
+static int16_t q15(double x) {
+    long v = lround(x * 32768.0);
+    return (int16_t)(v > 32767 ? 32767 : v);
+}
+
+// Bordas em progressão geométrica entre o bin 1 e Nyquist, com ao menos um
+// bin por faixa (nas frequências baixas as faixas ficam com um bin cada)
+static void calcularFaixas(uint16_t *inicio, uint8_t n) {
+    inicio[0] = 1;
+    for (uint8_t i = 1; i <= n; i++) {
+        uint16_t borda = (uint16_t)lround(pow(ESPECTRO_METADE, (double)i / n));
+        uint16_t minimo = inicio[i - 1] + 1;
+        uint16_t maximo = ESPECTRO_METADE - (n - i);
+        inicio[i] = borda < minimo ? minimo : borda > maximo ? maximo : borda;
+    }
+}
+
+bool espectroInit(uint32_t taxa, uint32_t porSegundo) {
+    if (taxa == 0 || porSegundo == 0 || taxa / porSegundo < ESPECTRO_PONTOS) {
+        return false;
+    }
+    double somaJanela = 0;
+    for (uint32_t i = 0; i < ESPECTRO_PONTOS; i++) {
+        janela[i] = q15(0.5 - 0.5 * cos(2 * M_PI * i / ESPECTRO_PONTOS));
+        somaJanela += janela[i] / 32768.0;
+
+        uint16_t r = 0;
+        for (uint8_t b = 0; b < ESPECTRO_LOG2_PONTOS; b++) {
+            r |= ((i >> b) & 1) << (ESPECTRO_LOG2_PONTOS - 1 - b);
+        }
+        reverso[i] = r;
+    }
+    for (uint32_t k = 0; k < ESPECTRO_METADE; k++) {
+        cosseno[k] = q15(cos(2 * M_PI * k / ESPECTRO_PONTOS));
+        seno[k] = q15(sin(2 * M_PI * k / ESPECTRO_PONTOS));
+    }
+    for (uint32_t i = 0; i < (1u << ESPECTRO_BITS_LOG); i++) {
+        tabelaLog[i] = (uint16_t)lround(log2(1.0 + (double)i / (1 << ESPECTRO_BITS_LOG)) * 256);
+    }
+    calcularFaixas(inicioBarra, ESPECTRO_BARRAS);
+    calcularFaixas(inicioBanda, ESPECTRO_BANDAS);
+
+    // Senoide de 0 a 4095: amplitude 2047,5 na entrada, somaJanela/2 de ganho no bin
+    double pico = 2047.5 * (1 << ESPECTRO_ESCALA_ENTRADA) * somaJanela / 2;
+    referencia = (int32_t)lround(log2(pico * pico) * 256);
+
+    taxaEntrada = taxa;
+    intervalo = taxa / porSegundo;
+    preenchidas = 0;
+    espera = 0;
+    ciclosMax = 0;
+    return true;
+}
+
+// log2(x) em Q8, com 5 bits de mantissa (erro abaixo de 0,05, ou 0,15 dB)
+static int32_t log2Q8(uint32_t x) {
+    if (x == 0) {
+        return 0;
+    }
+    int32_t e = 31 - __builtin_clz(x);
+    uint32_t mantissa = e >= ESPECTRO_BITS_LOG ? x >> (e - ESPECTRO_BITS_LOG) : x << (ESPECTRO_BITS_LOG - e);
+    return (e << 8) + tabelaLog[mantissa & ((1 << ESPECTRO_BITS_LOG) - 1)];
+}
+
+// |X|^2 em escala logarítmica: 0 a ESPECTRO_FAIXA_DB abaixo do fundo de escala -> 0 a 255
+static uint8_t nivel(uint32_t magnitude2) {
+    if (magnitude2 == 0) {
+        return 0;
+    }
+    int32_t l = log2Q8(magnitude2) + (expoente << 9) - referencia;
+    int32_t dbQ8 = (l * 771) >> 8; // 10*log10(2) = 3,0103 = 771/256
+    int32_t v = (dbQ8 + (ESPECTRO_FAIXA_DB << 8)) * 255 / (ESPECTRO_FAIXA_DB << 8);
+    return (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v);
+}
+
+static uint32_t magnitude2(uint16_t k) {
+    return (uint32_t)((int32_t)re[k] * re[k]) + (uint32_t)((int32_t)im[k] * im[k]);
+}
+
+// Maior |X|^2 de cada faixa, convertido em nível
+static void niveisFaixas(const uint16_t *inicio, uint8_t n, uint8_t *saida) {
+    for (uint8_t i = 0; i < n; i++) {
+        uint32_t maior = 0;
+        for (uint16_t k = inicio[i]; k < inicio[i + 1]; k++) {
+            uint32_t m = magnitude2(k);
+            if (m > maior) {
+                maior = m;
+            }
+        }
+        saida[i] = nivel(maior);
+    }
+}
+
+void __not_in_flash_func(espectroCalcular)(const uint16_t *amostras, EspectroQuadro *q) {
+    uint32_t inicio = ciclosAgora();
+
+    // Tira o DC, aplica a janela e já grava na ordem de bits invertidos
+    uint32_t soma = 0;
+    for (uint32_t i = 0; i < ESPECTRO_PONTOS; i++) {
+        soma += amostras[i];
+    }
+    int32_t media = soma >> ESPECTRO_LOG2_PONTOS;
+    int32_t maior = 0;
+    for (uint32_t i = 0; i < ESPECTRO_PONTOS; i++) {
+        int32_t x = (((int32_t)amostras[i] - media) << ESPECTRO_ESCALA_ENTRADA) * janela[i] >> 15;
+        re[reverso[i]] = (int16_t)x;
+        im[reverso[i]] = 0;
+        int32_t a = x < 0 ? -x : x;
+        if (a > maior) {
+            maior = a;
+        }
+    }
+
+    // Butterflies: (a, b) -> (a + W*b, a - W*b), W = cos - j*sen
+    expoente = 0;
+    for (uint32_t tam = 2; tam <= ESPECTRO_PONTOS; tam <<= 1) {
+        uint32_t metade = tam >> 1;
+        uint32_t passo = ESPECTRO_PONTOS / tam;
+        uint32_t d = (maior > ESPECTRO_LIMITE_1) + (maior > ESPECTRO_LIMITE_2); // Ponto flutuante em bloco
+        expoente += d;
+        maior = 0;
+        for (uint32_t j = 0; j < metade; j++) {
+            int32_t c = cosseno[j * passo];
+            int32_t s = seno[j * passo];
+            for (uint32_t k = j; k < ESPECTRO_PONTOS; k += tam) {
+                uint32_t m = k + metade;
+                int32_t tr = (re[m] * c + im[m] * s + (1 << 14)) >> 15;
+                int32_t ti = (im[m] * c - re[m] * s + (1 << 14)) >> 15;
+                int32_t ar = re[k], ai = im[k];
+                int32_t v0 = (ar + tr) >> d, v1 = (ai + ti) >> d;
+                int32_t v2 = (ar - tr) >> d, v3 = (ai - ti) >> d;
+                re[k] = (int16_t)v0;
+                im[k] = (int16_t)v1;
+                re[m] = (int16_t)v2;
+                im[m] = (int16_t)v3;
+                int32_t a = (v0 < 0 ? -v0 : v0) | (v1 < 0 ? -v1 : v1) | (v2 < 0 ? -v2 : v2) | (v3 < 0 ? -v3 : v3);
+                if (a > maior) {
+                    maior = a; // O OU dos módulos fica abaixo do dobro do maior: basta para o teste
+                }
+            }
+        }
+    }
+
+    niveisFaixas(inicioBarra, ESPECTRO_BARRAS, q->barras);
+    niveisFaixas(inicioBanda, ESPECTRO_BANDAS, q->bandas);
+    uint32_t picoMag = 0;
+    q->pico = 1;
+    for (uint16_t k = 1; k < ESPECTRO_METADE; k++) {
+        uint32_t m = magnitude2(k);
+        if (m > picoMag) {
+            picoMag = m;
+            q->pico = k;
+        }
+    }
+
+    q->ciclos = ciclosDesde(inicio);
+    if (q->ciclos > ciclosMax) {
+        ciclosMax = q->ciclos;
+    }
+}
+
+bool espectroAlimentar(const uint16_t *amostras, size_t n, EspectroQuadro *q) {
+    bool pronto = false;
+    while (n > 0) {
+        if (espera > 0) {
+            size_t pular = n < espera ? n : espera;
+            espera -= pular;
+            amostras += pular;
+            n -= pular;
+            continue;
+        }
+        size_t copiar = ESPECTRO_PONTOS - preenchidas;
+        if (copiar > n) {
+            copiar = n;
+        }
+        memcpy(&entrada[preenchidas], amostras, copiar * sizeof(uint16_t));
+        preenchidas += copiar;
+        amostras += copiar;
+        n -= copiar;
+        if (preenchidas == ESPECTRO_PONTOS) {
+            espectroCalcular(entrada, q);
+            pronto = true;
+            preenchidas = 0;
+            espera = intervalo - ESPECTRO_PONTOS;
+        }
+    }
+    return pronto;
+}
+
+void espectroBin(uint16_t k, int16_t *r, int16_t *i, uint8_t *e) {
+    *r = re[k];
+    *i = im[k];
+    *e = expoente;
+}
+
+uint32_t espectroFrequencia(uint16_t bin) {
+    return (uint32_t)((uint64_t)bin * taxaEntrada / ESPECTRO_PONTOS);
+}
+
+uint16_t espectroPrimeiroBinBarra(uint8_t barra) {
+    return inicioBarra[barra];
+}
+
+uint32_t espectroCiclosMax() {
+    return ciclosMax;
+}
@@ -0,0 +1,56 @@
+#ifndef ESPECTRO_H
+#define ESPECTRO_H
+
+#include "plataforma.h"
+
+// Analisador de espectro sobre as amostras brutas do ADC: FFT radix-2 em
+// ponto fixo (Q15, decimação no tempo, no lugar) com janela de Hann.
+//
+// Para não estourar os 16 bits, cada estágio verifica o maior valor do
+// estágio anterior e, se um butterfly puder passar de 32767, divide o estágio
+// por 2 ou 4 (ponto flutuante em bloco); o expoente acumulado volta na magnitude.
+// Tabelas de janela, fatores de giro, inversão de bits e logaritmo são
+// calculadas em espectroInit(); cada transformada só usa somas, multiplicações
+// de 32 bits e deslocamentos.
+//
+// O resultado vai em escala logarítmica nas duas direções: ESPECTRO_BARRAS
+// barras para o OLED e ESPECTRO_BANDAS bandas para a matriz, com frequências
+// espaçadas em progressão geométrica do bin 1 até Nyquist, e níveis de 0 a 255
+// cobrindo ESPECTRO_FAIXA_DB decibéis abaixo do fundo de escala do ADC (uma
+// senoide de 0 a 4095). Cada barra mostra o bin mais forte da sua faixa.
+
+#define ESPECTRO_LOG2_PONTOS 8                  // 8: 256 pontos, 9: 512 pontos
+#define ESPECTRO_PONTOS (1 << ESPECTRO_LOG2_PONTOS)
+#define ESPECTRO_BARRAS 32                      // 4 colunas do OLED por barra
+#define ESPECTRO_BANDAS 5                       // Colunas da matriz
+#define ESPECTRO_FAIXA_DB 60
+
+typedef struct {
+    uint8_t barras[ESPECTRO_BARRAS];  // 0 = -ESPECTRO_FAIXA_DB ou menos, 255 = fundo de escala
+    uint8_t bandas[ESPECTRO_BANDAS];
+    uint16_t pico;                    // Bin mais forte (1 a ESPECTRO_PONTOS/2 - 1)
+    uint32_t ciclos;                  // Custo da transformada: janela, FFT e níveis (ver ciclos.h)
+} EspectroQuadro;
+
+// 'taxa' é a taxa das amostras entregues a espectroAlimentar(); 'porSegundo' é
+// quantos espectros calcular por segundo (cada um usa ESPECTRO_PONTOS amostras
+// seguidas, as demais são ignoradas). Falha se a taxa não comportar o pedido.
+bool espectroInit(uint32_t taxa, uint32_t porSegundo);
+
+// Consome amostras de 12 bits. Retorna true quando um espectro ficou pronto em 'q'.
+bool espectroAlimentar(const uint16_t *amostras, size_t n, EspectroQuadro *q);
+
+// Transformada imediata de ESPECTRO_PONTOS amostras (usada por espectroAlimentar)
+void espectroCalcular(const uint16_t *amostras, EspectroQuadro *q);
+
+// Resultado complexo da última transformada: bin 'k' vale
+// (re + j*im) * 2^expoente, na escala de amostras centradas em Q15 (entrada << 3)
+void espectroBin(uint16_t k, int16_t *re, int16_t *im, uint8_t *expoente);
+
+// Frequência central do bin, em Hz, e faixa de bins de cada barra/banda
+uint32_t espectroFrequencia(uint16_t bin);
+uint16_t espectroPrimeiroBinBarra(uint8_t barra);
+
+uint32_t espectroCiclosMax();
+
+#endif
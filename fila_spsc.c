@@ -0,0 +1,108 @@
+#include <string.h>
+#include "fila_spsc.h"
+
+bool filaSpscInit(FilaSpsc *f, void *dados, volatile uint32_t *seq, uint32_t tamElemento, uint32_t capacidade,
+                  FilaPolitica politica) {
+    if (capacidade == 0 || (capacidade & (capacidade - 1)) != 0) {
+        return false;
+    }
+    if (politica == FILA_SOBRESCREVER && seq == NULL) {
+        return false;
+    }
+
+    f->dados = dados;
+    f->seq = seq;
+    f->tamElemento = tamElemento;
+    f->mascara = capacidade - 1;
+    f->politica = politica;
+    f->cabeca = 0;
+    f->cauda = 0;
+    f->descartados = 0;
+    f->sobrescritos = 0;
+    f->ocupacaoMax = 0;
+    if (seq) {
+        for (uint32_t i = 0; i < capacidade; i++) {
+            seq[i] = 0;
+        }
+    }
+    return true;
+}
+
+static inline uint8_t *posicao(const FilaSpsc *f, uint32_t indice) {
+    return f->dados + (indice & f->mascara) * f->tamElemento;
+}
+
+bool __not_in_flash_func(filaSpscPush)(FilaSpsc *f, const void *elemento) {
+    uint32_t cabeca = f->cabeca;
+    uint32_t ocupacao = cabeca - __atomic_load_n(&f->cauda, __ATOMIC_ACQUIRE);
+
+    if (f->politica == FILA_DESCARTAR) {
+        if (ocupacao > f->mascara) {
+            f->descartados++;
+            return false;
+        }
+        memcpy(posicao(f, cabeca), elemento, f->tamElemento);
+    } else {
+        // Número ímpar marca a posição como "em escrita" para o consumidor
+        volatile uint32_t *seq = &f->seq[cabeca & f->mascara];
+        __atomic_store_n(seq, 2 * cabeca + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(posicao(f, cabeca), elemento, f->tamElemento);
+        __atomic_store_n(seq, 2 * cabeca + 2, __ATOMIC_RELEASE);
+        if (ocupacao > f->mascara) {
+            ocupacao = f->mascara;
+        }
+    }
+
+    __atomic_store_n(&f->cabeca, cabeca + 1, __ATOMIC_RELEASE);
+    if (ocupacao + 1 > f->ocupacaoMax) {
+        f->ocupacaoMax = ocupacao + 1;
+    }
+    return true;
+}
+
+bool __not_in_flash_func(filaSpscPop)(FilaSpsc *f, void *elemento) {
+    uint32_t cauda = f->cauda;
+
+    if (f->politica == FILA_DESCARTAR) {
+        if (cauda == __atomic_load_n(&f->cabeca, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        memcpy(elemento, posicao(f, cauda), f->tamElemento);
+        __atomic_store_n(&f->cauda, cauda + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    uint32_t capacidade = f->mascara + 1;
+    while (true) {
+        uint32_t cabeca = __atomic_load_n(&f->cabeca, __ATOMIC_ACQUIRE);
+        if (cauda == cabeca) {
+            __atomic_store_n(&f->cauda, cauda, __ATOMIC_RELEASE);
+            return false;
+        }
+        // O produtor deu a volta: pula direto para o mais antigo que ainda existe
+        if (cabeca - cauda > capacidade) {
+            f->sobrescritos += cabeca - capacidade - cauda;
+            cauda = cabeca - capacidade;
+        }
+
+        volatile uint32_t *seq = &f->seq[cauda & f->mascara];
+        uint32_t antes = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if (antes == 2 * cauda + 2) {
+            memcpy(elemento, posicao(f, cauda), f->tamElemento);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(seq, __ATOMIC_RELAXED) == antes) {
+                __atomic_store_n(&f->cauda, cauda + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+        // A posição foi reescrita durante a leitura: o elemento se perdeu
+        f->sobrescritos++;
+        cauda++;
+    }
+}
+
+uint32_t filaSpscOcupacao(const FilaSpsc *f) {
+    uint32_t ocupacao = __atomic_load_n(&f->cabeca, __ATOMIC_ACQUIRE) - __atomic_load_n(&f->cauda, __ATOMIC_ACQUIRE);
+    return ocupacao > f->mascara + 1 ? f->mascara + 1 : ocupacao;
+}
@@ -0,0 +1,52 @@
+#ifndef FILA_SPSC_H
+#define FILA_SPSC_H
+
+#include "plataforma.h"
+
+// Fila circular sem trava para um produtor e um consumidor (por exemplo, um
+// núcleo produzindo e o outro consumindo, ou um ISR e o laço principal).
+// Elementos de tamanho fixo, copiados para dentro e para fora da fila.
+//
+// Quando a fila está cheia há duas políticas:
+//  - FILA_DESCARTAR: o elemento novo é descartado (conta em 'descartados');
+//  - FILA_SOBRESCREVER: o mais antigo é sobrescrito (conta em 'sobrescritos').
+//    Cada posição tem um número de sequência (como um seqlock), que permite ao
+//    consumidor detectar que a posição que estava lendo foi reescrita.
+
+typedef enum {
+    FILA_DESCARTAR,
+    FILA_SOBRESCREVER
+} FilaPolitica;
+
+typedef struct {
+    uint8_t *dados;
+    volatile uint32_t *seq;       // Só usado em FILA_SOBRESCREVER
+    uint32_t tamElemento;
+    uint32_t mascara;             // capacidade - 1
+    FilaPolitica politica;
+    volatile uint32_t cabeca;     // Escrita só pelo produtor
+    volatile uint32_t cauda;      // Escrita só pelo consumidor
+    volatile uint32_t descartados;  // Atualizado pelo produtor
+    volatile uint32_t sobrescritos; // Atualizado pelo consumidor
+    volatile uint32_t ocupacaoMax;  // Atualizado pelo produtor
+} FilaSpsc;
+
+// Declara o armazenamento estático de uma fila de 'cap' elementos do tipo 'tipo'
+#define FILA_SPSC_ARMAZENAMENTO(nome, tipo, cap) \
+    static tipo nome##Dados[cap];                \
+    static volatile uint32_t nome##Seq[cap]
+
+// 'capacidade' deve ser potência de 2. 'seq' precisa de 'capacidade' posições
+// em FILA_SOBRESCREVER e pode ser NULL em FILA_DESCARTAR.
+bool filaSpscInit(FilaSpsc *f, void *dados, volatile uint32_t *seq, uint32_t tamElemento, uint32_t capacidade,
+                  FilaPolitica politica);
+
+// Lado do produtor. Retorna false se o elemento foi descartado.
+bool filaSpscPush(FilaSpsc *f, const void *elemento);
+
+// Lado do consumidor. Retorna false se a fila está vazia.
+bool filaSpscPop(FilaSpsc *f, void *elemento);
+
+uint32_t filaSpscOcupacao(const FilaSpsc *f);
+
+#endif
@@ -0,0 +1,205 @@
+#include <string.h>
+#include "gatilho.h"
+#include "ciclos.h"
+
+#define GATILHO_MASCARA (GATILHO_AMOSTRAS - 1)
+
+typedef enum {
+    ESTADO_ARMADO,    // Guardando amostras e procurando o disparo
+    ESTADO_DISPARADO, // Guardando só o que falta depois do disparo
+    ESTADO_CONGELADO  // Rajada pronta; espera gatilhoLiberar()
+} Estado;
+
+static uint16_t anel[GATILHO_AMOSTRAS]; // Amostra de índice absoluto 'a' fica em anel[a & máscara]
+static GatilhoConfig config;
+
+// Estado do núcleo 1. Índices de amostra são absolutos desde o init e
+// comparados pela diferença, então podem dar a volta nos 32 bits.
+static Estado estado;
+static uint16_t base, largura;           // Dispara na primeira amostra fora de [base, base + largura]
+static uint16_t basePreparo, larguraPreparo; // BORDA: o sinal precisa sair desta faixa antes
+static bool preparado;
+static uint32_t total;     // Amostras recebidas
+static uint32_t liberacao; // Primeira amostra que pode disparar (pré-disparo cheio e holdoff cumprido)
+static uint32_t disparo;
+static uint32_t fim;       // Amostra seguinte à última da rajada
+static uint64_t instante;
+static GatilhoStats stats;
+
+// Posto pelo núcleo 1 depois de a rajada estar completa, tirado pelo núcleo 0
+static volatile bool congelado;
+
+// x >= nivel: fora de [0, nivel - 1]
+static void faixaAcima(uint16_t nivel, uint16_t *b, uint16_t *l) {
+    *b = 0;
+    *l = nivel - 1;
+}
+
+// x <= nivel: fora de [nivel + 1, 0xFFFF] (a subtração dá a volta abaixo de nivel + 1)
+static void faixaAbaixo(uint16_t nivel, uint16_t *b, uint16_t *l) {
+    *b = nivel + 1;
+    *l = 0xFFFE - nivel;
+}
+
+static void armar() {
+    estado = ESTADO_ARMADO;
+    preparado = false;
+    liberacao = total + config.preDisparo;
+    if (stats.disparos > 0 && (int32_t)(disparo + config.holdoff - liberacao) > 0) {
+        liberacao = disparo + config.holdoff;
+    }
+}
+
+bool gatilhoInit(const GatilhoConfig *c) {
+    if (c->preDisparo >= GATILHO_AMOSTRAS || c->taxa == 0) {
+        return false;
+    }
+    if (c->tipo == GATILHO_JANELA) {
+        if (c->baixo > c->alto) {
+            return false;
+        }
+        base = c->baixo;
+        largura = c->alto - c->baixo;
+    } else {
+        if (c->nivel == 0 || c->nivel >= 4095) {
+            return false;
+        }
+        if (c->subida) {
+            faixaAcima(c->nivel, &base, &largura);
+        } else {
+            faixaAbaixo(c->nivel, &base, &largura);
+        }
+        if (c->tipo == GATILHO_BORDA) { // Antes de subir até o nível, precisa ter estado 'histerese' abaixo dele
+            if (c->subida ? c->histerese > c->nivel : c->nivel + c->histerese > 4095) {
+                return false;
+            }
+            if (c->subida) {
+                faixaAbaixo(c->nivel - c->histerese, &basePreparo, &larguraPreparo);
+            } else {
+                faixaAcima(c->nivel + c->histerese, &basePreparo, &larguraPreparo);
+            }
+        }
+    }
+
+    config = *c;
+    total = 0;
+    disparo = 0;
+    memset(&stats, 0, sizeof(stats));
+    __atomic_store_n(&congelado, false, __ATOMIC_RELEASE);
+    armar();
+    return true;
+}
+
+// Laço quente: uma subtração e uma comparação sem sinal por amostra
+static size_t __not_in_flash_func(procurar)(const uint16_t *p, size_t n, uint16_t b, uint16_t l) {
+    for (size_t k = 0; k < n; k++) {
+        if ((uint16_t)(p[k] - b) > l) {
+            return k;
+        }
+    }
+    return n;
+}
+
+static size_t __not_in_flash_func(procurarDisparo)(const uint16_t *p, size_t n, size_t k) {
+    if (config.tipo == GATILHO_BORDA && !preparado) {
+        k += procurar(p + k, n - k, basePreparo, larguraPreparo);
+        if (k == n) {
+            return n;
+        }
+        preparado = true;
+    }
+    k += procurar(p + k, n - k, base, largura);
+    if (k < n) {
+        preparado = false;
+    }
+    return k;
+}
+
+bool __not_in_flash_func(gatilhoAlimentar)(const uint16_t *amostras, size_t n, uint64_t agora) {
+    if (estado == ESTADO_CONGELADO) {
+        if (__atomic_load_n(&congelado, __ATOMIC_ACQUIRE)) {
+            total += n; // O holdoff conta o tempo congelado
+            return false;
+        }
+        armar();
+    }
+    uint32_t inicio = ciclosAgora();
+
+    if (estado == ESTADO_ARMADO) {
+        int32_t espera = (int32_t)(liberacao - total);
+        size_t k = espera <= 0 ? 0 : (size_t)espera;
+        if (k < n) {
+            k = procurarDisparo(amostras, n, k);
+        }
+        if (k < n) {
+            estado = ESTADO_DISPARADO;
+            disparo = total + k;
+            fim = disparo + GATILHO_AMOSTRAS - config.preDisparo;
+            instante = agora - (uint64_t)(n - 1 - k) * 1000000 / config.taxa;
+            stats.disparos++;
+        }
+    }
+
+    // Depois do disparo só entra o que falta para a rajada: o resto do bloco
+    // sobrescreveria o começo dela no anel
+    size_t guardar = n;
+    if (estado == ESTADO_DISPARADO && fim - total < n) {
+        guardar = fim - total;
+    }
+    uint32_t pos = total & GATILHO_MASCARA;
+    size_t ate = GATILHO_AMOSTRAS - pos < guardar ? GATILHO_AMOSTRAS - pos : guardar;
+    memcpy(&anel[pos], amostras, ate * sizeof(uint16_t));
+    memcpy(anel, amostras + ate, (guardar - ate) * sizeof(uint16_t));
+    total += n;
+
+    bool congelou = false;
+    if (estado == ESTADO_DISPARADO && (int32_t)(total - fim) >= 0) {
+        estado = ESTADO_CONGELADO;
+        __atomic_store_n(&congelado, true, __ATOMIC_RELEASE);
+        congelou = true;
+    }
+
+    stats.ciclosUltimo = ciclosDesde(inicio);
+    stats.amostrasUltimo = n;
+    if (stats.ciclosUltimo > stats.ciclosMax) {
+        stats.ciclosMax = stats.ciclosUltimo;
+    }
+    return congelou;
+}
+
+bool gatilhoCongelado() {
+    return __atomic_load_n(&congelado, __ATOMIC_ACQUIRE);
+}
+
+void gatilhoLiberar() {
+    __atomic_store_n(&congelado, false, __ATOMIC_RELEASE);
+}
+
+uint16_t gatilhoAmostra(uint32_t i) {
+    return anel[(disparo - config.preDisparo + i) & GATILHO_MASCARA];
+}
+
+size_t gatilhoCopiar(uint32_t primeira, uint16_t *destino, size_t n) {
+    if (primeira >= GATILHO_AMOSTRAS) {
+        return 0;
+    }
+    if (n > GATILHO_AMOSTRAS - primeira) {
+        n = GATILHO_AMOSTRAS - primeira;
+    }
+    for (size_t i = 0; i < n; i++) {
+        destino[i] = gatilhoAmostra(primeira + i);
+    }
+    return n;
+}
+
+uint64_t gatilhoInstante() {
+    return instante;
+}
+
+const GatilhoConfig *gatilhoConfig() {
+    return &config;
+}
+
+void gatilhoGetStats(GatilhoStats *s) {
+    *s = stats;
+}
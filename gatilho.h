@@ -0,0 +1,70 @@
+#ifndef GATILHO_H
+#define GATILHO_H
+
+#include "plataforma.h"
+
+// Disparo de osciloscópio sobre as amostras do ADC, na taxa cheia da captura.
+// As amostras passam continuamente por um anel de GATILHO_AMOSTRAS; quando a
+// condição de disparo aparece, o anel ainda recebe as amostras que faltam
+// depois do disparo e então congela com a rajada inteira: preDisparo amostras
+// antes do disparo e o resto depois. Congelado, o anel não é mais escrito (a
+// captura e o resto do processamento seguem normalmente) até gatilhoLiberar().
+//
+// Todos os tipos se resumem a procurar a primeira amostra fora de uma faixa
+// [base, base + largura] com uma subtração e uma comparação sem sinal por
+// amostra, direto no bloco da captura; só as amostras guardadas são copiadas.
+//
+// gatilhoAlimentar() roda no núcleo 1; a consulta e a leitura da rajada
+// congelada, no núcleo 0.
+
+#define GATILHO_AMOSTRAS 8192 // Tamanho da rajada (potência de 2)
+
+typedef enum {
+    GATILHO_NIVEL,  // Amostra >= nivel (subida) ou <= nivel (descida)
+    GATILHO_BORDA,  // Cruzamento do nível depois de o sinal passar 'histerese' do outro lado
+    GATILHO_JANELA  // Amostra fora de [baixo, alto]
+} GatilhoTipo;
+
+typedef struct {
+    GatilhoTipo tipo;
+    bool subida;         // NIVEL e BORDA
+    uint16_t nivel;      // NIVEL e BORDA
+    uint16_t histerese;  // BORDA
+    uint16_t baixo;      // JANELA
+    uint16_t alto;
+    uint32_t preDisparo; // Amostras guardadas antes do disparo (< GATILHO_AMOSTRAS)
+    uint32_t holdoff;    // Amostras mínimas entre dois disparos
+    uint32_t taxa;       // Amostras por segundo, para o instante do disparo
+} GatilhoConfig;
+
+typedef struct {
+    uint32_t disparos;
+    uint32_t ciclosUltimo;   // Custo do último bloco (ver ciclos.h)
+    uint32_t amostrasUltimo; // Tamanho desse bloco
+    uint32_t ciclosMax;      // Pior bloco
+} GatilhoStats;
+
+// Configura e arma. Falha se a configuração for inválida.
+bool gatilhoInit(const GatilhoConfig *config);
+
+// Núcleo 1: um bloco de amostras de 12 bits; 'agora' é o instante (us) da
+// última amostra do bloco, de onde sai o instante do disparo (com o atraso de
+// entrega do bloco, se 'agora' for lido no processamento). Retorna true se a
+// rajada congelou neste bloco.
+bool gatilhoAlimentar(const uint16_t *amostras, size_t n, uint64_t agora);
+
+// Núcleo 0
+bool gatilhoCongelado();
+void gatilhoLiberar(); // Volta a armar (primeiro enche o pré-disparo de novo)
+
+// Rajada congelada: amostra 'i' (0 a GATILHO_AMOSTRAS - 1); o disparo é a
+// amostra preDisparo. gatilhoCopiar() copia até 'n' amostras a partir de
+// 'primeira' e retorna quantas copiou.
+uint16_t gatilhoAmostra(uint32_t i);
+size_t gatilhoCopiar(uint32_t primeira, uint16_t *destino, size_t n);
+uint64_t gatilhoInstante(); // us do disparo
+const GatilhoConfig *gatilhoConfig();
+
+void gatilhoGetStats(GatilhoStats *stats);
+
+#endif
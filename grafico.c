@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include "grafico.h"
+#include "ciclos.h"
+#include "ssd1306.h"
+#include "ssd1306_text.h"
+
+#define GRAFICO_ALTURA ((GRAFICO_PAGINA_FINAL - GRAFICO_PAGINA_INICIAL + 1) * 8)
+#define GRAFICO_Y_BASE ((GRAFICO_PAGINA_FINAL + 1) * 8) // Primeira linha abaixo do gráfico
+#define GRAFICO_X_ROTULO 5
+
+static uint16_t historico[GRAFICO_COLUNAS];
+static uint8_t cabeca = 0;       // Próxima posição a escrever (e a amostra mais antiga)
+static GraficoModo modoAtual;
+static uint8_t desdeResync = 0;  // Amostras desde o último envio completo (modo rolagem)
+static struct text_label rotulo; // "Campo: nnnn" na página 0; só os dígitos que mudam são redesenhados
+static uint32_t ciclosAmostra = 0;
+static uint32_t ciclosRedesenho = 0;
+
+void graficoInit(GraficoModo modo) {
+    modoAtual = modo;
+    cabeca = 0;
+    desdeResync = 0;
+    TextLabelInit(&rotulo, GRAFICO_X_ROTULO, 0);
+    for (int i = 0; i < GRAFICO_COLUNAS; i++) {
+        historico[i] = 0;
+    }
+}
+
+// Escreve a barra de 'valor' na coluna x, de baixo para cima. Cada página
+// recebe um byte pronto, sem passar pelo SetPixel.
+static void desenharColuna(uint8_t *buf, int x, uint16_t valor, bool vazia) {
+    int altura = vazia ? 0 : (valor * (GRAFICO_ALTURA + 1)) >> 12; // 0-4095 -> 0-24
+    for (int pagina = GRAFICO_PAGINA_INICIAL; pagina <= GRAFICO_PAGINA_FINAL; pagina++) {
+        int primeiro = GRAFICO_Y_BASE - altura - pagina * 8; // Primeiro bit aceso dentro da página
+        uint8_t byte;
+        if (primeiro <= 0) {
+            byte = 0xFF;
+        } else if (primeiro >= 8) {
+            byte = 0;
+        } else {
+            byte = (uint8_t)(0xFF << primeiro);
+        }
+        buf[pagina * SSD1306_WIDTH + x] = byte;
+    }
+}
+
+static void escreverRotulo(uint8_t *buf, uint16_t valor) {
+    char texto[16];
+    snprintf(texto, sizeof(texto), "Campo: %4u", (unsigned)valor);
+    DrawLabel(buf, &rotulo, texto);
+}
+
+void graficoAdicionar(uint16_t valor, bool visivel) {
+    uint8_t x = cabeca;
+    historico[cabeca] = valor;
+    cabeca = (cabeca + 1) & (GRAFICO_COLUNAS - 1);
+    if (!visivel) {
+        return;
+    }
+
+    uint32_t inicio = ciclosAgora();
+    uint8_t *buf = SSD1306_framebuffer();
+
+    if (modoAtual == GRAFICO_ROLAGEM) {
+        // O controlador desloca a própria RAM; só falta a coluna que entra
+        SSD1306_scroll_one_column(true, GRAFICO_PAGINA_INICIAL, GRAFICO_PAGINA_FINAL);
+        desenharColuna(buf, GRAFICO_COLUNAS - 1, valor, false);
+        if (++desdeResync == GRAFICO_COLUNAS) {
+            // Uma volta completa: reenvia o gráfico para corrigir qualquer
+            // diferença acumulada entre a tela e o framebuffer
+            desdeResync = 0;
+            SSD1306_mark_dirty(0, GRAFICO_COLUNAS - 1, GRAFICO_PAGINA_INICIAL, GRAFICO_PAGINA_FINAL);
+        } else {
+            SSD1306_mark_dirty(GRAFICO_COLUNAS - 1, GRAFICO_COLUNAS - 1, GRAFICO_PAGINA_INICIAL,
+                               GRAFICO_PAGINA_FINAL);
+        }
+    } else {
+        // Coluna nova e, à frente dela, uma coluna vazia que marca o cursor.
+        // Na última coluna o vão ficaria na coluna 0 e é omitido, para que a
+        // faixa enviada continue sendo uma só.
+        desenharColuna(buf, x, valor, false);
+        int fim = x;
+        if (x + 1 < GRAFICO_COLUNAS) {
+            desenharColuna(buf, x + 1, 0, true);
+            fim = x + 1;
+        }
+        SSD1306_mark_dirty(x, fim, GRAFICO_PAGINA_INICIAL, GRAFICO_PAGINA_FINAL);
+    }
+    escreverRotulo(buf, valor);
+    ciclosAmostra = ciclosDesde(inicio);
+
+    SSD1306_update();
+}
+
+void graficoDesenhar() {
+    uint32_t inicio = ciclosAgora();
+    uint8_t *buf = SSD1306_framebuffer();
+
+    for (int x = 0; x < GRAFICO_COLUNAS; x++) {
+        if (modoAtual == GRAFICO_ROLAGEM) {
+            // Mais antiga à esquerda, mais recente na coluna 127
+            desenharColuna(buf, x, historico[(cabeca + x) & (GRAFICO_COLUNAS - 1)], false);
+        } else {
+            desenharColuna(buf, x, historico[x], x == cabeca);
+        }
+    }
+    desdeResync = 0;
+    SSD1306_mark_dirty(0, GRAFICO_COLUNAS - 1, GRAFICO_PAGINA_INICIAL, GRAFICO_PAGINA_FINAL);
+
+    // Página 0: rótulo fixo mais o valor mais recente
+    for (int i = 0; i < SSD1306_WIDTH; i++) {
+        buf[i] = 0;
+    }
+    SSD1306_mark_dirty(0, SSD1306_WIDTH - 1, 0, 0);
+    TextLabelInvalidate(&rotulo);
+    escreverRotulo(buf, historico[(cabeca - 1) & (GRAFICO_COLUNAS - 1)]);
+    ciclosRedesenho = ciclosDesde(inicio);
+
+    SSD1306_update();
+}
+
+uint32_t graficoCiclosAmostra() {
+    return ciclosAmostra;
+}
+
+uint32_t graficoCiclosRedesenho() {
+    return ciclosRedesenho;
+}
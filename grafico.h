@@ -0,0 +1,34 @@
+#ifndef GRAFICO_H
+#define GRAFICO_H
+
+#include "plataforma.h"
+
+// Gráfico do histórico da intensidade do campo no OLED (páginas 1 a 3,
+// 24 pixels de altura) com o valor atual na página 0. Os últimos 128 valores
+// ficam num buffer circular; cada amostra nova desenha uma coluna no
+// framebuffer e só essa faixa estreita vai para o barramento.
+
+#define GRAFICO_COLUNAS 128
+#define GRAFICO_PAGINA_INICIAL 1
+#define GRAFICO_PAGINA_FINAL 3
+
+typedef enum {
+    GRAFICO_VARREDURA, // Cursor percorre a tela sobrescrevendo a coluna mais antiga
+    GRAFICO_ROLAGEM    // Rolagem de uma coluna feita pelo próprio controlador (2Ch/2Dh)
+} GraficoModo;
+
+void graficoInit(GraficoModo modo);
+
+// Guarda 'valor' (0-4095). Com 'visivel', desenha também a coluna nova e
+// chama SSD1306_update().
+void graficoAdicionar(uint16_t valor, bool visivel);
+
+// Redesenha o gráfico inteiro a partir do histórico (ao entrar na tela)
+void graficoDesenhar();
+
+// Custo medido do último desenho de uma amostra e do último redesenho
+// completo, em ciclos (ver ciclos.h)
+uint32_t graficoCiclosAmostra();
+uint32_t graficoCiclosRedesenho();
+
+#endif
@@ -0,0 +1,115 @@
+#include <math.h>
+#include <string.h>
+#include "matriz_led.h"
+
+#define MATRIZ_NUM_GRUPOS MATRIZ_LADO
+#define MATRIZ_GAMA 2.2
+
+typedef struct {
+    uint8_t grupos;     // Linhas/colunas totalmente acesas
+    uint16_t parcial;   // Brilho do grupo seguinte, com MATRIZ_BITS_DITHER bits de fração
+} MatrizNivel;
+
+static uint8_t indiceFisico[MATRIZ_LADO][MATRIZ_LADO]; // [y][x]
+static uint8_t ordem[2][LED_COUNT];                     // Ordem de preenchimento de cada padrão
+static MatrizNivel niveis[MATRIZ_NIVEIS];
+static uint32_t corCheia;
+static uint8_t brilhoCheio;
+static uint32_t quadroN;
+
+// Limiar do dithering ordenado: em 16 quadros seguidos cada fração acende o
+// LED no passo de cima exatamente 'fração' vezes, bem espalhadas no tempo
+static const uint8_t limiarDither[1 << MATRIZ_BITS_DITHER] = {
+    0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15
+};
+
+uint8_t matrizIndice(uint8_t x, uint8_t y) {
+    return indiceFisico[y][x];
+}
+
+void matrizInit(uint8_t brilhoMaximo, uint16_t escalaMaxima) {
+    // Serpentina da BitDogLab: o LED 0 fica no canto inferior direito e o
+    // sentido das linhas alterna a cada linha
+    for (uint8_t y = 0; y < MATRIZ_LADO; y++) {
+        uint8_t linha = MATRIZ_LADO - 1 - y; // Linha contada de cima para baixo
+        for (uint8_t x = 0; x < MATRIZ_LADO; x++) {
+            uint8_t coluna = (linha % 2 == 0) ? x : MATRIZ_LADO - 1 - x;
+            indiceFisico[y][x] = LED_COUNT - 1 - (linha * MATRIZ_LADO + coluna);
+        }
+    }
+    for (uint8_t i = 0; i < MATRIZ_LADO; i++) {
+        for (uint8_t j = 0; j < MATRIZ_LADO; j++) {
+            ordem[MATRIZ_BARRA][i * MATRIZ_LADO + j] = indiceFisico[i][j];
+            ordem[MATRIZ_MEDIDOR][i * MATRIZ_LADO + j] = indiceFisico[j][i];
+        }
+    }
+
+    brilhoCheio = brilhoMaximo;
+    corCheia = npCor(brilhoMaximo, 0, 0);
+
+    // Posição na barra em 1/256 de grupo; a fração vira brilho pela curva de gama
+    for (uint32_t n = 0; n < MATRIZ_NIVEIS; n++) {
+        uint32_t val = n ? (n << 4) + 8 : 0; // Centro da faixa de 16 valores que cai em 'n'
+        if (val > escalaMaxima) val = escalaMaxima;
+        uint32_t posicao = val * MATRIZ_NUM_GRUPOS * 256 / escalaMaxima;
+        uint32_t fracao = posicao & 0xFF;
+
+        niveis[n].grupos = posicao >> 8;
+        niveis[n].parcial = (uint16_t)lround(pow(fracao / 256.0, MATRIZ_GAMA) * (brilhoMaximo << MATRIZ_BITS_DITHER));
+    }
+}
+
+// Quadro igual ao último: não há o que enviar
+static bool enviarSeMudou(const NpQuadro *novo) {
+    NpQuadro *tras = npQuadroTras();
+    if (memcmp(novo, tras, sizeof(NpQuadro)) == 0) {
+        return false;
+    }
+    *tras = *novo;
+    return npWrite();
+}
+
+bool matrizRenderizar(uint16_t val, MatrizPadrao padrao) {
+    if (!npQuadroConcluido()) {
+        return false;
+    }
+
+    const MatrizNivel *nivel = &niveis[val >> 4];
+    const uint8_t *o = ordem[padrao];
+    uint32_t fase = quadroN++;
+    NpQuadro novo;
+    uint32_t i = 0;
+
+    for (uint32_t cheios = nivel->grupos * MATRIZ_LADO; i < cheios; i++) {
+        novo.grb[o[i]] = corCheia;
+    }
+    if (nivel->grupos < MATRIZ_NUM_GRUPOS) {
+        // Fase diferente por LED para que o grupo não pisque em uníssono
+        for (uint32_t k = 0; k < MATRIZ_LADO; k++, i++) {
+            uint32_t limiar = limiarDither[(fase + k * 5) & ((1 << MATRIZ_BITS_DITHER) - 1)];
+            uint8_t brilho = (nivel->parcial + limiar) >> MATRIZ_BITS_DITHER;
+            novo.grb[o[i]] = npCor(brilho, 0, 0);
+        }
+    }
+    for (; i < LED_COUNT; i++) {
+        novo.grb[o[i]] = 0;
+    }
+
+    return enviarSeMudou(&novo);
+}
+
+bool matrizRenderizarColunas(const uint8_t *alturas) {
+    if (!npQuadroConcluido()) {
+        return false;
+    }
+
+    NpQuadro novo;
+    for (uint8_t x = 0; x < MATRIZ_LADO; x++) {
+        uint32_t posicao = alturas[x] * MATRIZ_LADO; // Em 1/255 de LED
+        for (uint8_t y = 0; y < MATRIZ_LADO; y++, posicao = posicao > 255 ? posicao - 255 : 0) {
+            uint8_t brilho = posicao >= 255 ? brilhoCheio : (uint8_t)(posicao * brilhoCheio / 255);
+            novo.grb[indiceFisico[y][x]] = npCor(brilho, 0, 0);
+        }
+    }
+    return enviarSeMudou(&novo);
+}
@@ -0,0 +1,39 @@
+#ifndef MATRIZ_LED_H
+#define MATRIZ_LED_H
+
+#include "plataforma.h"
+#include "neopixel.h"
+
+// Renderizador da matriz 5x5 orientado a tabelas. Tudo que envolve divisão
+// (escala do ADC, gama, brilho máximo) é calculado em matrizInit(); cada quadro
+// custa algumas consultas de tabela e a escrita das 25 palavras GRB.
+//
+// Coordenadas lógicas: x da esquerda para a direita, y de baixo para cima.
+// A tradução para o índice físico segue a ligação em serpentina da BitDogLab.
+
+#define MATRIZ_LADO 5
+#define MATRIZ_NIVEIS 256  // Resolução da tabela de níveis (val >> 4)
+#define MATRIZ_BITS_DITHER 4 // Frações de brilho por passo, espalhadas em 16 quadros
+
+typedef enum {
+    MATRIZ_BARRA,   // Linhas acendendo de baixo para cima
+    MATRIZ_MEDIDOR  // Colunas acendendo da esquerda para a direita
+} MatrizPadrao;
+
+// 'escalaMaxima' é o valor de 'val' que acende a matriz inteira
+void matrizInit(uint8_t brilhoMaximo, uint16_t escalaMaxima);
+
+// Desenha o nível 'val' (0-4095) e envia o quadro se ele mudou. Retorna true
+// se um quadro foi enviado. Não faz nada enquanto o quadro anterior estiver
+// no fio, então pode ser chamada a cada volta do laço.
+bool matrizRenderizar(uint16_t val, MatrizPadrao padrao);
+
+// Colunas independentes (analisador de espectro): 'alturas' tem MATRIZ_LADO
+// níveis de 0 a 255, cada um acendendo a sua coluna de baixo para cima, com o
+// LED do topo em brilho parcial. Mesmo comportamento de envio de matrizRenderizar().
+bool matrizRenderizarColunas(const uint8_t *alturas);
+
+// Índice físico do LED na posição lógica (x, y)
+uint8_t matrizIndice(uint8_t x, uint8_t y);
+
+#endif
@@ -0,0 +1,128 @@
+#include <string.h>
+#include "neopixel.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "ws2818b.pio.h"
+#endif
+
+static NpQuadro quadros[2];
+static int tras = 0; // Índice do quadro de desenho; o outro é o da frente
+
+void npSetLED(const unsigned int index, const uint8_t r, const uint8_t g, const uint8_t b) {
+    quadros[tras].grb[index] = npCor(r, g, b);
+}
+
+void npClear() {
+    memset(&quadros[tras], 0, sizeof(NpQuadro));
+}
+
+NpQuadro *npQuadroTras() {
+    return &quadros[tras];
+}
+
+const NpQuadro *npQuadroFrente() {
+    return &quadros[tras ^ 1];
+}
+
+// Troca os quadros e mantém no de trás o conteúdo atual, para que quem
+// desenha de forma incremental continue a partir do último quadro
+static void trocarQuadros() {
+    tras ^= 1;
+    quadros[tras] = quadros[tras ^ 1];
+}
+
+#if PICO_ON_DEVICE
+
+// Variáveis para uso do PIO
+static PIO np_pio;
+static uint sm;
+static int canalDma;
+
+static volatile bool enviando = false;
+static volatile uint64_t fimDma = 0;
+
+static void __not_in_flash_func(npIrq)() {
+    if (dma_hw->ints0 & (1u << canalDma)) {
+        dma_hw->ints0 = 1u << canalDma;
+        fimDma = time_us_64();
+        enviando = false;
+    }
+}
+
+void npInit(uint pin) {
+
+    // Cria programa PIO
+    np_pio = pio0;
+    uint offset = pio_add_program(np_pio, &ws2818b_program);
+
+    // Toma posse de uma máquina PIO
+    int smLivre = pio_claim_unused_sm(np_pio, false);
+    if (smLivre < 0) {
+      np_pio = pio1;
+      offset = pio_add_program(np_pio, &ws2818b_program);
+      smLivre = pio_claim_unused_sm(np_pio, true);
+    }
+    sm = smLivre;
+
+    // Inicia programa na máquina PIO obtida
+    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+
+    // DMA de palavras de 32 bits do quadro da frente para o FIFO da máquina
+    canalDma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(canalDma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(np_pio, sm, true));
+    dma_channel_configure(canalDma, &c, &np_pio->txf[sm], NULL, LED_COUNT, false);
+    dma_channel_set_irq0_enabled(canalDma, true);
+    irq_add_shared_handler(DMA_IRQ_0, npIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    // Limpa buffer de pixels
+    memset(quadros, 0, sizeof(quadros));
+}
+
+void npAjustarRelogio(uint16_t divInt, uint8_t divFrac) {
+    pio_sm_set_clkdiv_int_frac(np_pio, sm, divInt, divFrac);
+}
+
+bool npQuadroConcluido() {
+    return !enviando && time_us_64() - fimDma >= NP_DRENO_US + NP_RESET_US;
+}
+
+bool npWrite() {
+    if (!npQuadroConcluido()) {
+        return false;
+    }
+    trocarQuadros();
+    enviando = true;
+    dma_channel_transfer_from_buffer_now(canalDma, quadros[tras ^ 1].grb, LED_COUNT);
+    return true;
+}
+
+#else
+
+void npInit(unsigned int pin) {
+    (void)pin;
+    memset(quadros, 0, sizeof(quadros));
+}
+
+void npAjustarRelogio(uint16_t divInt, uint8_t divFrac) {
+    (void)divInt;
+    (void)divFrac;
+}
+
+bool npQuadroConcluido() {
+    return true;
+}
+
+bool npWrite() {
+    trocarQuadros();
+    return true;
+}
+
+#endif
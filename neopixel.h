@@ -0,0 +1,48 @@
+#ifndef NEOPIXEL_H
+#define NEOPIXEL_H
+
+#include "plataforma.h"
+
+#define LED_COUNT 25 // Número de LEDs na matriz
+
+// Tempo de fio de um LED (24 bits a 800 kHz)
+#define NP_US_POR_LED 30
+// Depois que o DMA termina ainda há até 8 palavras no FIFO (TX juntado) e 1 no OSR
+#define NP_DRENO_US (9 * NP_US_POR_LED)
+// Linha em nível baixo para os LEDs travarem o quadro (WS2812B recentes pedem >= 280 us)
+#define NP_RESET_US 300
+
+// Um quadro guarda cada LED como uma palavra de 32 bits já no formato que a
+// máquina PIO consome: GRB nos 24 bits de cima, o bit mais significativo
+// saindo primeiro (deslocamento para a esquerda, autopull em 24 bits).
+typedef struct {
+    uint32_t grb[LED_COUNT];
+} NpQuadro;
+
+static inline uint32_t npCor(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)g << 24) | ((uint32_t)r << 16) | ((uint32_t)b << 8);
+}
+
+void npInit(unsigned int pin);
+
+// Desenho no quadro de trás (o da frente pode estar sendo enviado pelo DMA)
+void npSetLED(const unsigned int index, const uint8_t r, const uint8_t g, const uint8_t b);
+void npClear();
+NpQuadro *npQuadroTras();
+
+// Envia o quadro de trás por DMA sem bloquear. Retorna false se o quadro
+// anterior ainda não terminou (fio + intervalo de reset); nesse caso nada muda
+// e basta chamar de novo depois.
+bool npWrite();
+
+// Reprograma o divisor da máquina PIO depois de uma troca do clk_sys (ver
+// relogio.h). Só deve ser chamada com npQuadroConcluido().
+void npAjustarRelogio(uint16_t divInt, uint8_t divFrac);
+
+// true quando o último quadro já saiu inteiro e o intervalo de reset passou
+bool npQuadroConcluido();
+
+// Quadro enviado por último (usado para conferir a codificação no host)
+const NpQuadro *npQuadroFrente();
+
+#endif
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include "partida.h"
+
+typedef struct {
+    uint64_t inicio;
+    uint64_t fim;
+} PartidaIntervalo;
+
+static const char *const nomesFases[PARTIDA_NUM_FASES] = {"ADC", "PIO", "I2C", "OLED", "REG", "USB"};
+static const char *const nomesMarcos[PARTIDA_NUM_MARCOS] = {"bloco", "leitura"};
+
+static PartidaIntervalo fases[PARTIDA_NUM_FASES];
+// Um marco é escrito por um núcleo e lido pelo outro. No M0+ um uint64_t é
+// escrito em duas metades, então o leitor só olha o valor depois de ver a
+// flag, publicada depois dele.
+static uint64_t marcos[PARTIDA_NUM_MARCOS];
+static bool marcados[PARTIDA_NUM_MARCOS];
+
+void partidaInicio(PartidaFase fase, uint64_t agora) {
+    fases[fase].inicio = agora;
+}
+
+void partidaFim(PartidaFase fase, uint64_t agora) {
+    fases[fase].fim = agora;
+}
+
+void partidaMarco(PartidaMarco marco, uint64_t agora) {
+    if (!__atomic_load_n(&marcados[marco], __ATOMIC_RELAXED)) {
+        marcos[marco] = agora;
+        __atomic_store_n(&marcados[marco], true, __ATOMIC_RELEASE);
+    }
+}
+
+static bool marcado(int marco) {
+    return __atomic_load_n(&marcados[marco], __ATOMIC_ACQUIRE);
+}
+
+bool partidaCompleta() {
+    for (int i = 0; i < PARTIDA_NUM_MARCOS; i++) {
+        if (!marcado(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void partidaRelatorio(PartidaSaida saida, void *ctx) {
+    char linha[64];
+    for (int i = 0; i < PARTIDA_NUM_FASES; i++) {
+        snprintf(linha, sizeof(linha), "BOOT %s %lu-%lu us (%lu)", nomesFases[i], (unsigned long)fases[i].inicio,
+                 (unsigned long)fases[i].fim, (unsigned long)(fases[i].fim - fases[i].inicio));
+        saida(linha, ctx);
+    }
+    for (int i = 0; i < PARTIDA_NUM_MARCOS; i++) {
+        if (marcado(i)) {
+            snprintf(linha, sizeof(linha), "BOOT %s %lu us", nomesMarcos[i], (unsigned long)marcos[i]);
+        } else {
+            snprintf(linha, sizeof(linha), "BOOT %s pendente", nomesMarcos[i]);
+        }
+        saida(linha, ctx);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef PARTIDA_H
+#define PARTIDA_H
+
+#include "plataforma.h"
+
+// Linha do tempo da partida: início e fim de cada fase da inicialização e o
+// instante dos primeiros dados, em microssegundos desde o reset (time_us_64,
+// que conta desde que o temporizador saiu do reset). As fases podem ser
+// marcadas pelos dois núcleos, cada uma por um só.
+
+typedef enum {
+    PARTIDA_ADC,      // Captura e processamento de sinal, antes do núcleo 1 partir
+    PARTIDA_PIO,      // Matriz de LEDs
+    PARTIDA_I2C,
+    PARTIDA_OLED,     // SSD1306_init() e primeira tela
+    PARTIDA_REGISTRO, // Varredura do registro na flash
+    PARTIDA_USB,      // stdio_init_all()
+    PARTIDA_NUM_FASES
+} PartidaFase;
+
+typedef enum {
+    PARTIDA_PRIMEIRO_BLOCO,   // Primeiro bloco do ADC processado no núcleo 1
+    PARTIDA_PRIMEIRA_LEITURA, // Primeira leitura no núcleo 0 (a provisória, antes de a janela do detector fechar)
+    PARTIDA_NUM_MARCOS
+} PartidaMarco;
+
+void partidaInicio(PartidaFase fase, uint64_t agora);
+void partidaFim(PartidaFase fase, uint64_t agora);
+
+// Só a primeira chamada de cada marco conta
+void partidaMarco(PartidaMarco marco, uint64_t agora);
+bool partidaCompleta();
+
+// Uma linha por fase e por marco, no formato "BOOT <nome> ..."
+typedef void (*PartidaSaida)(const char *linha, void *ctx);
+void partidaRelatorio(PartidaSaida saida, void *ctx);
+
+#endif
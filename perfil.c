@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include "perfil.h"
+
+#if PERFIL_HABILITADO
+
+#include "ssd1306.h"
+
+PerfilEtapa perfilEtapas[PERFIL_MAX_ETAPAS];
+static uint8_t numEtapas = 0;
+
+void perfilInit(const char *const *nomes, uint8_t n) {
+    numEtapas = n > PERFIL_MAX_ETAPAS ? PERFIL_MAX_ETAPAS : n;
+    for (uint8_t i = 0; i < numEtapas; i++) {
+        perfilEtapas[i].nome = nomes[i];
+    }
+    perfilZerar();
+}
+
+void perfilZerar() {
+    for (uint8_t i = 0; i < numEtapas; i++) {
+        PerfilEtapa *e = &perfilEtapas[i];
+        memset(e->faixas, 0, sizeof(e->faixas));
+        e->n = 0;
+        e->max = 0;
+        e->soma = 0;
+    }
+}
+
+uint8_t perfilNumEtapas() {
+    return numEtapas;
+}
+
+const PerfilEtapa *perfilEtapa(uint8_t i) {
+    return &perfilEtapas[i];
+}
+
+uint32_t perfilPercentil(const PerfilEtapa *e, uint8_t p) {
+    uint32_t alvo = ((uint64_t)e->n * p + 99) / 100;
+    uint32_t acumulado = 0;
+    for (int i = 0; i < PERFIL_FAIXAS - 1; i++) {
+        acumulado += e->faixas[i];
+        if (acumulado >= alvo) {
+            uint32_t limite = 1u << (i + PERFIL_FAIXA_MIN + 1);
+            return limite < e->max ? limite : e->max;
+        }
+    }
+    return e->max; // Última faixa não tem limite superior
+}
+
+void perfilDespejar(PerfilSaida saida, void *ctx) {
+    char linha[160];
+    for (uint8_t i = 0; i < numEtapas; i++) {
+        const PerfilEtapa *e = &perfilEtapas[i];
+        int pos = snprintf(linha, sizeof(linha), "PERF %s n=%lu med=%lu p50<=%lu p99<=%lu max=%lu |", e->nome,
+                           (unsigned long)e->n, (unsigned long)(e->n ? e->soma / e->n : 0),
+                           (unsigned long)perfilPercentil(e, 50), (unsigned long)perfilPercentil(e, 99),
+                           (unsigned long)e->max);
+        for (int f = 0; f < PERFIL_FAIXAS && pos < (int)sizeof(linha); f++) {
+            pos += snprintf(&linha[pos], sizeof(linha) - pos, " %lu", (unsigned long)e->faixas[f]);
+        }
+        saida(linha, ctx);
+    }
+}
+
+#define LARGURA_NOME 32 // Quatro caracteres de 8 pixels
+#define LARGURA_BARRA 6 // 16 faixas x 6 pixels completam os 96 restantes
+
+void perfilDesenhar(uint8_t *buf, uint8_t primeira) {
+    for (uint8_t pagina = 0; pagina < SSD1306_NUM_PAGES; pagina++) {
+        uint8_t *linha = &buf[pagina * SSD1306_WIDTH];
+        memset(linha, 0, SSD1306_WIDTH);
+        uint8_t i = primeira + pagina;
+        if (i >= numEtapas) {
+            continue;
+        }
+        const PerfilEtapa *e = &perfilEtapas[i];
+
+        char nome[5] = {0};
+        strncpy(nome, e->nome, 4);
+        WriteString(buf, 0, pagina * 8, nome);
+
+        uint32_t maior = 0;
+        for (int f = 0; f < PERFIL_FAIXAS; f++) {
+            if (e->faixas[f] > maior) {
+                maior = e->faixas[f];
+            }
+        }
+        // Barras de até 7 pixels, crescendo da base da página; faixa com
+        // alguma contagem tem pelo menos 1 pixel
+        for (int f = 0; f < PERFIL_FAIXAS && maior; f++) {
+            uint32_t c = e->faixas[f];
+            uint8_t altura = c ? 1 + (uint32_t)((uint64_t)c * 6 / maior) : 0;
+            uint8_t coluna = (uint8_t)(0xFF << (8 - altura));
+            memset(&linha[LARGURA_NOME + f * LARGURA_BARRA], coluna, LARGURA_BARRA - 1);
+        }
+    }
+    SSD1306_mark_dirty(0, SSD1306_WIDTH - 1, 0, SSD1306_NUM_PAGES - 1);
+}
+
+#endif
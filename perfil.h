@@ -0,0 +1,85 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include "plataforma.h"
+#include "ciclos.h"
+
+// Perfilador dos trechos quentes: cada etapa nomeada tem um histograma de
+// latência com faixas fixas em memória estática. A medida usa o contador de
+// ciclos (ciclos.h) e custa uma leitura do SysTick no início e, no fim, outra
+// leitura, um CLZ e três somas.
+//
+// Com PERFIL_HABILITADO em 0 as macros somem e nada do módulo é compilado.
+//
+// Cada etapa deve ser medida sempre pelo mesmo núcleo; a leitura do outro
+// núcleo (despejo, tela) pode ver um histograma no meio de uma atualização.
+
+#ifndef PERFIL_HABILITADO
+#define PERFIL_HABILITADO 0
+#endif
+
+#define PERFIL_MAX_ETAPAS 12
+#define PERFIL_FAIXAS 16
+#define PERFIL_FAIXA_MIN 4 // Faixa i: [2^(i+4), 2^(i+5)) ciclos; a primeira inclui tudo abaixo de 32
+
+typedef struct {
+    const char *nome;
+    uint32_t faixas[PERFIL_FAIXAS];
+    uint32_t n;
+    uint32_t max;
+    uint64_t soma;
+} PerfilEtapa;
+
+#if PERFIL_HABILITADO
+
+extern PerfilEtapa perfilEtapas[PERFIL_MAX_ETAPAS];
+
+// 'nomes' define as etapas, na ordem dos índices usados em PERFIL_MEDIR
+void perfilInit(const char *const *nomes, uint8_t n);
+void perfilZerar();
+
+static inline void perfilRegistrar(uint8_t etapa, uint32_t ciclos) {
+    PerfilEtapa *e = &perfilEtapas[etapa];
+    int faixa = 31 - __builtin_clz(ciclos | 1) - PERFIL_FAIXA_MIN;
+    faixa = faixa < 0 ? 0 : (faixa >= PERFIL_FAIXAS ? PERFIL_FAIXAS - 1 : faixa);
+    e->faixas[faixa]++;
+    e->n++;
+    e->soma += ciclos;
+    if (ciclos > e->max) {
+        e->max = ciclos;
+    }
+}
+
+// Mede o bloco que vem em seguida:
+//   PERFIL_MEDIR(ETAPA_MATRIZ) {
+//       ...
+//   }
+// Um return ou break de dentro do bloco sai sem registrar a medida.
+#define PERFIL_MEDIR(etapa)                                                                  \
+    for (uint32_t perfilInicio_ = ciclosAgora(), perfilUmaVez_ = 1; perfilUmaVez_;        \
+         perfilUmaVez_ = 0, perfilRegistrar((etapa), ciclosDesde(perfilInicio_)))
+
+uint8_t perfilNumEtapas();
+const PerfilEtapa *perfilEtapa(uint8_t i);
+
+// Limite superior da faixa que contém o percentil 'p' (0-100), em ciclos
+uint32_t perfilPercentil(const PerfilEtapa *e, uint8_t p);
+
+// Uma linha de texto por etapa ("nome n med p99 max | faixas..."), entregue a
+// 'saida'; a aplicação decide se vai pelo printf ou pela telemetria
+typedef void (*PerfilSaida)(const char *linha, void *ctx);
+void perfilDespejar(PerfilSaida saida, void *ctx);
+
+// Desenha até quatro etapas a partir de 'primeira' no framebuffer do OLED, uma
+// por página: o nome e o histograma em barras
+void perfilDesenhar(uint8_t *buf, uint8_t primeira);
+
+#else
+
+#define perfilInit(nomes, n) ((void)0)
+#define perfilZerar() ((void)0)
+#define PERFIL_MEDIR(etapa)
+
+#endif
+
+#endif
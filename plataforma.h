@@ -0,0 +1,20 @@
+#ifndef PLATAFORMA_H
+#define PLATAFORMA_H
+
+// Camada mínima para que os módulos de processamento compilem tanto na placa
+// (Pico SDK, PICO_ON_DEVICE=1) quanto no Linux (build de host, sem SDK).
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#else
+// Funções marcadas assim ficam na RAM na placa; no host não faz diferença
+#ifndef __not_in_flash_func
+#define __not_in_flash_func(func_name) func_name
+#endif
+#endif
+
+#endif
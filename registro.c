@@ -0,0 +1,605 @@
+#include <string.h>
+#include "registro.h"
+#include "telemetria_quadro.h" // CRC-16
+
+#if PICO_ON_DEVICE
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/multicore.h"
+
+#define REGISTRO_OFFSET (PICO_FLASH_SIZE_BYTES - REGISTRO_TAM_REGIAO)
+_Static_assert(REGISTRO_TAM_SETOR == FLASH_SECTOR_SIZE, "Setor do registro diferente do setor da flash");
+_Static_assert(REGISTRO_TAM_PAGINA == FLASH_PAGE_SIZE, "Página do registro diferente da página da flash");
+#endif
+
+#define MAGICO_SETOR 0x52543755u // "U7TR"
+#define MAGICO_PAGINA 0x4752     // "RG"
+#define TAM_CAB_SETOR 14
+#define TAM_CAB_PAGINA 16
+#define TAM_DADOS_PAGINA (REGISTRO_TAM_PAGINA - TAM_CAB_PAGINA)
+#define MAX_BYTES_REGISTRO 3     // Varint de uma diferença de 17 bits
+
+// Página em montagem na RAM
+typedef struct {
+    uint8_t bytes[REGISTRO_TAM_PAGINA];
+    uint16_t tam;       // Bytes de dados usados
+    uint16_t n;         // Registros
+    uint16_t anterior;  // Último valor, base da próxima diferença
+    uint16_t periodo;
+    uint16_t periodoMin, periodoMax; // Períodos que mantêm todos os registros na tolerância
+    uint16_t tolerancia; // Desvio aceito em relação à grade, um quarto do primeiro intervalo
+    uint32_t inicio;    // Instante do primeiro registro
+    bool selada;        // Pronta para gravar
+} Pagina;
+
+// Duas páginas: uma enchendo e outra esperando a flash
+static Pagina paginas[2];
+static uint8_t enchendo = 0;
+static bool descarregarPedido = false;
+
+static uint32_t apagamentos[REGISTRO_SETORES];
+static uint32_t setorAtual;     // Setor aberto para escrita
+static uint32_t paginaAtual;    // Próxima página de dados livre no setor atual
+static uint32_t seqAtual;       // Sequência do setor atual
+static bool proximoApagado;     // Próximo setor já apagado, falta o cabeçalho
+static uint32_t setorApagando = REGISTRO_SETORES; // Apagamento começado e suspenso entre as chamadas
+static uint32_t apagarProximo = REGISTRO_SETORES; // Apagamento da região em andamento
+static RegistroStats stats;
+
+static void flashInit();
+static const uint8_t *lerFlash(uint32_t offset);
+static bool gravarFlash(uint32_t offset, const uint8_t *dados);
+static bool apagarFatia(uint32_t offset, bool comecar, bool *comecou);
+
+static void escrever16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void escrever32(uint8_t *p, uint32_t v) {
+    escrever16(p, v);
+    escrever16(p + 2, v >> 16);
+}
+
+static uint16_t ler16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t ler32(const uint8_t *p) {
+    return ler16(p) | ((uint32_t)ler16(p + 2) << 16);
+}
+
+static uint32_t offsetPagina(uint32_t setor, uint32_t pagina) {
+    return setor * REGISTRO_TAM_SETOR + pagina * REGISTRO_TAM_PAGINA;
+}
+
+static bool cabecalhoSetor(uint32_t setor, uint32_t *seq, uint32_t *nApagamentos) {
+    const uint8_t *p = lerFlash(offsetPagina(setor, 0));
+    if (ler32(p) != MAGICO_SETOR || telemetriaCrc16(p, TAM_CAB_SETOR - 2) != ler16(&p[TAM_CAB_SETOR - 2])) {
+        return false;
+    }
+    *seq = ler32(&p[4]);
+    *nApagamentos = ler32(&p[8]);
+    return true;
+}
+
+static bool paginaApagada(const uint8_t *p) {
+    for (int i = 0; i < REGISTRO_TAM_PAGINA; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// CRC do cabeçalho (sem o próprio campo) seguido dos dados
+static uint16_t crcPagina(const uint8_t *p, uint16_t tam) {
+    uint8_t copia[REGISTRO_TAM_PAGINA];
+    memcpy(copia, p, TAM_CAB_PAGINA - 2);
+    memcpy(&copia[TAM_CAB_PAGINA - 2], &p[TAM_CAB_PAGINA], tam);
+    return telemetriaCrc16(copia, TAM_CAB_PAGINA - 2 + tam);
+}
+
+static bool paginaValida(const uint8_t *p) {
+    uint16_t tam = ler16(&p[10]);
+    return ler16(p) == MAGICO_PAGINA && tam <= TAM_DADOS_PAGINA && crcPagina(p, tam) == ler16(&p[14]);
+}
+
+void registroInit() {
+    flashInit();
+    bool algum = false;
+    uint32_t seqMax = 0;
+    uint32_t apagamentosMax = 0;
+    bool valido[REGISTRO_SETORES];
+
+    // Setor com a maior sequência é o atual; os outros seguem no anel
+    for (uint32_t s = 0; s < REGISTRO_SETORES; s++) {
+        uint32_t seq;
+        valido[s] = cabecalhoSetor(s, &seq, &apagamentos[s]);
+        if (!valido[s]) {
+            continue;
+        }
+        if (apagamentos[s] > apagamentosMax) {
+            apagamentosMax = apagamentos[s];
+        }
+        if (!algum || (int32_t)(seq - seqMax) > 0) {
+            algum = true;
+            seqMax = seq;
+            setorAtual = s;
+        }
+    }
+
+    uint16_t sessaoMax = 0;
+    for (uint32_t s = 0; s < REGISTRO_SETORES; s++) {
+        if (!valido[s]) {
+            // Cabeçalho perdido (corte durante o apagamento ou a gravação):
+            // a contagem real não é conhecida, fica a maior da região
+            apagamentos[s] = apagamentosMax;
+            continue;
+        }
+        for (uint32_t pg = 1; pg <= REGISTRO_PAGINAS_DADOS; pg++) {
+            const uint8_t *p = lerFlash(offsetPagina(s, pg));
+            if (paginaValida(p) && ler16(&p[2]) > sessaoMax) {
+                sessaoMax = ler16(&p[2]);
+            }
+        }
+    }
+
+    if (algum) {
+        // Continua depois da última página usada; uma página cortada no meio
+        // não está apagada e também é pulada
+        seqAtual = seqMax;
+        paginaAtual = 0;
+        for (uint32_t pg = REGISTRO_PAGINAS_DADOS; pg >= 1; pg--) {
+            if (!paginaApagada(lerFlash(offsetPagina(setorAtual, pg)))) {
+                paginaAtual = pg; // Página de dados pg - 1 usada: a próxima é pg
+                break;
+            }
+        }
+    } else {
+        // Região vazia: o primeiro registro abre o setor 0
+        setorAtual = REGISTRO_SETORES - 1;
+        paginaAtual = REGISTRO_PAGINAS_DADOS;
+        seqAtual = 0;
+    }
+
+    proximoApagado = false;
+    setorApagando = REGISTRO_SETORES;
+    apagarProximo = REGISTRO_SETORES;
+    enchendo = 0;
+    paginas[0].n = 0;
+    paginas[0].selada = false;
+    paginas[1].n = 0;
+    paginas[1].selada = false;
+    descarregarPedido = false;
+    memset(&stats, 0, sizeof(stats));
+    stats.sessao = sessaoMax + 1;
+}
+
+// Fecha a página: cabeçalho com CRC e o resto dos dados em 0xFF (não gravado)
+static void selar(Pagina *p) {
+    uint8_t *b = p->bytes;
+    memset(&b[TAM_CAB_PAGINA + p->tam], 0xFF, TAM_DADOS_PAGINA - p->tam);
+    escrever16(&b[0], MAGICO_PAGINA);
+    escrever16(&b[2], stats.sessao);
+    escrever32(&b[4], p->inicio);
+    escrever16(&b[8], p->periodo);
+    escrever16(&b[10], p->tam);
+    escrever16(&b[12], p->n);
+    escrever16(&b[14], crcPagina(b, p->tam));
+    p->selada = true;
+}
+
+// Sela a página que está enchendo e passa para a outra, se ela estiver livre
+static bool trocar() {
+    if (paginas[enchendo ^ 1].selada) {
+        return false;
+    }
+    selar(&paginas[enchendo]);
+    enchendo ^= 1;
+    paginas[enchendo].n = 0;
+    return true;
+}
+
+// O registro k cabe na grade de período P se |instante - (inicio + k * P)|
+// <= tolerancia. Cada registro restringe P a um intervalo; a página guarda a
+// interseção, então o período se ajusta ao ritmo real dos instantes (que não
+// é um número inteiro de ms) sem que o erro acumule ao longo da página, e um
+// salto de um período inteiro ainda fica de fora.
+static bool intervaloPeriodo(const Pagina *p, uint32_t instanteMs, int32_t *min, int32_t *max) {
+    int32_t d = (int32_t)(instanteMs - p->inicio);
+    int32_t k = p->n;
+    int32_t lo = d - p->tolerancia, hi = d + p->tolerancia;
+    *min = lo > 0 ? (lo + k - 1) / k : 1;
+    *max = hi / k;
+    if (*min < p->periodoMin) {
+        *min = p->periodoMin;
+    }
+    if (*max > p->periodoMax) {
+        *max = p->periodoMax;
+    }
+    return *min <= *max;
+}
+
+static bool cabe(const Pagina *p, uint32_t instanteMs) {
+    if (p->tam + MAX_BYTES_REGISTRO > TAM_DADOS_PAGINA) {
+        return false;
+    }
+    if (p->n == 1) {
+        uint32_t d = instanteMs - p->inicio;
+        return d > 0 && d <= 0xFFFF;
+    }
+    int32_t min, max;
+    return intervaloPeriodo(p, instanteMs, &min, &max);
+}
+
+void registroAdicionar(uint16_t valor, uint32_t instanteMs) {
+    Pagina *p = &paginas[enchendo];
+    if (p->n > 0 && !cabe(p, instanteMs)) {
+        if (!trocar()) {
+            stats.perdidos++;
+            return;
+        }
+        p = &paginas[enchendo];
+    }
+
+    if (p->n == 0) {
+        p->inicio = instanteMs;
+        p->periodo = 0;
+        p->anterior = 0;
+        p->tam = 0;
+    } else if (p->n == 1) {
+        p->periodo = instanteMs - p->inicio;
+        p->tolerancia = p->periodo / 4;
+        p->periodoMin = p->periodo - p->tolerancia;
+        p->periodoMax = p->periodo + p->tolerancia > 0xFFFF ? 0xFFFF : p->periodo + p->tolerancia;
+    } else {
+        int32_t min, max;
+        intervaloPeriodo(p, instanteMs, &min, &max);
+        p->periodoMin = min;
+        p->periodoMax = max;
+        p->periodo = (min + max) / 2; // O meio deixa a maior folga para os próximos
+    }
+
+    // Zigzag: diferenças pequenas, positivas ou negativas, viram números pequenos
+    int32_t diferenca = (int32_t)valor - p->anterior;
+    uint32_t zz = ((uint32_t)diferenca << 1) ^ (uint32_t)(diferenca >> 31);
+    uint8_t *d = &p->bytes[TAM_CAB_PAGINA];
+    while (zz >= 0x80) {
+        d[p->tam++] = (zz & 0x7F) | 0x80;
+        zz >>= 7;
+    }
+    d[p->tam++] = zz;
+
+    p->anterior = valor;
+    p->n++;
+    stats.gravados++;
+}
+
+void registroDescarregar() {
+    descarregarPedido = true;
+}
+
+void registroApagar() {
+    apagarProximo = 0;
+}
+
+// Avança uma fatia do apagamento de 'setor'. Retorna true quando ele está
+// apagado. Um apagamento de outro setor que ainda esteja suspenso termina
+// antes, e um que sobrou de antes do reset também.
+static bool apagarSetor(uint32_t setor) {
+    bool comecou = false;
+    if (!apagarFatia(offsetPagina(setor, 0), setorApagando == REGISTRO_SETORES, &comecou)) {
+        if (comecou) {
+            setorApagando = setor;
+        }
+        return false;
+    }
+    uint32_t apagado = comecou ? setor : setorApagando;
+    setorApagando = REGISTRO_SETORES;
+    if (apagado == REGISTRO_SETORES) {
+        return false;
+    }
+    apagamentos[apagado]++;
+    stats.setoresApagados++;
+    return apagado == setor;
+}
+
+void registroProcessar(uint32_t agoraMs) {
+    if (apagarProximo < REGISTRO_SETORES) {
+        if (apagarSetor(apagarProximo) && ++apagarProximo == REGISTRO_SETORES) {
+            // Região vazia: recomeça pelo setor 0, que já está apagado
+            setorAtual = REGISTRO_SETORES - 1;
+            paginaAtual = REGISTRO_PAGINAS_DADOS;
+            proximoApagado = true;
+        }
+        return;
+    }
+
+    Pagina *selada = &paginas[enchendo ^ 1];
+    if (!selada->selada) {
+        Pagina *p = &paginas[enchendo];
+        if (p->n > 0 && (descarregarPedido || agoraMs - p->inicio >= REGISTRO_MAX_ATRASO_MS)) {
+            descarregarPedido = !trocar();
+        }
+    }
+
+    if (selada->selada && paginaAtual < REGISTRO_PAGINAS_DADOS) {
+        if (gravarFlash(offsetPagina(setorAtual, 1 + paginaAtual), selada->bytes)) {
+            paginaAtual++;
+            selada->selada = false;
+            stats.paginasGravadas++;
+        }
+        return;
+    }
+
+    // O próximo setor do anel é apagado com antecedência, uma fatia por
+    // chamada, enquanto o atual ainda tem páginas livres
+    uint32_t proximo = (setorAtual + 1) % REGISTRO_SETORES;
+    if (!proximoApagado) {
+        proximoApagado = apagarSetor(proximo);
+        return;
+    }
+
+    if (selada->selada) {
+        // Setor cheio: o cabeçalho abre o próximo
+        uint8_t cab[REGISTRO_TAM_PAGINA];
+        memset(cab, 0xFF, sizeof(cab));
+        escrever32(&cab[0], MAGICO_SETOR);
+        escrever32(&cab[4], seqAtual + 1);
+        escrever32(&cab[8], apagamentos[proximo]);
+        escrever16(&cab[TAM_CAB_SETOR - 2], telemetriaCrc16(cab, TAM_CAB_SETOR - 2));
+        if (gravarFlash(offsetPagina(proximo, 0), cab)) {
+            setorAtual = proximo;
+            seqAtual++;
+            paginaAtual = 0;
+            proximoApagado = false;
+        }
+    }
+}
+
+static uint32_t decodificar(uint16_t sessao, uint32_t inicio, uint16_t periodo, uint16_t n, const uint8_t *d,
+                            uint16_t tam, RegistroCallback cb, void *ctx) {
+    uint16_t valor = 0;
+    uint16_t i = 0;
+    uint32_t k;
+    for (k = 0; k < n && i < tam; k++) {
+        uint32_t zz = 0;
+        for (int bits = 0; i < tam; bits += 7) {
+            uint8_t b = d[i++];
+            zz |= (uint32_t)(b & 0x7F) << bits;
+            if (!(b & 0x80)) {
+                break;
+            }
+        }
+        valor += (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1);
+        cb(sessao, inicio + k * periodo, valor, ctx);
+    }
+    return k;
+}
+
+static uint32_t decodificarRam(const Pagina *p, RegistroCallback cb, void *ctx) {
+    return decodificar(stats.sessao, p->inicio, p->periodo, p->n, &p->bytes[TAM_CAB_PAGINA], p->tam, cb, ctx);
+}
+
+uint32_t registroExportar(RegistroCallback cb, void *ctx) {
+    uint32_t total = 0;
+
+    // Do setor seguinte ao atual (o mais antigo) até o atual
+    for (uint32_t k = 1; k <= REGISTRO_SETORES; k++) {
+        uint32_t s = (setorAtual + k) % REGISTRO_SETORES;
+        uint32_t seq, n;
+        if (!cabecalhoSetor(s, &seq, &n)) {
+            continue;
+        }
+        for (uint32_t pg = 1; pg <= REGISTRO_PAGINAS_DADOS; pg++) {
+            const uint8_t *p = lerFlash(offsetPagina(s, pg));
+            if (!paginaValida(p)) {
+                continue; // Apagada ou cortada no meio
+            }
+            total += decodificar(ler16(&p[2]), ler32(&p[4]), ler16(&p[8]), ler16(&p[12]), &p[TAM_CAB_PAGINA],
+                                 ler16(&p[10]), cb, ctx);
+        }
+    }
+
+    // O que ainda está na RAM: a página selada é mais antiga que a que está enchendo
+    if (paginas[enchendo ^ 1].selada) {
+        total += decodificarRam(&paginas[enchendo ^ 1], cb, ctx);
+    }
+    total += decodificarRam(&paginas[enchendo], cb, ctx);
+    return total;
+}
+
+void registroGetStats(RegistroStats *s) {
+    *s = stats;
+    s->apagamentosMin = apagamentos[0];
+    s->apagamentosMax = apagamentos[0];
+    for (uint32_t i = 1; i < REGISTRO_SETORES; i++) {
+        if (apagamentos[i] < s->apagamentosMin) {
+            s->apagamentosMin = apagamentos[i];
+        }
+        if (apagamentos[i] > s->apagamentosMax) {
+            s->apagamentosMax = apagamentos[i];
+        }
+    }
+}
+
+#if PICO_ON_DEVICE
+
+static void flashInit() {
+}
+
+// Leitura sem alocar na cache da XIP, para que a exportação não expulse o código
+static const uint8_t *lerFlash(uint32_t offset) {
+    return (const uint8_t *)(XIP_NOCACHE_NOALLOC_BASE + REGISTRO_OFFSET + offset);
+}
+
+// Com a XIP desligada nada pode rodar da flash: o núcleo 1 fica preso num laço
+// na RAM (multicore_lockout) e as interrupções deste núcleo ficam desligadas.
+// As funções de gravar e de mandar comandos do SDK já estão na RAM.
+static bool __not_in_flash_func(gravarFlash)(uint32_t offset, const uint8_t *dados) {
+    if (!multicore_lockout_victim_is_initialized(1)) {
+        return false; // Núcleo 1 ainda não está pronto; tenta na próxima chamada
+    }
+    multicore_lockout_start_blocking();
+    uint32_t estado = save_and_disable_interrupts();
+    flash_range_program(REGISTRO_OFFSET + offset, dados, FLASH_PAGE_SIZE);
+    restore_interrupts(estado);
+    multicore_lockout_end_blocking();
+    return true;
+}
+
+// Comandos da W25Q16JV do Pico W
+#define CMD_WREN 0x06
+#define CMD_APAGAR_SETOR 0x20
+#define CMD_STATUS1 0x05
+#define CMD_STATUS2 0x35
+#define CMD_SUSPENDER 0x75
+#define CMD_RETOMAR 0x7A
+#define STATUS1_BUSY 0x01
+#define STATUS2_SUS 0x80
+
+static void __not_in_flash_func(comando)(uint8_t cmd) {
+    uint8_t resposta;
+    flash_do_cmd(&cmd, &resposta, 1);
+}
+
+static uint8_t __not_in_flash_func(lerStatus)(uint8_t cmd) {
+    uint8_t tx[2] = {cmd, 0}, rx[2];
+    flash_do_cmd(tx, rx, 2);
+    return rx[1];
+}
+
+// Espera sem chamar nada da flash (o busy_wait do SDK pode não estar na RAM)
+static void __not_in_flash_func(esperarUs)(uint32_t us) {
+    uint32_t inicio = timer_hw->timerawl;
+    while (timer_hw->timerawl - inicio < us) {
+    }
+}
+
+// O apagamento de um setor leva de 45 a 400 ms, muito mais que o anel da
+// captura aguenta com o núcleo 1 parado. Cada chamada deixa a flash apagar por
+// REGISTRO_FATIA_US e suspende o apagamento (Erase Suspend); entre as chamadas
+// a XIP volta a funcionar, o código roda da flash normalmente e a gravação de
+// páginas de outros setores é permitida. O flash_do_cmd religa a XIP depois
+// de cada comando, mas nada é buscado dela até a flash ficar livre de novo.
+static bool __not_in_flash_func(apagarFatia)(uint32_t offset, bool comecar, bool *comecou) {
+    if (!multicore_lockout_victim_is_initialized(1)) {
+        return false;
+    }
+    multicore_lockout_start_blocking();
+    uint32_t estado = save_and_disable_interrupts();
+
+    bool terminou = false;
+    if (lerStatus(CMD_STATUS2) & STATUS2_SUS) {
+        comando(CMD_RETOMAR); // O nosso, ou um que sobrou de um reset sem desligar a flash
+    } else if (comecar) {
+        uint32_t endereco = REGISTRO_OFFSET + offset;
+        uint8_t cmd[4] = {CMD_APAGAR_SETOR, endereco >> 16, endereco >> 8, endereco};
+        uint8_t resposta[4];
+        comando(CMD_WREN);
+        flash_do_cmd(cmd, resposta, sizeof(cmd));
+        *comecou = true;
+    } else {
+        terminou = true; // Nada em andamento
+    }
+
+    if (!terminou) {
+        esperarUs(REGISTRO_FATIA_US);
+        if (lerStatus(CMD_STATUS1) & STATUS1_BUSY) {
+            comando(CMD_SUSPENDER);
+            while (lerStatus(CMD_STATUS1) & STATUS1_BUSY) {
+            }
+        }
+        // Pode ter terminado entre a leitura do BUSY e a suspensão
+        terminou = !(lerStatus(CMD_STATUS2) & STATUS2_SUS);
+    }
+
+    restore_interrupts(estado);
+    multicore_lockout_end_blocking();
+    return terminou;
+}
+
+#else
+
+#define FATIAS_SIMULADAS 8 // Chamadas por apagamento na flash simulada
+
+// Flash simulada: começa apagada, gravar só leva bits de 1 para 0
+static uint8_t flashSimulada[REGISTRO_TAM_REGIAO];
+static bool simulacaoIniciada = false;
+static int64_t bytesAteCorte = -1;
+static bool cortada = false;
+static int64_t offsetApagando = -1;
+static uint32_t apagadosNoSetor;
+
+// Um novo registroInit() é o boot seguinte: a energia voltou e o apagamento
+// interrompido não continua
+static void flashInit() {
+    cortada = false;
+    bytesAteCorte = -1;
+    offsetApagando = -1;
+}
+
+static const uint8_t *lerFlash(uint32_t offset) {
+    if (!simulacaoIniciada) {
+        memset(flashSimulada, 0xFF, sizeof(flashSimulada));
+        simulacaoIniciada = true;
+    }
+    return &flashSimulada[offset];
+}
+
+// Quantos dos 'tam' bytes da operação chegam à flash antes do corte
+static uint32_t consumirAteCorte(uint32_t tam) {
+    if (cortada) {
+        return 0; // Sem energia: nada chega à flash
+    }
+    if (bytesAteCorte >= 0) {
+        if (bytesAteCorte <= tam) {
+            tam = bytesAteCorte;
+            cortada = true;
+        }
+        bytesAteCorte -= tam;
+    }
+    return tam;
+}
+
+static bool gravarFlash(uint32_t offset, const uint8_t *dados) {
+    lerFlash(0);
+    uint32_t tam = consumirAteCorte(REGISTRO_TAM_PAGINA);
+    for (uint32_t i = 0; i < tam; i++) {
+        flashSimulada[offset + i] &= dados[i];
+    }
+    return true;
+}
+
+static bool apagarFatia(uint32_t offset, bool comecar, bool *comecou) {
+    lerFlash(0);
+    if (offsetApagando < 0) {
+        if (!comecar) {
+            return true;
+        }
+        offsetApagando = offset;
+        apagadosNoSetor = 0;
+        *comecou = true;
+    }
+    uint32_t tam = consumirAteCorte(REGISTRO_TAM_SETOR / FATIAS_SIMULADAS);
+    memset(&flashSimulada[offsetApagando + apagadosNoSetor], 0xFF, tam);
+    apagadosNoSetor += REGISTRO_TAM_SETOR / FATIAS_SIMULADAS;
+    if (apagadosNoSetor < REGISTRO_TAM_SETOR) {
+        return false;
+    }
+    offsetApagando = -1;
+    return true;
+}
+
+void registroSimularCorte(uint32_t bytes) {
+    bytesAteCorte = bytes;
+}
+
+uint8_t *registroFlashSimulada() {
+    lerFlash(0);
+    return flashSimulada;
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include "plataforma.h"
+
+// Registro das leituras na flash, para levantamentos feitos com a placa fora
+// da USB. Ocupa os últimos REGISTRO_TAM_REGIAO bytes da flash como um anel de
+// setores de 4 KB, gravados em ordem e reaproveitados do mais antigo para o
+// mais novo: todos os setores são apagados o mesmo número de vezes.
+//
+// Setor: página 0 com o cabeçalho (sequência e contagem de apagamentos) e
+// REGISTRO_PAGINAS_DADOS páginas de 256 bytes de dados. Cada página de dados
+// é gravada de uma vez, com cabeçalho e CRC próprios, e pode ser lida sozinha:
+// uma página cortada no meio por falta de energia só falha no CRC e é pulada.
+//
+// Os registros são comprimidos: cada valor é gravado como a diferença para o
+// anterior (zigzag + varint, 1 byte para |diferença| < 64), com o instante
+// implícito pelo período da página.
+//
+// Só registroProcessar() mexe na flash, uma operação curta por chamada: gravar
+// uma página ou uma fatia de REGISTRO_FATIA_US do apagamento de um setor, que
+// fica suspenso entre as chamadas. O próximo setor do anel é apagado assim,
+// com antecedência, enquanto o atual ainda tem páginas livres. Durante a
+// operação o outro núcleo fica parado na RAM e as interrupções deste núcleo
+// ficam desligadas; o DMA da captura continua amostrando para o anel em RAM,
+// que aguenta bem mais que uma fatia.
+
+#define REGISTRO_TAM_REGIAO (256 * 1024)
+#define REGISTRO_TAM_PAGINA 256
+#define REGISTRO_TAM_SETOR 4096
+#define REGISTRO_SETORES (REGISTRO_TAM_REGIAO / REGISTRO_TAM_SETOR)
+#define REGISTRO_PAGINAS_DADOS (REGISTRO_TAM_SETOR / REGISTRO_TAM_PAGINA - 1)
+#define REGISTRO_MAX_ATRASO_MS 30000 // Página parcial é gravada depois desse tempo
+#define REGISTRO_FATIA_US 500 // Apagamento por chamada; menos que um bloco da captura (1,6 ms)
+
+typedef struct {
+    uint16_t sessao;            // Incrementa a cada boot
+    uint32_t gravados;          // Registros aceitos desde o boot
+    uint32_t perdidos;          // Registros descartados com a flash ocupada
+    uint32_t paginasGravadas;
+    uint32_t setoresApagados;
+    uint32_t apagamentosMin;    // Desgaste dos setores da região
+    uint32_t apagamentosMax;
+} RegistroStats;
+
+// Chamado para cada registro, do mais antigo para o mais novo
+typedef void (*RegistroCallback)(uint16_t sessao, uint32_t instanteMs, uint16_t valor, void *ctx);
+
+// Varre a região, recupera o ponto de escrita e abre uma sessão nova
+void registroInit();
+
+// Acrescenta um valor ao buffer em RAM. 'instanteMs' deve avançar de um
+// período fixo, com desvio de até um quarto dele em cada registro; um salto
+// começa uma página nova. Os instantes exportados são os da grade da página.
+void registroAdicionar(uint16_t valor, uint32_t instanteMs);
+
+// Faz no máximo uma operação de flash pendente. Chamar do laço principal.
+void registroProcessar(uint32_t agoraMs);
+
+// Grava a página parcial na próxima chamada de registroProcessar()
+void registroDescarregar();
+
+// Lê a região (pela XIP, sem passar pela cache) e entrega todos os registros válidos
+uint32_t registroExportar(RegistroCallback cb, void *ctx);
+
+// Apaga a região inteira, setor por setor, em fatias de registroProcessar()
+void registroApagar();
+
+void registroGetStats(RegistroStats *stats);
+
+#if !PICO_ON_DEVICE
+// Flash simulada do build de host: a energia cai depois de mais 'bytes'
+// bytes gravados ou apagados; o resto da operação e as seguintes são
+// ignorados até o próximo registroInit(). Um apagamento leva algumas chamadas
+// de registroProcessar(), cada uma apagando uma parte do setor.
+void registroSimularCorte(uint32_t bytes);
+uint8_t *registroFlashSimulada();
+#endif
+
+#endif
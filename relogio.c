@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include "relogio.h"
+
+#if PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#include "hardware/vreg.h"
+#endif
+
+#define RELOGIO_VREG_US 1000 // Espera para a tensão nova estabilizar antes de subir o clock
+
+typedef struct {
+    const char *nome;
+    uint32_t khz;
+    uint16_t milivolts; // Tensão do núcleo (padrão do RP2040: 1100 mV)
+} RelogioPerfil;
+
+static const RelogioPerfil perfis[RELOGIO_NUM_MODOS] = {
+    {"ECO", 48000, 1100},
+    {"NORMAL", 125000, 1100},
+    {"TURBO", 200000, 1150},
+};
+
+static RelogioModo modoAtual = RELOGIO_NORMAL; // O boot do SDK deixa o clk_sys em 125 MHz
+static RelogioStats stats[RELOGIO_NUM_MODOS] = {[RELOGIO_NORMAL] = {.entradas = 1}};
+static uint64_t ultimaConta = 0;
+
+bool relogioCalcular(uint32_t sysHz, uint32_t i2cHz, RelogioDivisores *d) {
+    d->sysHz = sysHz;
+    d->valido = false;
+    if (sysHz == 0 || i2cHz == 0) {
+        return false;
+    }
+
+    // Divisor da PIO em 16.8, truncado como no pio_sm_set_clkdiv do SDK
+    uint64_t div256 = ((uint64_t)sysHz << 8) / ((uint64_t)RELOGIO_WS2812_CICLOS_BIT * RELOGIO_WS2812_HZ);
+    d->pioDivInt = div256 >> 8 > UINT16_MAX ? UINT16_MAX : (uint16_t)(div256 >> 8);
+    d->pioDivFrac = div256 & 0xFF;
+    d->bitNs = (uint32_t)(div256 * RELOGIO_WS2812_CICLOS_BIT * 1000000000ull / ((uint64_t)sysHz << 8));
+    uint32_t bitNominal = 1000000000u / RELOGIO_WS2812_HZ;
+    uint32_t desvio = d->bitNs > bitNominal ? d->bitNs - bitNominal : bitNominal - d->bitNs;
+    bool pioOk = div256 >= 256 && div256 >> 8 <= UINT16_MAX && desvio * 100 <= bitNominal * RELOGIO_TOLERANCIA_WS2812;
+
+    // Mesma conta do i2c_set_baudrate: período arredondado, 3/5 em nível baixo
+    uint32_t periodo = (sysHz + i2cHz / 2) / i2cHz;
+    uint32_t baixo = periodo * 3 / 5;
+    uint32_t alto = periodo - baixo;
+    d->i2cHz = periodo ? sysHz / periodo : 0;
+    bool i2cOk = alto >= 8 && baixo >= 8 && alto <= 0xFFFF && d->i2cHz <= i2cHz &&
+                 (uint64_t)d->i2cHz * 100 >= (uint64_t)i2cHz * (100 - RELOGIO_TOLERANCIA_I2C);
+
+    d->valido = pioOk && i2cOk;
+    return d->valido;
+}
+
+uint32_t relogioFrequencia(RelogioModo modo) {
+    return perfis[modo].khz * 1000;
+}
+
+const char *relogioNome(RelogioModo modo) {
+    return perfis[modo].nome;
+}
+
+RelogioModo relogioModo() {
+    return modoAtual;
+}
+
+void relogioContabilizar(uint64_t agora, uint32_t ociosoPorMil) {
+    uint64_t intervalo = agora - ultimaConta;
+    ultimaConta = agora;
+    stats[modoAtual].tempoUs += intervalo;
+    stats[modoAtual].ocupadoUs += intervalo * (1000 - (ociosoPorMil > 1000 ? 1000 : ociosoPorMil)) / 1000;
+}
+
+const RelogioStats *relogioStats(RelogioModo modo) {
+    return &stats[modo];
+}
+
+void relogioTrocaConcluida(uint32_t duracaoUs) {
+    if (duracaoUs > stats[modoAtual].trocaMaxUs) {
+        stats[modoAtual].trocaMaxUs = duracaoUs;
+    }
+}
+
+void relogioRelatorio(RelogioSaida saida, void *ctx) {
+    char linha[160];
+    const RelogioPerfil *normal = &perfis[RELOGIO_NORMAL];
+    uint64_t referencia = (uint64_t)normal->khz * normal->milivolts * normal->milivolts;
+    for (int i = 0; i < RELOGIO_NUM_MODOS; i++) {
+        const RelogioPerfil *p = &perfis[i];
+        const RelogioStats *s = &stats[i];
+        // Potência dinâmica relativa ao modo normal, sem contar o tempo dormindo
+        uint32_t potencia = (uint32_t)((uint64_t)p->khz * p->milivolts * p->milivolts * 100 / referencia);
+        uint32_t ocupacao = s->tempoUs ? (uint32_t)(s->ocupadoUs * 1000 / s->tempoUs) : 0;
+        snprintf(linha, sizeof(linha), "CLK %s %lu MHz %u mV: %lu.%lu s, nucleo 0 ocupado %lu.%lu%%, f*V^2 %lu%%, troca max %lu us, %lu entradas",
+                 p->nome, (unsigned long)(p->khz / 1000), p->milivolts, (unsigned long)(s->tempoUs / 1000000),
+                 (unsigned long)(s->tempoUs / 100000 % 10), (unsigned long)ocupacao / 10, (unsigned long)ocupacao % 10,
+                 (unsigned long)potencia, (unsigned long)s->trocaMaxUs, (unsigned long)s->entradas);
+        saida(linha, ctx);
+    }
+}
+
+#if PICO_ON_DEVICE
+
+// Os valores do vreg_voltage andam de 50 em 50 mV a partir de 0,85 V
+static enum vreg_voltage tensao(uint16_t milivolts) {
+    return (enum vreg_voltage)(VREG_VOLTAGE_0_85 + (milivolts - 850) / 50);
+}
+
+bool relogioMudar(RelogioModo modo) {
+    const RelogioPerfil *novo = &perfis[modo];
+    const RelogioPerfil *antigo = &perfis[modoAtual];
+    uint vco, pd1, pd2;
+    if (modo == modoAtual) {
+        return true;
+    }
+    if (!check_sys_clock_khz(novo->khz, &vco, &pd1, &pd2)) {
+        return false;
+    }
+
+    // A tensão sobe antes do clock e desce depois dele
+    if (novo->milivolts > antigo->milivolts) {
+        vreg_set_voltage(tensao(novo->milivolts));
+        busy_wait_us(RELOGIO_VREG_US);
+    }
+    set_sys_clock_pll(vco, pd1, pd2);
+    if (novo->milivolts < antigo->milivolts) {
+        vreg_set_voltage(tensao(novo->milivolts));
+    }
+
+    modoAtual = modo;
+    stats[modo].entradas++;
+    return true;
+}
+
+#else
+
+bool relogioMudar(RelogioModo modo) {
+    if (modo != modoAtual) {
+        modoAtual = modo;
+        stats[modo].entradas++;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RELOGIO_H
+#define RELOGIO_H
+
+#include "plataforma.h"
+
+// Frequência do clk_sys por modo de operação. O clk_peri acompanha o clk_sys
+// (set_sys_clock_khz), então a cada troca os periféricos que dependem dele
+// precisam de divisores novos: a máquina PIO do WS2812, os PWM dos buzzers e
+// o I2C do OLED. O clk_adc e o clk_usb vêm do PLL da USB e não mudam.
+//
+// relogioCalcular() só faz contas e roda igual no host: é o que a aplicação
+// usa para programar a PIO e para conferir o I2C antes de cada troca.
+//
+// Não há sensor de corrente na placa: o consumo de cada modo é estimado pela
+// potência dinâmica (proporcional a f * V^2) junto com a ocupação do núcleo 0.
+
+#define RELOGIO_WS2812_HZ 800000      // Bits por segundo no fio dos LEDs
+#define RELOGIO_WS2812_CICLOS_BIT 10  // Ciclos da máquina por bit (T1 + T2 + T3 em ws2818b.pio)
+#define RELOGIO_TOLERANCIA_WS2812 5   // % aceito no período do bit (WS2812B: 1,25 us +-600 ns no total)
+#define RELOGIO_TOLERANCIA_I2C 2      // % aceito abaixo do baud pedido (acima nunca)
+
+typedef enum {
+    RELOGIO_ECONOMIA, // 48 MHz: sem campo há algum tempo
+    RELOGIO_NORMAL,   // 125 MHz: padrão do SDK
+    RELOGIO_TURBO,    // 200 MHz com o regulador em 1,15 V: FFT na tela do espectro
+    RELOGIO_NUM_MODOS
+} RelogioModo;
+
+typedef struct {
+    uint32_t sysHz;
+    uint16_t pioDivInt;   // Divisor da máquina do WS2812 (parte inteira e 1/256)
+    uint8_t pioDivFrac;
+    uint32_t bitNs;       // Período de bit obtido com esse divisor (1250 ns nominal)
+    uint32_t i2cHz;       // Baud que o i2c_set_baudrate do SDK vai obter
+    bool valido;          // Todos dentro das tolerâncias acima
+} RelogioDivisores;
+
+// Divisores para um clk_sys de 'sysHz' e um I2C de 'i2cHz'
+bool relogioCalcular(uint32_t sysHz, uint32_t i2cHz, RelogioDivisores *d);
+
+uint32_t relogioFrequencia(RelogioModo modo);
+const char *relogioNome(RelogioModo modo);
+
+// Troca o clk_sys (e a tensão do núcleo). Quem chama espera os periféricos
+// ficarem parados antes e os reprograma em seguida. Retorna false se o PLL não
+// gerar a frequência do modo.
+bool relogioMudar(RelogioModo modo);
+RelogioModo relogioModo();
+
+// Soma ao modo atual o tempo desde a chamada anterior, com a ocupação da
+// agenda nesse intervalo (AgendaStats.ociosoPorMil). Para a conta ficar certa,
+// as trocas de modo devem vir logo depois desta chamada.
+void relogioContabilizar(uint64_t agora, uint32_t ociosoPorMil);
+
+typedef struct {
+    uint64_t tempoUs;     // Tempo total no modo
+    uint64_t ocupadoUs;   // Parte em que o núcleo 0 estava acordado
+    uint32_t entradas;
+    uint32_t trocaMaxUs;  // Maior duração de uma troca para este modo, periféricos inclusos
+} RelogioStats;
+
+const RelogioStats *relogioStats(RelogioModo modo);
+void relogioTrocaConcluida(uint32_t duracaoUs);
+
+// Uma linha por modo, no formato "CLK <modo> ..."
+typedef void (*RelogioSaida)(const char *linha, void *ctx);
+void relogioRelatorio(RelogioSaida saida, void *ctx);
+
+#endif
@@ -0,0 +1,201 @@
+// Microbenchmark das primitivas de desenho do OLED (ssd1306_gfx.c) no host.
+//
+// Cada figura é desenhada no framebuffer, com a marcação de colunas sujas,
+// do jeito antigo (pixel a pixel pelo SetPixel e pelo Bresenham originais,
+// copiados aqui como referência) e com as primitivas por página. Imprime os
+// pixels por segundo de cada um e confere que os dois deixam o framebuffer
+// igual; sai com 1 se algum for diferente.
+//
+// Uso: bench_graficos [segundos por medida]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ssd1306.h"
+#include "ssd1306_gfx.h"
+
+// SetPixel e DrawLine como eram antes das primitivas por página
+static void refSetPixel(uint8_t *buf, int x, int y, bool on) {
+    int byte_idx = (y / 8) * SSD1306_WIDTH + x;
+    uint8_t byte = buf[byte_idx];
+    if (on) {
+        byte |= 1 << (y % 8);
+    } else {
+        byte &= ~(1 << (y % 8));
+    }
+    buf[byte_idx] = byte;
+    if (buf == SSD1306_framebuffer()) {
+        SSD1306_mark_dirty(x, x, y / 8, y / 8);
+    }
+}
+
+static void refDrawLine(uint8_t *buf, int x0, int y0, int x1, int y1, bool on) {
+    int dx = abs(x1 - x0);
+    int sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0);
+    int sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        refSetPixel(buf, x0, y0, on);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+// Sprite 16x16 em layout de página: um losango
+static uint8_t sprite[2][16];
+
+static void montarSprite() {
+    for (int y = 0; y < 16; y++) {
+        int meio = y < 8 ? y : 15 - y;
+        for (int x = 7 - meio; x <= 8 + meio; x++) {
+            sprite[y / 8][x] |= 1 << (y % 8);
+        }
+    }
+}
+
+static void antesRetangulo(uint8_t *buf, bool on) {
+    for (int y = 5; y < 25; y++) {
+        refDrawLine(buf, 10, y, 109, y, on);
+    }
+}
+
+static void agoraRetangulo(uint8_t *buf, bool on) {
+    FillRect(buf, 10, 5, 100, 20, on);
+}
+
+static void antesHorizontal(uint8_t *buf, bool on) {
+    refDrawLine(buf, 0, 13, 127, 13, on);
+}
+
+static void agoraHorizontal(uint8_t *buf, bool on) {
+    DrawLine(buf, 0, 13, 127, 13, on);
+}
+
+static void antesVertical(uint8_t *buf, bool on) {
+    refDrawLine(buf, 64, 0, 64, 31, on);
+}
+
+static void agoraVertical(uint8_t *buf, bool on) {
+    DrawLine(buf, 64, 0, 64, 31, on);
+}
+
+static void antesDiagonal(uint8_t *buf, bool on) {
+    refDrawLine(buf, 0, 0, 127, 31, on);
+}
+
+static void agoraDiagonal(uint8_t *buf, bool on) {
+    DrawLine(buf, 0, 0, 127, 31, on);
+}
+
+static void antesContorno(uint8_t *buf, bool on) {
+    refDrawLine(buf, 4, 1, 123, 1, on);
+    refDrawLine(buf, 4, 30, 123, 30, on);
+    refDrawLine(buf, 4, 2, 4, 29, on);
+    refDrawLine(buf, 123, 2, 123, 29, on);
+}
+
+static void agoraContorno(uint8_t *buf, bool on) {
+    DrawRect(buf, 4, 1, 120, 30, on);
+}
+
+// Aceso desenha o sprite opaco (cada pixel da área é aceso ou apagado);
+// apagado limpa a área
+static void antesBitmap(uint8_t *buf, bool on) {
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            refSetPixel(buf, 40 + x, 3 + y, on && ((sprite[y / 8][x] >> (y % 8)) & 1));
+        }
+    }
+}
+
+static void agoraBitmap(uint8_t *buf, bool on) {
+    if (on) {
+        BlitBitmap(buf, 40, 3, sprite[0], 16, 16, true);
+    } else {
+        FillRect(buf, 40, 3, 16, 16, false);
+    }
+}
+
+typedef struct {
+    const char *nome;
+    uint32_t pixels; // Pixels escritos por chamada
+    void (*antes)(uint8_t *buf, bool on);
+    void (*agora)(uint8_t *buf, bool on);
+} Caso;
+
+static const Caso casos[] = {
+    {"retangulo 100x20", 100 * 20, antesRetangulo, agoraRetangulo},
+    {"linha horizontal 128", 128, antesHorizontal, agoraHorizontal},
+    {"linha vertical 32", 32, antesVertical, agoraVertical},
+    {"linha diagonal", 128, antesDiagonal, agoraDiagonal},
+    {"contorno 120x30", 2 * 120 + 2 * 28, antesContorno, agoraContorno},
+    {"bitmap 16x16 y=3", 16 * 16, antesBitmap, agoraBitmap},
+};
+
+static double segundos(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) + (b->tv_nsec - a->tv_nsec) / 1e9;
+}
+
+// Pixels por segundo, alternando aceso e apagado para o buffer mudar sempre
+static double medir(void (*desenhar)(uint8_t *buf, bool on), uint32_t pixels, double duracao) {
+    uint8_t *fb = SSD1306_framebuffer();
+    struct timespec t0, t1;
+    uint64_t chamadas = 0;
+    double decorrido;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    do {
+        for (int i = 0; i < 1000; i++) {
+            desenhar(fb, i & 1);
+        }
+        chamadas += 1000;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        decorrido = segundos(&t0, &t1);
+    } while (decorrido < duracao);
+    return chamadas * pixels / decorrido;
+}
+
+static bool conferir(const Caso *c) {
+    static uint8_t antes[SSD1306_BUF_LEN];
+    uint8_t *fb = SSD1306_framebuffer();
+    for (int fundo = 0; fundo < 4; fundo++) { // Fundo apagado ou xadrez, desenhando aceso ou apagado
+        memset(fb, fundo & 2 ? 0xA5 : 0x00, SSD1306_BUF_LEN);
+        c->antes(fb, fundo & 1);
+        memcpy(antes, fb, SSD1306_BUF_LEN);
+        memset(fb, fundo & 2 ? 0xA5 : 0x00, SSD1306_BUF_LEN);
+        c->agora(fb, fundo & 1);
+        if (memcmp(antes, fb, SSD1306_BUF_LEN) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    double duracao = argc > 1 ? atof(argv[1]) : 0.2;
+    bool ok = true;
+    montarSprite();
+
+    printf("%-22s %14s %14s %8s\n", "", "antes (Mpx/s)", "agora (Mpx/s)", "ganho");
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        const Caso *c = &casos[i];
+        bool igual = conferir(c);
+        double antes = medir(c->antes, c->pixels, duracao);
+        double agora = medir(c->agora, c->pixels, duracao);
+        printf("%-22s %14.1f %14.1f %7.1fx%s\n", c->nome, antes / 1e6, agora / 1e6, agora / antes,
+               igual ? "" : "  DIFERENTE");
+        ok = ok && igual;
+    }
+    return ok ? 0 : 1;
+}
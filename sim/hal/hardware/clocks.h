@@ -0,0 +1,6 @@
+#ifndef SIM_HARDWARE_CLOCKS_H
+#define SIM_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+#endif
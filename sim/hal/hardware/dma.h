@@ -0,0 +1,6 @@
+#ifndef SIM_HARDWARE_DMA_H
+#define SIM_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef SIM_HARDWARE_I2C_H
+#define SIM_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+#define I2C_IC_DATA_CMD_STOP_BITS _u(0x00000200)
+
+typedef struct {
+    uint32_t enable;
+    uint32_t tar;
+    uint32_t data_cmd;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t hw;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t sim_i2c1;
+#define i2c1 (&sim_i2c1)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+#endif
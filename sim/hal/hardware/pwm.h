@@ -0,0 +1,10 @@
+#ifndef SIM_HARDWARE_PWM_H
+#define SIM_HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+// Os buzzers passam pelo tom.c (que tem caminho de host); aqui só o que o
+// ProjetoU7T.c chama direto
+void pwm_set_gpio_level(uint gpio, uint16_t nivel);
+
+#endif
@@ -0,0 +1,3 @@
+#ifndef SIM_PICO_BINARY_INFO_H
+#define SIM_PICO_BINARY_INFO_H
+#endif
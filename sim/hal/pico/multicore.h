@@ -0,0 +1,11 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+#include "pico/stdlib.h"
+
+// O simulador roda os dois núcleos intercalados na mesma thread: o núcleo 1
+// não é lançado, o laço do simulador chama capturaPoll() no lugar dele
+void multicore_launch_core1(void (*entrada)(void));
+void multicore_lockout_victim_init(void);
+
+#endif
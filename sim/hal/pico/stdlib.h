@@ -0,0 +1,54 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+// HAL simulado: só o que o ProjetoU7T.c e o ssd1306_i2c.c usam do Pico SDK
+// fora dos trechos PICO_ON_DEVICE. O tempo é o relógio virtual da agenda.
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+
+#define _u(x) x##u
+#ifndef count_of
+#define count_of(arr) (sizeof(arr) / sizeof((arr)[0]))
+#endif
+
+#define PICO_ERROR_TIMEOUT (-1)
+
+#define GPIO_IN false
+#define GPIO_OUT true
+
+enum gpio_function {
+    GPIO_FUNC_SPI = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+};
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool valor);
+void gpio_pull_up(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+
+uint64_t time_us_64(void);
+void sleep_ms(uint32_t ms);
+
+static inline void tight_loop_contents(void) {
+}
+
+#define __wfi() ((void)0)
+#define __wfe() ((void)0)
+#define __sev() ((void)0)
+
+#endif
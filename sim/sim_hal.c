@@ -0,0 +1,69 @@
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/i2c.h"
+#include "hardware/pwm.h"
+#include "agenda.h"
+
+i2c_inst_t sim_i2c1;
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    return PICO_ERROR_TIMEOUT;
+}
+
+void gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_put(uint gpio, bool valor) {
+    (void)gpio;
+    (void)valor;
+}
+
+void gpio_pull_up(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+uint64_t time_us_64(void) {
+    return agendaAgora();
+}
+
+// Esperas viram avanço do relógio virtual
+void sleep_ms(uint32_t ms) {
+    agendaConsumir(ms * 1000);
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t nivel) {
+    (void)gpio;
+    (void)nivel;
+}
+
+void multicore_launch_core1(void (*entrada)(void)) {
+    (void)entrada;
+}
+
+void multicore_lockout_victim_init(void) {
+}
@@ -0,0 +1,303 @@
+// Simulação do firmware no Linux. Roda o mesmo código da aplicação sobre o
+// HAL simulado (sim/hal), alimentando a captura com um traço gravado da antena
+// e avançando o relógio virtual da agenda, bem mais rápido que o tempo real.
+//
+// Uso: projeto_sim <traço> [diretório de saída] [taxa do traço]
+//
+// O traço pode ser binário (.bin, uint16 little-endian), texto com um valor
+// por linha ou a saída do tools/telemetria_dump (linhas "amostra,..."). Sem a
+// taxa, vale a da captura do firmware; um traço mais lento (por exemplo, o da
+// telemetria, já dizimado) é repetido amostra a amostra até a taxa da captura.
+// Com a varredura de vários canais (CANAIS_ADC), todas as antenas recebem o
+// mesmo traço e o sensor de temperatura lê um valor fixo de 27 °C.
+// Saídas, para comparação entre versões:
+//   oled.txt        RAM do display a cada mudança (arte ASCII)
+//   matriz.txt      quadros GRB enviados para a matriz de LEDs
+//   buzzer.txt      tom aplicado (frequência, divisor, wrap e nível)
+//   telemetria.bin  quadros de telemetria (decodificáveis pelo telemetria_dump)
+//   gatilho.txt     uma linha por rajada do gatilho: instante do disparo em us
+//                   e as GATILHO_AMOSTRAS amostras (o simulador rearma em seguida)
+// e no stdout o custo de cada estágio.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim_oled.h"
+#include "agenda.h"
+#include "captura_adc.h"
+#include "gatilho.h"
+#include "ciclos.h"
+#include "neopixel.h"
+#include "partida.h"
+#include "perfil.h"
+#include "registro.h"
+#include "relogio.h"
+#include "ssd1306.h"
+#include "telemetria.h"
+#include "tom.h"
+
+// Funções de setup do ProjetoU7T.c
+void setupCompartilhado();
+void setup();
+void setupBuzzer();
+void setupI2C();
+void setupUsb();
+void setupNucleo1();
+void setupAgenda();
+
+static uint16_t *traco;
+static size_t tamTraco;
+
+static bool carregarTraco(const char *caminho) {
+    FILE *f = fopen(caminho, "rb");
+    if (!f) {
+        return false;
+    }
+    size_t capacidade = 1 << 16;
+    traco = malloc(capacidade * sizeof(uint16_t));
+    tamTraco = 0;
+
+    const char *ext = strrchr(caminho, '.');
+    if (ext && strcmp(ext, ".bin") == 0) {
+        uint8_t b[2];
+        while (fread(b, 1, 2, f) == 2) {
+            if (tamTraco == capacidade) {
+                capacidade *= 2;
+                traco = realloc(traco, capacidade * sizeof(uint16_t));
+            }
+            traco[tamTraco++] = b[0] | (b[1] << 8);
+        }
+    } else {
+        char linha[256];
+        while (fgets(linha, sizeof(linha), f)) {
+            const char *valor = linha;
+            if (strncmp(linha, "amostra,", 8) == 0) {
+                valor = strrchr(linha, ',') + 1;
+            } else if (linha[0] < '0' || linha[0] > '9') {
+                continue; // Comentários, cabeçalhos e outros tipos da telemetria
+            }
+            if (tamTraco == capacidade) {
+                capacidade *= 2;
+                traco = realloc(traco, capacidade * sizeof(uint16_t));
+            }
+            traco[tamTraco++] = strtoul(valor, NULL, 10) & 0x0FFF;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+// Retenção de ordem zero até a taxa da captura
+static void reamostrarTraco(uint32_t taxaTraco, uint32_t taxa) {
+    size_t tam = (uint64_t)tamTraco * taxa / taxaTraco;
+    uint16_t *novo = malloc(tam * sizeof(uint16_t));
+    for (size_t i = 0; i < tam; i++) {
+        novo[i] = traco[(uint64_t)i * taxaTraco / taxa];
+    }
+    free(traco);
+    traco = novo;
+    tamTraco = tam;
+}
+
+// Quadros da varredura: uma cópia da amostra por antena, na ordem dos canais
+#define LEITURA_27C 876 // 0,706 V
+static void entrelacarTraco(uint8_t mascara, uint8_t numCanais) {
+    uint16_t *novo = malloc(tamTraco * numCanais * sizeof(uint16_t));
+    for (size_t i = 0; i < tamTraco; i++) {
+        uint8_t k = 0;
+        for (uint8_t canal = 0; canal < CAPTURA_CANAIS_MAX; canal++) {
+            if (mascara & (1u << canal)) {
+                novo[i * numCanais + k++] = canal == CAPTURA_CANAL_TEMPERATURA ? LEITURA_27C : traco[i];
+            }
+        }
+    }
+    free(traco);
+    traco = novo;
+    tamTraco *= numCanais;
+}
+
+static FILE *abrirSaida(const char *dir, const char *nome, const char *modo) {
+    char caminho[1024];
+    snprintf(caminho, sizeof(caminho), "%s/%s", dir, nome);
+    FILE *f = fopen(caminho, modo);
+    if (!f) {
+        perror(caminho);
+        exit(1);
+    }
+    return f;
+}
+
+static FILE *arqOled, *arqMatriz, *arqBuzzer, *arqGatilho;
+static uint32_t quadrosMatriz = 0;
+static uint32_t mudancasBuzzer = 0;
+
+// Registra o que mudou nas saídas desde a última chamada
+static void registrarSaidas() {
+    uint64_t agora = agendaAgora();
+    simOledDump(arqOled, agora);
+
+    static NpQuadro ultimoQuadro;
+    const NpQuadro *quadro = npQuadroFrente();
+    if (memcmp(quadro, &ultimoQuadro, sizeof(NpQuadro)) != 0) {
+        ultimoQuadro = *quadro;
+        quadrosMatriz++;
+        fprintf(arqMatriz, "%llu", (unsigned long long)agora);
+        for (int i = 0; i < LED_COUNT; i++) {
+            fprintf(arqMatriz, " %06lx", (unsigned long)(quadro->grb[i] >> 8));
+        }
+        fprintf(arqMatriz, "\n");
+    }
+
+    static TomEstado ultimoTom;
+    TomEstado tom = tomEstado();
+    if (tom.freq != ultimoTom.freq || tom.nivel != ultimoTom.nivel) {
+        ultimoTom = tom;
+        mudancasBuzzer++;
+        fprintf(arqBuzzer, "%llu %u %u.%02u %u %u\n", (unsigned long long)agora, tom.freq, tom.pwm.div16 >> 4,
+                (tom.pwm.div16 & 0xF) * 100 / 16, tom.pwm.wrap, tom.nivel);
+    }
+
+    if (gatilhoCongelado()) {
+        fprintf(arqGatilho, "%llu", (unsigned long long)gatilhoInstante());
+        for (uint32_t i = 0; i < GATILHO_AMOSTRAS; i++) {
+            fprintf(arqGatilho, " %u", gatilhoAmostra(i));
+        }
+        fprintf(arqGatilho, "\n");
+        gatilhoLiberar();
+    }
+}
+
+// Faz o papel do temporizador do tom
+static void tarefaTom(uint64_t agora, void *ctx) {
+    tomPasso();
+}
+
+static void imprimirPerfil(const char *linha, void *ctx) {
+    printf("  %s\n", linha);
+}
+
+static double segundos(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) + (b->tv_nsec - a->tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s <traço> [diretório de saída] [taxa do traço]\n", argv[0]);
+        return 2;
+    }
+    if (!carregarTraco(argv[1])) {
+        perror(argv[1]);
+        return 1;
+    }
+    const char *dir = argc > 2 ? argv[2] : ".";
+    arqOled = abrirSaida(dir, "oled.txt", "w");
+    arqMatriz = abrirSaida(dir, "matriz.txt", "w");
+    arqBuzzer = abrirSaida(dir, "buzzer.txt", "w");
+    arqGatilho = abrirSaida(dir, "gatilho.txt", "w");
+    FILE *arqTelemetria = abrirSaida(dir, "telemetria.bin", "wb");
+    telemetriaSaida(arqTelemetria);
+
+    // Mesma sequência do main() do firmware
+    SSD1306_set_transport(&simOledTransporte);
+    agendaInit(); // Relógio virtual já valendo para o sleep_ms do splash
+    setupCompartilhado();
+    setupNucleo1();
+    setup();
+    setupBuzzer();
+    setupI2C();
+    setupUsb();
+    setupAgenda();
+    agendaAdicionar("tom(sim)", TOM_PASSO_US, 0, tarefaTom, NULL);
+
+    uint32_t taxa = capturaTaxa();
+    uint32_t taxaTraco = argc > 3 ? strtoul(argv[3], NULL, 10) : taxa;
+    if (taxaTraco && taxaTraco != taxa) {
+        reamostrarTraco(taxaTraco, taxa);
+    }
+    uint8_t numCanais = capturaNumCanais();
+    if (numCanais > 1) {
+        entrelacarTraco(capturaCanais(), numCanais);
+    }
+    size_t tamBloco = capturaTamBloco();
+    uint32_t taxaAdc = taxa * numCanais;
+    uint64_t inicio = agendaAgora();
+    uint64_t nucleo1Total = 0;
+    uint32_t nucleo1Max = 0;
+    uint32_t blocos = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (size_t pos = 0; pos + tamBloco <= tamTraco; pos += tamBloco) {
+        // O bloco só existe depois que a última amostra dele foi convertida
+        uint64_t pronto = inicio + (uint64_t)(pos + tamBloco) * 1000000 / taxaAdc;
+        while (agendaAgora() < pronto) {
+            agendaExecutar();
+            registrarSaidas();
+        }
+
+        capturaSinteticaAlimentar(&traco[pos], tamBloco);
+        uint32_t c = ciclosAgora();
+        blocos += capturaPoll(); // Núcleo 1: detector e telemetria das amostras
+        uint32_t custo = ciclosDesde(c);
+        nucleo1Total += custo;
+        if (custo > nucleo1Max) {
+            nucleo1Max = custo;
+        }
+    }
+
+    telemetriaResultadosFim(); // O fim do traço não espera a idade do pacote parcial
+    telemetriaEnviar(agendaAgora());
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double virtual = (agendaAgora() - inicio) / 1e6;
+    double real = segundos(&t0, &t1);
+
+    printf("Traço: %zu amostras a %lu Hz, %.1f s simulados em %.3f s (%.0fx o tempo real)\n", tamTraco / numCanais,
+           (unsigned long)taxa, virtual, real, real > 0 ? virtual / real : 0);
+    printf("Núcleo 1 (CIC + detector + telemetria): %lu blocos, %.1f us/bloco em média, %.1f us no pior\n",
+           (unsigned long)blocos, blocos ? nucleo1Total / 1000.0 / blocos : 0, nucleo1Max / 1000.0);
+    printf("Núcleo 0, custo de host por tarefa:\n");
+    for (uint32_t i = 0; i < agendaNumTarefas(); i++) {
+        const AgendaTarefa *t = agendaTarefa(i);
+        printf("  %-12s %7lu execuções, pior %.1f us\n", t->nome, (unsigned long)t->execucoes, t->ciclosMax / 1000.0);
+    }
+
+    CapturaStats cap;
+    capturaGetStats(&cap);
+    TelemetriaStats tel;
+    telemetriaGetStats(&tel);
+    RegistroStats reg;
+    registroGetStats(&reg);
+    printf("OLED: %lu transferências, %lu bytes no barramento\n", (unsigned long)simOledQuadros(),
+           (unsigned long)simOledBytes());
+    printf("Matriz: %lu quadros; buzzer: %lu mudanças de tom\n", (unsigned long)quadrosMatriz,
+           (unsigned long)mudancasBuzzer);
+    GatilhoStats gat;
+    gatilhoGetStats(&gat);
+    printf("Gatilho: %lu disparos; %.2f ns/amostra no último bloco, %.1f us no pior bloco\n",
+           (unsigned long)gat.disparos, gat.amostrasUltimo ? (double)gat.ciclosUltimo / gat.amostrasUltimo : 0,
+           gat.ciclosMax / 1000.0);
+    printf("Telemetria: %lu quadros, %lu bytes, %lu pacotes descartados\n", (unsigned long)tel.quadros,
+           (unsigned long)tel.bytes, (unsigned long)tel.descartados);
+    printf("Registro: %lu registros, %lu páginas gravadas; captura: %lu overruns\n", (unsigned long)reg.gravados,
+           (unsigned long)reg.paginasGravadas, (unsigned long)cap.overruns);
+
+    printf("Partida (us no relógio virtual):\n");
+    partidaRelatorio(imprimirPerfil, NULL);
+
+    printf("Modos de clock (troca simulada, sem mudar o custo do host):\n");
+    relogioRelatorio(imprimirPerfil, NULL);
+
+#if PERFIL_HABILITADO
+    printf("Perfil (ns no host):\n");
+    perfilDespejar(imprimirPerfil, NULL);
+#endif
+
+    fclose(arqOled);
+    fclose(arqMatriz);
+    fclose(arqBuzzer);
+    fclose(arqTelemetria);
+    free(traco);
+    return 0;
+}
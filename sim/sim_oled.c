@@ -0,0 +1,142 @@
+#include <string.h>
+#include "sim_oled.h"
+
+static uint8_t ram[SSD1306_BUF_LEN];
+static uint8_t ultimoDump[SSD1306_BUF_LEN];
+static bool dumpFeito = false;
+static uint32_t bytes = 0;
+static uint32_t quadros = 0;
+
+// Ponteiros do modo de endereçamento horizontal
+static uint8_t colInicio = 0, colFim = SSD1306_WIDTH - 1;
+static uint8_t pagInicio = 0, pagFim = SSD1306_NUM_PAGES - 1;
+static uint8_t col = 0, pag = 0;
+
+// Bytes de argumento de cada comando que tem argumentos
+static int argumentos(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    case 0x2C: case 0x2D:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+// Rolagem de conteúdo de uma coluna. Com o remapeamento de segmentos que o
+// driver usa, 2Ch anda para o lado das colunas menores.
+static void rolarColuna(bool paraMenores, uint8_t p0, uint8_t p1, uint8_t c0, uint8_t c1) {
+    for (int p = p0; p <= p1 && p < SSD1306_NUM_PAGES; p++) {
+        uint8_t *linha = &ram[p * SSD1306_WIDTH];
+        if (paraMenores) {
+            uint8_t saiu = linha[c0];
+            memmove(&linha[c0], &linha[c0 + 1], c1 - c0);
+            linha[c1] = saiu;
+        } else {
+            uint8_t saiu = linha[c1];
+            memmove(&linha[c0 + 1], &linha[c0], c1 - c0);
+            linha[c0] = saiu;
+        }
+    }
+}
+
+static void comando(const uint8_t *c) {
+    switch (c[0]) {
+    case 0x21:
+        colInicio = col = c[1] & 0x7F;
+        colFim = c[2] & 0x7F;
+        break;
+    case 0x22:
+        pagInicio = pag = c[1] & 0x07;
+        pagFim = c[2] & 0x07;
+        break;
+    case 0x2C:
+    case 0x2D:
+        rolarColuna(c[0] == 0x2C, c[2], c[4], c[6], c[7]);
+        break;
+    }
+}
+
+static void dado(uint8_t b) {
+    if (pag < SSD1306_NUM_PAGES) {
+        ram[pag * SSD1306_WIDTH + col] = b;
+    }
+    if (col++ == colFim) {
+        col = colInicio;
+        pag = pag == pagFim ? pagInicio : pag + 1;
+    }
+}
+
+static void iniciar(const uint32_t *palavras, int n) {
+    int i = 0;
+    while (i < n) {
+        // Uma transação: byte de controle até o bit de STOP
+        uint8_t controle = palavras[i] & 0xFF;
+        bool fim = palavras[i++] & I2C_IC_DATA_CMD_STOP_BITS;
+        uint8_t cmd[8];
+        int nCmd = 0;
+        while (!fim && i < n) {
+            uint8_t b = palavras[i] & 0xFF;
+            fim = palavras[i++] & I2C_IC_DATA_CMD_STOP_BITS;
+            bytes++;
+            if (controle == 0x40) {
+                dado(b);
+                continue;
+            }
+            cmd[nCmd++] = b;
+            if (nCmd == 1 + argumentos(cmd[0])) {
+                comando(cmd);
+                nCmd = 0;
+            }
+        }
+        bytes++; // Byte de controle
+    }
+    quadros++;
+}
+
+static bool ocupado(void) {
+    return false;
+}
+
+const struct ssd1306_transport simOledTransporte = {
+    .start = iniciar,
+    .busy = ocupado,
+};
+
+const uint8_t *simOledRam() {
+    return ram;
+}
+
+uint32_t simOledBytes() {
+    return bytes;
+}
+
+uint32_t simOledQuadros() {
+    return quadros;
+}
+
+bool simOledDump(FILE *f, uint64_t instante) {
+    if (dumpFeito && memcmp(ram, ultimoDump, sizeof(ram)) == 0) {
+        return false;
+    }
+    memcpy(ultimoDump, ram, sizeof(ram));
+    dumpFeito = true;
+
+    fprintf(f, "# t=%llu\n", (unsigned long long)instante);
+    for (int y = 0; y < SSD1306_HEIGHT; y++) {
+        char linha[SSD1306_WIDTH + 1];
+        for (int x = 0; x < SSD1306_WIDTH; x++) {
+            linha[x] = (ram[(y / 8) * SSD1306_WIDTH + x] >> (y % 8)) & 1 ? '#' : '.';
+        }
+        linha[SSD1306_WIDTH] = 0;
+        fprintf(f, "%s\n", linha);
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+#ifndef SIM_OLED_H
+#define SIM_OLED_H
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "ssd1306_i2c.h"
+
+// Emulação do SSD1306 do lado do barramento: interpreta as palavras
+// IC_DATA_CMD que o driver entrega ao transporte (comandos de endereço, dados
+// em modo horizontal e a rolagem de uma coluna) e mantém a RAM do display.
+
+// Transporte para SSD1306_set_transport(): cada quadro é aplicado na hora
+extern const struct ssd1306_transport simOledTransporte;
+
+const uint8_t *simOledRam();      // SSD1306_BUF_LEN bytes, no layout do framebuffer
+uint32_t simOledBytes();          // Bytes que passaram pelo barramento
+uint32_t simOledQuadros();
+
+// Escreve a RAM como arte ASCII ('#' aceso) se ela mudou desde o último dump
+bool simOledDump(FILE *f, uint64_t instante);
+
+#endif
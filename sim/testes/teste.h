@@ -0,0 +1,29 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+// Verificação mínima dos testes de host (ctest). Um CONFERIR que falha
+// imprime o arquivo, a linha e a mensagem e o teste segue, para mostrar todas
+// as falhas de uma vez; main() termina com 'return testeResultado();'.
+
+#include <stdio.h>
+
+static int testeFalhas = 0;
+
+#define CONFERIR(cond, ...)                                                     \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            testeFalhas++;                                                      \
+            fprintf(stderr, "%s:%d: falhou: %s: ", __FILE__, __LINE__, #cond);  \
+            fprintf(stderr, __VA_ARGS__);                                       \
+            fputc('\n', stderr);                                                \
+        }                                                                       \
+    } while (0)
+
+static inline int testeResultado() {
+    if (testeFalhas) {
+        fprintf(stderr, "%d verificações falharam\n", testeFalhas);
+    }
+    return testeFalhas ? 1 : 0;
+}
+
+#endif
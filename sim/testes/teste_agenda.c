@@ -0,0 +1,146 @@
+// Escalonador no relógio virtual do host: liberações na grade de cada período,
+// ordem por prazo mais próximo, atraso que não acumula, liberações perdidas e
+// prazos estourados contados, e o tempo ocioso dormindo até a próxima
+// liberação.
+
+#include "agenda.h"
+#include "teste.h"
+
+#define MAX_EXECUCOES 1000
+
+typedef struct {
+    char letra;           // Como aparece em 'ordem'
+    uint32_t custo;       // us consumidos por execução
+    uint32_t custoExtra;  // Consumido só na execução 'execucaoExtra'
+    uint32_t execucaoExtra;
+    uint32_t n;
+    uint64_t inicios[MAX_EXECUCOES];
+} Tarefa;
+
+static char ordem[MAX_EXECUCOES];
+static uint32_t nOrdem;
+
+static void rodar(uint64_t agora, void *ctx) {
+    Tarefa *t = ctx;
+    uint32_t custo = t->custo + (t->n == t->execucaoExtra ? t->custoExtra : 0);
+    if (t->n < MAX_EXECUCOES) {
+        t->inicios[t->n] = agora;
+    }
+    t->n++;
+    if (nOrdem < MAX_EXECUCOES) {
+        ordem[nOrdem++] = t->letra;
+    }
+    agendaConsumir(custo);
+}
+
+static void iniciar() {
+    agendaDefinirRelogio(0);
+    agendaInit();
+    nOrdem = 0;
+}
+
+static void executarAte(uint64_t fim) {
+    while (agendaAgora() < fim) {
+        agendaExecutar();
+    }
+}
+
+static void conferirGrade() {
+    iniciar();
+    static Tarefa a = {'a', .custo = 100, .execucaoExtra = UINT32_MAX};
+    static Tarefa b = {'b', .custo = 200, .execucaoExtra = UINT32_MAX};
+    int ia = agendaAdicionar("a", 1000, 0, rodar, &a);
+    int ib = agendaAdicionar("b", 3000, 0, rodar, &b);
+    AgendaStats stats;
+    agendaGetStats(&stats);
+    executarAte(30000);
+
+    CONFERIR(a.n == 30 && b.n == 10, "execuções: a %u, b %u", a.n, b.n);
+    // Quem sai atrás no empate começa depois do custo do outro, mas na grade
+    for (uint32_t i = 0; i < a.n; i++) {
+        CONFERIR(a.inicios[i] - i * 1000 <= 200, "a %u começou em %llu", i, (unsigned long long)a.inicios[i]);
+    }
+    for (uint32_t i = 0; i < b.n; i++) {
+        CONFERIR(b.inicios[i] - i * 3000 <= 100, "b %u começou em %llu", i, (unsigned long long)b.inicios[i]);
+    }
+    const AgendaTarefa *ta = agendaTarefa(ia), *tb = agendaTarefa(ib);
+    CONFERIR(ta->perdidos == 0 && tb->perdidos == 0 && ta->prazosPerdidos == 0 && tb->prazosPerdidos == 0,
+             "perdas sem sobrecarga");
+    CONFERIR(ta->duracaoMax == 100 && tb->duracaoMax == 200, "durações %u e %u", ta->duracaoMax, tb->duracaoMax);
+
+    // Ocupação: 30 x 100 + 10 x 200 us em 30 ms
+    agendaGetStats(&stats);
+    CONFERIR(stats.ociosoPorMil == (30000 - 5000) * 1000 / 30000, "ocioso %u por mil", stats.ociosoPorMil);
+    CONFERIR(stats.despertares > 0 && stats.despertares <= 30, "%u despertares", stats.despertares);
+}
+
+// Liberadas juntas: roda primeiro a de prazo absoluto mais próximo, qualquer
+// que seja a ordem de cadastro
+static void conferirPrazo() {
+    iniciar();
+    static Tarefa longa = {'L', .custo = 10, .execucaoExtra = UINT32_MAX};
+    static Tarefa curta = {'C', .custo = 10, .execucaoExtra = UINT32_MAX};
+    static Tarefa media = {'M', .custo = 10, .execucaoExtra = UINT32_MAX};
+    agendaAdicionar("longa", 10000, 9000, rodar, &longa);
+    agendaAdicionar("curta", 10000, 1000, rodar, &curta);
+    agendaAdicionar("media", 10000, 5000, rodar, &media);
+    executarAte(25000);
+    CONFERIR(nOrdem == 9, "%u execuções", nOrdem);
+    for (uint32_t i = 0; i + 2 < nOrdem; i += 3) {
+        CONFERIR(ordem[i] == 'C' && ordem[i + 1] == 'M' && ordem[i + 2] == 'L', "ordem na liberação %u: %.3s", i / 3,
+                 &ordem[i]);
+    }
+}
+
+// Uma execução que passa do período: o atraso não empurra a grade, as
+// liberações puladas inteiras são contadas e o prazo estourado também
+static void conferirSobrecarga() {
+    iniciar();
+    static Tarefa a = {'a', .custo = 100, .custoExtra = 3400, .execucaoExtra = 5};
+    static Tarefa b = {'b', .custo = 50, .execucaoExtra = UINT32_MAX};
+    int ia = agendaAdicionar("a", 1000, 0, rodar, &a);
+    int ib = agendaAdicionar("b", 500, 400, rodar, &b);
+    executarAte(20000);
+
+    const AgendaTarefa *ta = agendaTarefa(ia), *tb = agendaTarefa(ib);
+    // A execução 5 começa por volta de 5000 e termina em 8500: 6000 e 7000
+    // passaram inteiras e a de 8000 roda atrasada
+    CONFERIR(ta->perdidos == 2, "a perdeu %u liberações", ta->perdidos);
+    CONFERIR(ta->prazosPerdidos == 1, "a estourou %u prazos", ta->prazosPerdidos);
+    CONFERIR(a.inicios[6] >= 8500 && a.inicios[6] < 9100, "a voltou em %llu", (unsigned long long)a.inicios[6]);
+    for (uint32_t i = 7; i < a.n; i++) {
+        CONFERIR(a.inicios[i] % 1000 <= 100, "a %u fora da grade: %llu", i, (unsigned long long)a.inicios[i]);
+    }
+    CONFERIR(ta->duracaoMax == 3500, "a durou %u", ta->duracaoMax);
+    // b ficou esperando a execução longa de a: atraso e prazo perdidos
+    CONFERIR(tb->atrasoMax >= 3000 && tb->prazosPerdidos >= 1 && tb->perdidos >= 5,
+             "b: atraso %u, %u prazos, %u perdidas", tb->atrasoMax, tb->prazosPerdidos, tb->perdidos);
+    CONFERIR(b.inicios[b.n - 1] % 500 <= 100, "b fora da grade no fim");
+}
+
+static void conferirLimites() {
+    iniciar();
+    static Tarefa t = {'t', .custo = 1, .execucaoExtra = UINT32_MAX};
+    CONFERIR(agendaAdicionar("zero", 0, 0, rodar, &t) == -1, "período 0 aceito");
+    for (int i = 0; i < AGENDA_MAX_TAREFAS; i++) {
+        CONFERIR(agendaAdicionar("t", 1000 + i, 0, rodar, &t) == i, "tarefa %d recusada", i);
+    }
+    CONFERIR(agendaAdicionar("demais", 1000, 0, rodar, &t) == -1, "tarefa além do máximo aceita");
+    CONFERIR(agendaNumTarefas() == AGENDA_MAX_TAREFAS && agendaTarefa(AGENDA_MAX_TAREFAS) == NULL &&
+                 agendaTarefa(-1) == NULL,
+             "índices fora da tabela");
+    CONFERIR(agendaTarefa(0)->prazo == 1000, "prazo 0 não virou o período");
+
+    // Sem tarefas agendaExecutar() volta sem dormir
+    iniciar();
+    agendaExecutar();
+    CONFERIR(agendaAgora() == 0, "relógio andou sem tarefas");
+}
+
+int main() {
+    conferirGrade();
+    conferirPrazo();
+    conferirSobrecarga();
+    conferirLimites();
+    return testeResultado();
+}
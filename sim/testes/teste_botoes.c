@@ -0,0 +1,132 @@
+// Gestos dos botões no relógio virtual do host: clique, repetição e pressão
+// longa com trepidação nas bordas; e, com o laço principal parado enquanto um
+// botão trepida, a fila de bordas enche e perde a última, a que solta o botão.
+// Ele tem que soltar mesmo assim (sem repetir nem virar pressão longa) e as
+// bordas perdidas têm que aparecer na contagem.
+
+#include "botoes.h"
+#include "teste.h"
+
+#define BOTAO_A 5  // Com repetição
+#define BOTAO_B 6  // Sem repetição, com pressão longa
+#define PASSO_US 10000
+
+static uint32_t cliques[32], repeticoes[32], longos[32];
+
+static void evento(uint8_t gpio, BotaoEvento e) {
+    switch (e) {
+    case BOTAO_CLIQUE:
+        cliques[gpio]++;
+        break;
+    case BOTAO_REPETICAO:
+        repeticoes[gpio]++;
+        break;
+    case BOTAO_LONGO:
+        longos[gpio]++;
+        break;
+    }
+}
+
+static void zerar() {
+    for (int i = 0; i < 32; i++) {
+        cliques[i] = repeticoes[i] = longos[i] = 0;
+    }
+}
+
+// Laço principal de 'inicio' a 'fim', a cada PASSO_US
+static uint64_t processar(uint64_t inicio, uint64_t fim) {
+    for (uint64_t t = inicio; t <= fim; t += PASSO_US) {
+        botoesProcessar(t, evento);
+    }
+    return fim;
+}
+
+// 'n' bordas a cada 300 us a partir de 't', alternando a partir de 'primeiro';
+// devolve o instante da última
+static uint64_t trepidar(uint8_t gpio, bool primeiro, int n, uint64_t t) {
+    bool nivel = primeiro;
+    for (int i = 0; i < n; i++, t += 300) {
+        botoesInjetarBorda(gpio, nivel, t);
+        nivel = !nivel;
+    }
+    return t - 300;
+}
+
+static void conferirGestos() {
+    // Clique curto em A: um clique ao pressionar, nada ao soltar
+    zerar();
+    uint64_t t = trepidar(BOTAO_A, false, 5, 100000);
+    t = processar(t, t + 100000);
+    t = trepidar(BOTAO_A, true, 5, t);
+    t = processar(t, t + 1000000);
+    CONFERIR(cliques[BOTAO_A] == 1 && repeticoes[BOTAO_A] == 0, "A curto: %u cliques, %u repetições",
+             cliques[BOTAO_A], repeticoes[BOTAO_A]);
+
+    // A segurado por 1,2 s: repete a partir de 0,5 s, a cada 0,15 s
+    zerar();
+    uint64_t pressao = trepidar(BOTAO_A, false, 5, t);
+    t = processar(pressao, pressao + 1200000);
+    botoesInjetarBorda(BOTAO_A, true, t);
+    t = processar(t, t + 500000);
+    uint32_t esperadas = (1200000 - BOTAO_REPETICAO_INICIO_US) / BOTAO_REPETICAO_US + 1;
+    CONFERIR(cliques[BOTAO_A] == 1 && repeticoes[BOTAO_A] == esperadas, "A segurado: %u cliques, %u repetições (%u)",
+             cliques[BOTAO_A], repeticoes[BOTAO_A], esperadas);
+
+    // B: clique ao soltar antes da pressão longa; depois, uma pressão longa
+    zerar();
+    t = trepidar(BOTAO_B, false, 3, t);
+    t = processar(t, t + 300000);
+    CONFERIR(cliques[BOTAO_B] == 0, "B: clique antes de soltar");
+    t = trepidar(BOTAO_B, true, 3, t);
+    t = processar(t, t + 100000);
+    t = trepidar(BOTAO_B, false, 3, t);
+    t = processar(t, t + 1500000);
+    t = trepidar(BOTAO_B, true, 3, t);
+    t = processar(t, t + 100000);
+    CONFERIR(cliques[BOTAO_B] == 1 && longos[BOTAO_B] == 1, "B: %u cliques, %u pressões longas", cliques[BOTAO_B],
+             longos[BOTAO_B]);
+}
+
+// Botão pressionado e aceito; o laço para e o botão solta trepidando mais
+// bordas do que a fila guarda. A última borda guardada é de pressão
+static uint64_t soltarComFilaCheia(uint8_t gpio, uint64_t t) {
+    t = trepidar(gpio, false, 1, t);
+    t = processar(t, t + 100000);
+    t = trepidar(gpio, true, 41, t + 1000);
+    return processar(t + 50000, t + 2000000);
+}
+
+static void conferirFilaCheia() {
+    uint32_t perdidos = botoesEventosPerdidos();
+    zerar();
+    uint64_t t = soltarComFilaCheia(BOTAO_A, 20000000);
+    // Uma repetição pode sair antes do laço perceber a soltura; depois, nenhuma
+    uint32_t repeticoes0 = repeticoes[BOTAO_A];
+    t = processar(t, t + 1000000);
+    CONFERIR(repeticoes[BOTAO_A] == repeticoes0 && repeticoes0 <= 1, "A ficou preso: %u repetições",
+             repeticoes[BOTAO_A]);
+
+    zerar();
+    t = soltarComFilaCheia(BOTAO_B, t + 1000000);
+    CONFERIR(cliques[BOTAO_B] == 1 && longos[BOTAO_B] == 0, "B ficou preso: %u cliques, %u pressões longas",
+             cliques[BOTAO_B], longos[BOTAO_B]);
+
+    // Depois disso os dois seguem funcionando normalmente
+    zerar();
+    t = trepidar(BOTAO_A, false, 3, t);
+    t = processar(t, t + 100000);
+    t = trepidar(BOTAO_A, true, 3, t);
+    processar(t, t + 1000000);
+    CONFERIR(cliques[BOTAO_A] == 1 && repeticoes[BOTAO_A] == 0, "A depois da fila cheia: %u cliques, %u repetições",
+             cliques[BOTAO_A], repeticoes[BOTAO_A]);
+    printf("%u bordas perdidas com a fila cheia\n", botoesEventosPerdidos() - perdidos);
+    CONFERIR(botoesEventosPerdidos() > perdidos, "nenhuma borda perdida contada");
+}
+
+int main() {
+    botoesAdicionar(BOTAO_A, true);
+    botoesAdicionar(BOTAO_B, false);
+    conferirGestos();
+    conferirFilaCheia();
+    return testeResultado();
+}
@@ -0,0 +1,97 @@
+// Calibração com um piso de ruído que deriva: 30 min de janelas (10/s) com o
+// offset subindo de 40 para 400 contagens e voltando, ruído uniforme por cima
+// e rajadas de campo de 3 s a cada minuto. Confere que o piso acompanha a
+// deriva, que o campo liga em todas as rajadas e só nelas, sem flicker, e
+// compara com o limiar fixo antigo (ADC_THRESHOLD = 60).
+
+#include <stdlib.h>
+#include "calibracao.h"
+#include "teste.h"
+
+#define JANELAS_POR_SEG 10
+#define DURACAO (30 * 60 * JANELAS_POR_SEG)
+#define PERIODO_RAJADA (60 * JANELAS_POR_SEG)
+#define DURACAO_RAJADA (3 * JANELAS_POR_SEG)
+#define CAMPO 900
+#define RUIDO 15
+#define LIMIAR_ANTIGO 60
+
+static uint32_t semente = 99;
+static int ruidoUniforme(int amplitude) {
+    semente = semente * 1103515245u + 12345u;
+    return (int)((semente >> 8) % (2 * amplitude + 1)) - amplitude;
+}
+
+// Sobe em triângulo de 40 a 400 e volta, ao longo dos 30 min
+static int offsetEm(int janela) {
+    int meio = DURACAO / 2;
+    int d = janela < meio ? janela : DURACAO - janela;
+    return 40 + 360 * d / meio;
+}
+
+static bool emRajada(int janela) {
+    return janela % PERIODO_RAJADA >= PERIODO_RAJADA - DURACAO_RAJADA;
+}
+
+int main() {
+    Calibrador c;
+    calibradorInit(&c, LIMIAR_ANTIGO, 4000); // Como no firmware
+
+    int acomodacao = 30 * JANELAS_POR_SEG; // O ruído estimado parte de zero
+    int falsosAtivos = 0, janelasSemCampo = 0, falsosAntigo = 0;
+    int rajadas = 0, rajadasDetectadas = 0, janelasRajada = 0, ativasRajada = 0;
+    int erroPisoMax = 0;
+    uint16_t saidaMin = 4095, saidaMax = 0;
+    uint32_t transicoesInicio = 0;
+
+    for (int j = 0; j < DURACAO; j++) {
+        int offset = offsetEm(j);
+        bool rajada = emRajada(j);
+        int x = offset + ruidoUniforme(RUIDO) + (rajada ? CAMPO : 0);
+        uint16_t saida = calibradorAplicar(&c, x);
+        if (j == acomodacao) {
+            transicoesInicio = c.transicoes;
+        }
+        if (j < acomodacao) {
+            continue;
+        }
+
+        if (!rajada) {
+            janelasSemCampo++;
+            falsosAtivos += saida != 0;
+            falsosAntigo += x >= LIMIAR_ANTIGO;
+            // Depois do fim de uma rajada o piso já não deve ter sido puxado
+            int erro = abs((int)calibradorPiso(&c) - offset);
+            erroPisoMax = erro > erroPisoMax ? erro : erroPisoMax;
+        } else {
+            janelasRajada++;
+            ativasRajada += saida != 0;
+            if (saida) {
+                saidaMin = saida < saidaMin ? saida : saidaMin;
+                saidaMax = saida > saidaMax ? saida : saidaMax;
+            }
+            if (!emRajada(j + 1)) {
+                rajadas++;
+                rajadasDetectadas += c.ativo;
+            }
+        }
+    }
+
+    uint32_t transicoes = c.transicoes - transicoesInicio;
+    printf("janelas sem campo ativas: %d de %d (limiar fixo: %d)\n", falsosAtivos, janelasSemCampo, falsosAntigo);
+    printf("janelas de rajada ativas: %d de %d, %d de %d rajadas\n", ativasRajada, janelasRajada, rajadasDetectadas,
+           rajadas);
+    printf("transições: %u, erro máximo do piso: %d, saída na rajada: %u a %u\n", transicoes, erroPisoMax, saidaMin,
+           saidaMax);
+
+    CONFERIR(falsosAtivos * 1000 <= janelasSemCampo, "%d janelas sem campo ativas", falsosAtivos);
+    CONFERIR(falsosAntigo > janelasSemCampo / 2, "o limiar fixo deveria disparar com o offset alto");
+    CONFERIR(rajadasDetectadas == rajadas, "%d de %d rajadas detectadas", rajadasDetectadas, rajadas);
+    CONFERIR(ativasRajada * 100 >= janelasRajada * 95, "só %d de %d janelas de rajada ativas", ativasRajada,
+             janelasRajada);
+    CONFERIR(transicoes <= 2 * (uint32_t)rajadas + 4, "%u transições para %d rajadas", transicoes, rajadas);
+    CONFERIR(erroPisoMax <= 3 * RUIDO, "piso a %d contagens do offset", erroPisoMax);
+    // O teto acompanha a fonte mais forte: a rajada ocupa o alto da escala
+    CONFERIR(saidaMin >= 2048, "saída na rajada de %u a %u", saidaMin, saidaMax);
+    return testeResultado();
+}
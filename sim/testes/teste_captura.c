@@ -0,0 +1,102 @@
+// Captura com a fonte sintética do host: blocos entregues em ordem, com as
+// amostras certas, e overruns contados quando o consumidor atrasa.
+
+#include <string.h>
+#include "captura_adc.h"
+#include "teste.h"
+
+static uint16_t valorAmostra(uint32_t indice) {
+    return (indice * 7 + indice / 256) & 0xFFF;
+}
+
+static uint32_t entregues;
+static uint32_t ultimoSeq;
+static uint32_t proximaAmostra; // Índice da primeira amostra do próximo bloco esperado
+static bool conteudoOk;
+
+static void receber(const uint16_t *amostras, size_t n, uint32_t seq, void *ctx) {
+    size_t tamBloco = *(const size_t *)ctx;
+    CONFERIR(n == tamBloco, "bloco de %zu amostras", n);
+    CONFERIR(entregues == 0 || seq > ultimoSeq, "seq %u depois de %u", seq, ultimoSeq);
+    proximaAmostra = seq * tamBloco;
+    for (size_t i = 0; i < n; i++) {
+        if (amostras[i] != valorAmostra(proximaAmostra + i)) {
+            conteudoOk = false;
+        }
+    }
+    ultimoSeq = seq;
+    entregues++;
+}
+
+// Alimenta 'blocos' blocos inteiros a partir do bloco 'primeiro', em pedaços
+// de tamanho irregular como os de um traço
+static void alimentar(uint32_t primeiro, uint32_t blocos, size_t tamBloco) {
+    static uint16_t buf[CAPTURA_TAM_BLOCO * 16];
+    size_t total = blocos * tamBloco;
+    for (size_t i = 0; i < total; i++) {
+        buf[i] = valorAmostra(primeiro * tamBloco + i);
+    }
+    for (size_t pos = 0; pos < total;) {
+        size_t pedaco = 1 + (pos * 31) % 97;
+        if (pedaco > total - pos) {
+            pedaco = total - pos;
+        }
+        capturaSinteticaAlimentar(&buf[pos], pedaco);
+        pos += pedaco;
+    }
+}
+
+static void testeUmCanal() {
+    size_t tamBloco;
+    CONFERIR(capturaInit(2, 160000) == 160000, "taxa de um canal");
+    tamBloco = capturaTamBloco();
+    CONFERIR(tamBloco == CAPTURA_TAM_BLOCO, "tamanho do bloco %zu", tamBloco);
+    capturaSetCallback(receber, &tamBloco);
+    capturaStart();
+    entregues = 0;
+    conteudoOk = true;
+
+    // Consumidor em dia: cada bloco sai no poll seguinte
+    for (uint32_t b = 0; b < 20; b++) {
+        alimentar(b, 1, tamBloco);
+        CONFERIR(capturaPoll() == 1, "bloco %u não entregue", b);
+    }
+    CapturaStats s;
+    capturaGetStats(&s);
+    CONFERIR(entregues == 20 && s.blocosEntregues == 20 && s.overruns == 0, "%u entregues, %u overruns", entregues,
+             s.overruns);
+    CONFERIR(conteudoOk, "amostras diferentes do que foi alimentado");
+
+    // Consumidor parado por 12 blocos: 2 blocos ficam no DMA e os outros 6 do
+    // anel enchem a fila de prontos; os 6 seguintes são descartados
+    alimentar(20, 12, tamBloco);
+    capturaGetStats(&s);
+    CONFERIR(s.overruns == 6, "%u overruns com o consumidor parado", s.overruns);
+    CONFERIR(capturaPoll() == CAPTURA_NUM_BLOCOS - 2, "blocos guardados durante o atraso");
+    CONFERIR(ultimoSeq == 25, "último bloco guardado é o %u", ultimoSeq);
+
+    // O próximo bloco entregue tem a sequência do DMA: o salto mostra a perda
+    alimentar(32, 1, tamBloco);
+    CONFERIR(capturaPoll() == 1, "bloco depois do atraso");
+    CONFERIR(ultimoSeq == 32, "seq %u depois do atraso", ultimoSeq);
+    CONFERIR(conteudoOk, "amostras diferentes do que foi alimentado");
+    capturaGetStats(&s);
+    CONFERIR(s.blocosCompletos == 33, "%u blocos completos", s.blocosCompletos);
+    capturaStop();
+}
+
+static void testeVariosCanais() {
+    CONFERIR(capturaInitCanais(0x07, 160000) == 160000, "três canais a 160 kS/s");
+    CONFERIR(capturaNumCanais() == 3, "%u canais", capturaNumCanais());
+    CONFERIR(capturaTamBloco() == 255, "bloco de %zu amostras com 3 canais", capturaTamBloco());
+    CONFERIR(capturaInitCanais(0x07, CAPTURA_TAXA_MAX / 3 + 1) == 0, "taxa total acima do ADC");
+    CONFERIR(capturaInitCanais(0, 1000) == 0, "máscara vazia");
+    CONFERIR(capturaInitCanais(1u << CAPTURA_CANAIS_MAX, 1000) == 0, "canal inexistente");
+    CONFERIR(capturaInit(CAPTURA_CANAIS_MAX, 1000) == 0, "canal inexistente");
+}
+
+int main() {
+    testeUmCanal();
+    testeVariosCanais();
+    return testeResultado();
+}
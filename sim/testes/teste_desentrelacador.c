@@ -0,0 +1,139 @@
+// Desentrelaçamento da varredura round-robin: sem alinhamento cada canal tem
+// que sair com as suas amostras na ordem; com alinhamento a saída tem que ser
+// igual bit a bit à interpolação de referência, também com a entrada picada
+// em blocos, e um mesmo seno lido pelos N canais (cada um i/N de quadro
+// atrasado) tem que sair dos canais praticamente sobreposto ao canal 0.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "desentrelacador.h"
+#include "teste.h"
+
+#define QUADROS 4000
+
+static uint16_t entrada[QUADROS * DESENTRELACADOR_CANAIS_MAX];
+static uint16_t saida[DESENTRELACADOR_CANAIS_MAX][QUADROS];
+static uint16_t referencia[DESENTRELACADOR_CANAIS_MAX][QUADROS];
+
+// Processa 'quadros' quadros em blocos de tamanho aleatório
+static void processar(Desentrelacador *d, uint8_t canais, size_t quadros) {
+    uint16_t *ponteiros[DESENTRELACADOR_CANAIS_MAX];
+    size_t k = 0;
+    while (k < quadros) {
+        size_t bloco = 1 + rand() % 97;
+        if (k + bloco > quadros) {
+            bloco = quadros - k;
+        }
+        for (uint8_t i = 0; i < canais; i++) {
+            ponteiros[i] = &saida[i][k];
+        }
+        size_t n = desentrelacadorProcessar(d, &entrada[k * canais], bloco * canais, ponteiros);
+        CONFERIR(n == bloco, "%u canais: bloco de %zu quadros devolveu %zu", canais, bloco, n);
+        k += bloco;
+    }
+}
+
+// y[n] = x[n] - (i/N) * (x[n] - x[n-1]) arredondado, com o peso em Q15 e a
+// primeira amostra como sua própria anterior
+static void interpolarReferencia(uint8_t canais, size_t quadros) {
+    for (uint8_t i = 0; i < canais; i++) {
+        double peso = (double)((i << DESENTRELACADOR_FRACAO) / canais) / (1 << DESENTRELACADOR_FRACAO);
+        for (size_t k = 0; k < quadros; k++) {
+            double x = entrada[k * canais + i];
+            double anterior = entrada[(k ? k - 1 : 0) * canais + i];
+            referencia[i][k] = (uint16_t)(x - floor(peso * (x - anterior) + 0.5));
+        }
+    }
+}
+
+static void conferirSeparacao() {
+    for (uint8_t canais = 1; canais <= DESENTRELACADOR_CANAIS_MAX; canais++) {
+        for (size_t j = 0; j < QUADROS * canais; j++) {
+            entrada[j] = rand() & 0x0FFF;
+        }
+        Desentrelacador d;
+        CONFERIR(desentrelacadorInit(&d, canais, false), "%u canais recusados", canais);
+        processar(&d, canais, QUADROS);
+        uint32_t erros = 0;
+        for (uint8_t i = 0; i < canais; i++) {
+            for (size_t k = 0; k < QUADROS; k++) {
+                erros += saida[i][k] != entrada[k * canais + i];
+            }
+        }
+        CONFERIR(erros == 0, "%u canais sem alinhar: %u amostras fora do lugar", canais, erros);
+
+        CONFERIR(desentrelacadorInit(&d, canais, true), "%u canais recusados", canais);
+        processar(&d, canais, QUADROS);
+        interpolarReferencia(canais, QUADROS);
+        erros = 0;
+        for (uint8_t i = 0; i < canais; i++) {
+            erros += memcmp(saida[i], referencia[i], QUADROS * sizeof(uint16_t)) != 0;
+        }
+        CONFERIR(erros == 0, "%u canais alinhados: %u canais diferentes da referência", canais, erros);
+    }
+}
+
+// O mesmo seno em todos os canais, cada um lido 1/N de quadro depois do
+// anterior; devolve o maior desvio de um canal para o canal 0
+static double desvioMaximo(uint8_t canais, double ciclosPorQuadro, bool alinhar) {
+    for (size_t k = 0; k < QUADROS; k++) {
+        for (uint8_t i = 0; i < canais; i++) {
+            double t = k + (double)i / canais;
+            entrada[k * canais + i] = (uint16_t)lround(2048 + 1500 * sin(2 * M_PI * ciclosPorQuadro * t));
+        }
+    }
+    Desentrelacador d;
+    desentrelacadorInit(&d, canais, alinhar);
+    processar(&d, canais, QUADROS);
+    double maior = 0;
+    for (uint8_t i = 1; i < canais; i++) {
+        for (size_t k = 1; k < QUADROS; k++) {
+            double desvio = fabs((double)saida[i][k] - saida[0][k]);
+            maior = desvio > maior ? desvio : maior;
+        }
+    }
+    return maior;
+}
+
+static void conferirDefasagem() {
+    for (uint8_t canais = 2; canais <= DESENTRELACADOR_CANAIS_MAX; canais++) {
+        double ciclos = 1.0 / 50;
+        double cru = desvioMaximo(canais, ciclos, false);
+        double alinhado = desvioMaximo(canais, ciclos, true);
+        // Erro da interpolação linear: A * (2 pi f T)^2 / 8, mais o arredondamento
+        double limite = 1500 * pow(2 * M_PI * ciclos, 2) / 8 + 2;
+        printf("%u canais: desvio entre canais %.1f LSB sem alinhar, %.1f alinhado\n", canais, cru, alinhado);
+        CONFERIR(alinhado <= limite, "%u canais: desvio alinhado %.1f LSB, limite %.1f", canais, alinhado, limite);
+        CONFERIR(alinhado * 10 < cru, "%u canais: alinhamento tirou pouco (%.1f -> %.1f)", canais, cru, alinhado);
+    }
+}
+
+static void conferirLimites() {
+    Desentrelacador d;
+    CONFERIR(!desentrelacadorInit(&d, 0, true), "aceitou 0 canais");
+    CONFERIR(!desentrelacadorInit(&d, DESENTRELACADOR_CANAIS_MAX + 1, true), "aceitou canais demais");
+
+    // Menos que um quadro não consome nada; a sobra de um quadro incompleto é ignorada
+    desentrelacadorInit(&d, 3, false);
+    uint16_t *ponteiros[3] = {saida[0], saida[1], saida[2]};
+    uint16_t sete[7] = {10, 20, 30, 11, 21, 31, 12};
+    CONFERIR(desentrelacadorProcessar(&d, sete, 2, ponteiros) == 0, "bloco menor que um quadro");
+    CONFERIR(desentrelacadorProcessar(&d, sete, 7, ponteiros) == 2, "quadro incompleto contado");
+    CONFERIR(saida[0][1] == 11 && saida[1][1] == 21 && saida[2][1] == 31, "segundo quadro fora do lugar");
+
+    // Primeiro bloco: sem amostra anterior, um degrau já presente não é interpolado
+    desentrelacadorInit(&d, 2, true);
+    uint16_t degrau[4] = {1000, 1000, 1000, 1000};
+    uint16_t *dois[2] = {saida[0], saida[1]};
+    desentrelacadorProcessar(&d, degrau, 4, dois);
+    CONFERIR(saida[1][0] == 1000, "primeira amostra alinhada contra zero: %u", saida[1][0]);
+}
+
+int main() {
+    srand(20);
+    conferirSeparacao();
+    conferirDefasagem();
+    conferirLimites();
+    return testeResultado();
+}
@@ -0,0 +1,127 @@
+// Detector com senoides de amplitude conhecida mais ruído: DC, RMS, pico, as
+// amplitudes dos quatro bins e a família de rede escolhida; e a estimativa
+// provisória pelo RMS com 25 ms da primeira janela.
+
+#include <math.h>
+#include <stdlib.h>
+#include "detector.h"
+#include "teste.h"
+
+#define TAXA 10000
+
+typedef struct {
+    const char *nome;
+    uint8_t bits;
+    double dc;
+    double amplitude[DETECTOR_NUM_BINS]; // Na escala de 12 bits
+    int ruido;                           // Uniforme em [-ruido, ruido], escala de 12 bits
+    uint8_t rede;
+} Caso;
+
+static const double frequencias[DETECTOR_NUM_BINS] = {50, 60, 100, 120};
+
+static const Caso casos[] = {
+    {"50 Hz puro", 12, 2048, {600, 0, 0, 0}, 0, 50},
+    {"50 Hz + harmônico + ruído", 12, 1900, {500, 0, 150, 0}, 40, 50},
+    {"60 Hz + harmônico + ruído", 12, 2200, {0, 700, 0, 200}, 40, 60},
+    {"60 Hz fraco com 50 Hz mais fraco", 12, 2048, {30, 80, 0, 0}, 10, 60},
+    {"16 bits do CIC, 50 Hz + ruído", 16, 2048, {900, 0, 0, 100}, 20, 50},
+};
+
+// Gerador simples e determinístico para o ruído
+static uint32_t semente = 12345;
+static int ruidoUniforme(int amplitude) {
+    semente = semente * 1103515245u + 12345u;
+    return (int)((semente >> 8) % (2 * amplitude + 1)) - amplitude;
+}
+
+static bool perto(double medido, double esperado, double relativo, double absoluto) {
+    return fabs(medido - esperado) <= esperado * relativo + absoluto;
+}
+
+// Com 'contagem' amostras na primeira janela. Com 25 ms os ciclos incompletos
+// de 50 e 60 Hz desviam o RMS em alguns por cento
+static void conferirParcial(const Caso *c, const Detector *d, uint32_t contagem, double rmsEsperado) {
+    DetectorResultado p;
+    bool pronto = detectorParcial(d, 250, &p);
+    CONFERIR(pronto == (contagem >= 250), "%s: parcial com %u amostras %s", c->nome, contagem,
+             pronto ? "entregue" : "recusado");
+    if (contagem != 250) {
+        return;
+    }
+    double esperada = fmin(2 * sqrt(2) * rmsEsperado, 4095);
+    CONFERIR(perto(p.intensidade, esperada, 0.08, 6), "%s: intensidade provisória %u, esperada %.0f", c->nome,
+             p.intensidade, esperada);
+    CONFERIR(p.rede == 0 && p.amplitude[DETECTOR_50HZ] == 0, "%s: parcial com bins", c->nome);
+}
+
+static void conferirCaso(const Caso *c) {
+    Detector d;
+    CONFERIR(detectorInit(&d, TAXA, c->bits), "%s: init", c->nome);
+    double escala = 1 << (c->bits - 12);
+    uint16_t amostras[TAXA / DETECTOR_JANELAS_POR_SEG];
+    DetectorResultado res;
+
+    double variancia = (double)c->ruido * (c->ruido + 1) / 3; // Uniforme discreta
+    double rmsEsperado = variancia;
+    double picoEsperado = 0;
+    for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+        rmsEsperado += c->amplitude[b] * c->amplitude[b] / 2;
+        picoEsperado += c->amplitude[b];
+    }
+    rmsEsperado = sqrt(rmsEsperado);
+
+    // A primeira janela tira o DC do meio da escala; confere a segunda, que já
+    // usa o DC medido
+    uint32_t t = 0;
+    for (int janela = 0; janela < 2; janela++) {
+        for (size_t i = 0; i < sizeof(amostras) / sizeof(amostras[0]); i++, t++) {
+            double v = c->dc;
+            for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+                v += c->amplitude[b] * sin(2 * M_PI * frequencias[b] * t / TAXA + 0.3 * b);
+            }
+            v = v * escala + ruidoUniforme(c->ruido) * escala;
+            amostras[i] = (uint16_t)lround(v);
+        }
+        // Em pedaços, como os blocos da captura
+        bool fechou = false;
+        for (size_t pos = 0; pos < sizeof(amostras) / sizeof(amostras[0]); pos += 250) {
+            if (janela == 0) {
+                conferirParcial(c, &d, pos, rmsEsperado);
+            }
+            bool f = detectorProcessar(&d, &amostras[pos], 250, &res);
+            fechou = fechou || f;
+        }
+        CONFERIR(fechou, "%s: janela %d não fechou", c->nome, janela);
+    }
+
+    CONFERIR(perto(res.dc / escala, c->dc, 0, 2), "%s: DC %.1f", c->nome, res.dc / escala);
+    CONFERIR(perto(res.rms / escala, rmsEsperado, 0.02, 2), "%s: RMS %.1f, esperado %.1f", c->nome,
+             res.rms / escala, rmsEsperado);
+    CONFERIR(res.pico / escala <= picoEsperado + c->ruido + 2, "%s: pico %.1f acima de %.1f", c->nome,
+             res.pico / escala, picoEsperado + c->ruido);
+    for (int b = 0; b < DETECTOR_NUM_BINS; b++) {
+        double medida = res.amplitude[b] / escala;
+        CONFERIR(perto(medida, c->amplitude[b], 0.02, 3 + c->ruido / 8.0), "%s: %.0f Hz com %.1f, esperado %.1f",
+                 c->nome, frequencias[b], medida, c->amplitude[b]);
+    }
+    CONFERIR(res.rede == c->rede, "%s: rede %u Hz", c->nome, res.rede);
+
+    double familia = c->rede == 50 ? hypot(c->amplitude[0], c->amplitude[2]) : hypot(c->amplitude[1], c->amplitude[3]);
+    CONFERIR(perto(res.intensidade, fmin(2 * familia, 4095), 0.02, 6), "%s: intensidade %u, esperada %.0f", c->nome,
+             res.intensidade, 2 * familia);
+}
+
+int main() {
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        conferirCaso(&casos[i]);
+    }
+
+    Detector d;
+    CONFERIR(!detectorInit(&d, TAXA, 11), "bits abaixo de 12");
+    CONFERIR(!detectorInit(&d, TAXA, 17), "bits acima de 16");
+    CONFERIR(!detectorInit(&d, 2000, 12), "taxa abaixo de 2x o maior bin em janelas de 100 ms");
+    CONFERIR(!detectorInit(&d, DETECTOR_TAXA_MAX + 1, 12), "taxa acima do limite do Goertzel");
+    CONFERIR(!detectorInit(&d, DETECTOR_TAXA_MAX / 2 + 1, 16), "limite cai com os bits extras");
+    return testeResultado();
+}
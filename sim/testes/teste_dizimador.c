@@ -0,0 +1,83 @@
+// CIC de ordem 3 contra uma referência direta: três médias móveis de 'razao'
+// amostras em 64 bits, sem estouro, amostradas a cada 'razao'. A saída do
+// dizimador (integradores módulo 2^32) tem que ser igual bit a bit, com blocos
+// de tamanhos aleatórios, entrada em fundo de escala por muito tempo (os
+// integradores dão várias voltas) e ruído.
+
+#include <stdlib.h>
+#include "dizimador.h"
+#include "teste.h"
+
+#define N 200000
+
+static uint16_t entrada[N];
+static uint16_t saida[N / DIZIMADOR_RAZAO_MIN + 1];
+static int64_t estagio[2][N];
+
+// Soma móvel das últimas 'razao' amostras, com zeros antes do início
+static void mediaMovel(const int64_t *x, int64_t *y, uint32_t razao) {
+    int64_t soma = 0;
+    for (int i = 0; i < N; i++) {
+        soma += x[i] - (i >= (int)razao ? x[i - razao] : 0);
+        y[i] = soma;
+    }
+}
+
+static void conferirRazao(uint32_t razao, const char *sinal) {
+    for (int i = 0; i < N; i++) {
+        estagio[0][i] = entrada[i];
+    }
+    mediaMovel(estagio[0], estagio[1], razao);
+    mediaMovel(estagio[1], estagio[0], razao);
+    mediaMovel(estagio[0], estagio[1], razao);
+    int deslocamento = 12 + 3 * __builtin_ctz(razao) - DIZIMADOR_BITS_SAIDA;
+
+    Dizimador z;
+    CONFERIR(dizimadorInit(&z, razao), "razão %u recusada", razao);
+    size_t k = 0, pos = 0;
+    while (pos < N) {
+        size_t bloco = 1 + rand() % 300;
+        if (pos + bloco > N) {
+            bloco = N - pos;
+        }
+        k += dizimadorProcessar(&z, &entrada[pos], bloco, &saida[k]);
+        pos += bloco;
+    }
+
+    CONFERIR(k == N / razao, "razão %u, %s: %zu saídas", razao, sinal, k);
+    uint32_t erros = 0;
+    for (size_t m = 0; m < k; m++) {
+        uint16_t ref = (uint16_t)(estagio[1][(m + 1) * razao - 1] >> deslocamento);
+        if (ref != saida[m] && erros++ == 0) {
+            CONFERIR(false, "razão %u, %s: saída %zu = %u, referência %u", razao, sinal, m, saida[m], ref);
+        }
+    }
+    CONFERIR(erros == 0, "razão %u, %s: %u saídas diferentes", razao, sinal, erros);
+
+    // Depois de acomodar (3 saídas), fundo de escala dá exatamente 4095 * 16
+    if (entrada[N - 1] == 4095 && entrada[N - 3 * razao] == 4095) {
+        CONFERIR(saida[k - 1] == 4095 << 4, "razão %u: fundo de escala %u", razao, saida[k - 1]);
+    }
+}
+
+int main() {
+    srand(17);
+    for (uint32_t razao = DIZIMADOR_RAZAO_MIN; razao <= DIZIMADOR_RAZAO_MAX; razao *= 2) {
+        for (int i = 0; i < N; i++) {
+            entrada[i] = i % 977 < 5 ? 4095 : rand() % 4096; // Ruído com picos
+        }
+        conferirRazao(razao, "ruído");
+        for (int i = 0; i < N; i++) {
+            entrada[i] = 4095;
+        }
+        conferirRazao(razao, "fundo de escala");
+        for (int i = 0; i < N; i++) {
+            entrada[i] = (i / 1000) % 2 ? 4095 : 0; // Degraus
+        }
+        conferirRazao(razao, "degraus");
+    }
+
+    Dizimador z;
+    CONFERIR(!dizimadorInit(&z, 2) && !dizimadorInit(&z, 128) && !dizimadorInit(&z, 24), "razão inválida aceita");
+    return testeResultado();
+}
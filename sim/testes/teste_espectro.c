@@ -0,0 +1,153 @@
+// FFT em ponto fixo contra uma DFT de referência em double sobre a mesma
+// entrada (DC tirado, janela de Hann, escala Q15): cada bin, com o expoente do
+// ponto flutuante em bloco, tem que ficar perto da referência, com o erro bem
+// abaixo dos ESPECTRO_FAIXA_DB que a tela mostra; o pico e os níveis das barras
+// têm que bater com os calculados da referência; e espectroAlimentar() tem que
+// entregar 'porSegundo' espectros por segundo de amostras.
+
+#include <math.h>
+#include <stdlib.h>
+#include "espectro.h"
+#include "teste.h"
+
+#define N ESPECTRO_PONTOS
+#define TAXA 8000
+
+static uint16_t amostras[TAXA];
+static double refRe[N / 2], refIm[N / 2];
+
+// Mesmo pré-processamento do firmware, em double, e DFT direta dos bins 0 a N/2 - 1
+static void dftReferencia(const uint16_t *x) {
+    uint32_t soma = 0;
+    for (int i = 0; i < N; i++) {
+        soma += x[i];
+    }
+    int32_t media = soma >> ESPECTRO_LOG2_PONTOS;
+    double w[N];
+    for (int i = 0; i < N; i++) {
+        w[i] = ((int32_t)x[i] - media) * 8.0 * (0.5 - 0.5 * cos(2 * M_PI * i / N));
+    }
+    for (int k = 0; k < N / 2; k++) {
+        double r = 0, im = 0;
+        for (int i = 0; i < N; i++) {
+            r += w[i] * cos(2 * M_PI * k * i / N);
+            im -= w[i] * sin(2 * M_PI * k * i / N);
+        }
+        refRe[k] = r;
+        refIm[k] = im;
+    }
+}
+
+// Nível de 0 a 255 da referência, com a fórmula do espectro.h: 0 dB é a
+// senoide de fundo de escala no bin, com ganho da janela N/4
+static double nivelReferencia(double m2) {
+    double pico = 2047.5 * 8 * N / 4;
+    double db = 10 * log10(m2 / (pico * pico));
+    double v = (db + ESPECTRO_FAIXA_DB) * 255 / ESPECTRO_FAIXA_DB;
+    return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+static void conferirSinal(const char *nome) {
+    EspectroQuadro q;
+    espectroCalcular(amostras, &q);
+    dftReferencia(amostras);
+
+    // Erro de cada bin relativo ao fundo de escala
+    double picoFundo = 2047.5 * 8 * N / 4;
+    double erroMax = 0, refMax = 0;
+    int refPico = 1;
+    for (int k = 0; k < N / 2; k++) {
+        int16_t r, i;
+        uint8_t e;
+        espectroBin(k, &r, &i, &e);
+        double dr = r * (double)(1 << e) - refRe[k], di = i * (double)(1 << e) - refIm[k];
+        double erro = sqrt(dr * dr + di * di);
+        erroMax = erro > erroMax ? erro : erroMax;
+        double m = refRe[k] * refRe[k] + refIm[k] * refIm[k];
+        if (k > 0 && m > refMax) {
+            refMax = m;
+            refPico = k;
+        }
+    }
+    double erroDb = 20 * log10(erroMax / picoFundo);
+    printf("%-24s erro máximo por bin %6.1f dB do fundo de escala, pico %u\n", nome, erroDb, q.pico);
+    CONFERIR(erroDb < -(ESPECTRO_FAIXA_DB + 6), "%s: erro de %.1f dB, acima do piso de -%d dB da tela", nome, erroDb,
+             ESPECTRO_FAIXA_DB);
+    if (refMax > 0) {
+        CONFERIR(q.pico == refPico, "%s: pico no bin %u, referência %d", nome, q.pico, refPico);
+    }
+
+    // Barras: o bin mais forte da faixa, na escala logarítmica
+    for (int b = 0; b < ESPECTRO_BARRAS; b++) {
+        uint16_t fim = b + 1 < ESPECTRO_BARRAS ? espectroPrimeiroBinBarra(b + 1) : N / 2;
+        double maior = 0;
+        for (uint16_t k = espectroPrimeiroBinBarra(b); k < fim; k++) {
+            double m = refRe[k] * refRe[k] + refIm[k] * refIm[k];
+            maior = m > maior ? m : maior;
+        }
+        double esperado = nivelReferencia(maior);
+        // Só onde o sinal está bem acima do erro da FFT (30 dB da tela)
+        if (esperado > 128) {
+            CONFERIR(fabs(q.barras[b] - esperado) <= 3, "%s: barra %d em %u, referência %.1f", nome, b,
+                     q.barras[b], esperado);
+        }
+    }
+}
+
+static void seno(double ciclos, double amplitude, double fase) {
+    for (int i = 0; i < N; i++) {
+        amostras[i] = (uint16_t)lround(2047.5 + amplitude * sin(2 * M_PI * ciclos * i / N + fase));
+    }
+}
+
+static void conferirCadencia() {
+    CONFERIR(!espectroInit(TAXA, TAXA / N + 1), "aceitou mais espectros do que a taxa comporta");
+    CONFERIR(espectroInit(TAXA, 10), "10 espectros por segundo a %u Hz recusados", TAXA);
+    for (int i = 0; i < TAXA; i++) {
+        amostras[i] = (uint16_t)lround(2047.5 + 1000 * sin(2 * M_PI * 1000.0 * i / TAXA));
+    }
+    EspectroQuadro q;
+    int prontos = 0, pos = 0;
+    while (pos < TAXA) {
+        int bloco = 1 + rand() % 300;
+        bloco = pos + bloco > TAXA ? TAXA - pos : bloco;
+        prontos += espectroAlimentar(&amostras[pos], bloco, &q);
+        pos += bloco;
+    }
+    CONFERIR(prontos == 10, "1 s de amostras deu %d espectros", prontos);
+    CONFERIR(espectroFrequencia(q.pico) == 1000, "1 kHz no bin de %u Hz", espectroFrequencia(q.pico));
+}
+
+int main() {
+    srand(21);
+    CONFERIR(espectroInit(TAXA, 10), "init recusado");
+
+    char nome[64];
+    for (int k = 1; k < N / 2; k += 7) {
+        seno(k, 2047, 0.3 * k);
+        snprintf(nome, sizeof(nome), "seno cheio, bin %d", k);
+        conferirSinal(nome);
+    }
+    seno(37.5, 2047, 0); // Entre dois bins
+    conferirSinal("seno cheio, bin 37,5");
+    seno(20, 20, 1); // -40 dB
+    conferirSinal("seno -40 dB, bin 20");
+
+    for (int i = 0; i < N; i++) { // Dois tons
+        amostras[i] = (uint16_t)lround(2047.5 + 1400 * sin(2 * M_PI * 12 * i / N) + 600 * sin(2 * M_PI * 90 * i / N));
+    }
+    conferirSinal("dois tons, bins 12 e 90");
+
+    for (int i = 0; i < N; i++) { // Ruído em toda a faixa
+        amostras[i] = rand() & 0x0FFF;
+    }
+    conferirSinal("ruído uniforme");
+
+    for (int i = 0; i < N; i++) { // Quadrada: harmônicos até Nyquist
+        amostras[i] = (i / 8) & 1 ? 4095 : 0;
+    }
+    conferirSinal("quadrada, bin 16");
+
+    conferirCadencia();
+    return testeResultado();
+}
@@ -0,0 +1,123 @@
+// Fila SPSC com produtor e consumidor em threads separadas, nas duas
+// políticas. Cada elemento leva um número de sequência e um conteúdo derivado
+// dele: o consumidor confere que nada chega rasgado nem fora de ordem e que
+// cada elemento que falta está contado em 'descartados' ou 'sobrescritos'.
+
+#include <pthread.h>
+#include <sched.h>
+#include "fila_spsc.h"
+#include "teste.h"
+
+#define CAPACIDADE 64
+#define TOTAL 500000u
+#define PALAVRAS 7
+
+typedef struct {
+    uint32_t seq;
+    uint32_t conteudo[PALAVRAS];
+} Elemento;
+
+static FilaSpsc fila;
+static Elemento dados[CAPACIDADE];
+static volatile uint32_t seqs[CAPACIDADE];
+static volatile bool produtorTerminou;
+static uint32_t recusados;
+
+static uint32_t conteudo(uint32_t seq, int i) {
+    return seq * 2654435761u + (uint32_t)i * 40503u;
+}
+
+// Rajadas com pausas de tamanho variável, para a fila encher às vezes
+static void pausa(uint32_t n) {
+    for (volatile uint32_t i = 0; i < n; i++) {
+    }
+}
+
+static void *produtor(void *arg) {
+    (void)arg;
+    Elemento e;
+    for (uint32_t seq = 0; seq < TOTAL; seq++) {
+        e.seq = seq;
+        for (int i = 0; i < PALAVRAS; i++) {
+            e.conteudo[i] = conteudo(seq, i);
+        }
+        if (!filaSpscPush(&fila, &e)) {
+            recusados++;
+        }
+        // Rajadas de 256 sem pausa a cada 4096. O yield deixa o consumidor
+        // andar também quando as duas threads dividem um núcleo só.
+        if ((seq & 4095) >= 256) {
+            pausa(40);
+            if ((seq & 31) == 0) {
+                sched_yield();
+            }
+        }
+    }
+    __atomic_store_n(&produtorTerminou, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void rodar(FilaPolitica politica, const char *nome) {
+    filaSpscInit(&fila, dados, politica == FILA_SOBRESCREVER ? seqs : NULL, sizeof(Elemento), CAPACIDADE, politica);
+    produtorTerminou = false;
+    recusados = 0;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, produtor, NULL);
+
+    uint32_t recebidos = 0, faltando = 0, rasgados = 0, foraDeOrdem = 0;
+    int64_t ultimo = -1;
+    Elemento e;
+    while (true) {
+        bool terminou = __atomic_load_n(&produtorTerminou, __ATOMIC_ACQUIRE);
+        if (!filaSpscPop(&fila, &e)) {
+            if (terminou) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        recebidos++;
+        if ((int64_t)e.seq <= ultimo) {
+            foraDeOrdem++;
+        } else {
+            faltando += e.seq - (uint32_t)(ultimo + 1);
+        }
+        ultimo = e.seq;
+        for (int i = 0; i < PALAVRAS; i++) {
+            if (e.conteudo[i] != conteudo(e.seq, i)) {
+                rasgados++;
+                break;
+            }
+        }
+        if ((recebidos & 8191) == 0) {
+            pausa(20000);
+        }
+    }
+    pthread_join(thread, NULL);
+    faltando += TOTAL - 1 - (uint32_t)ultimo;
+
+    uint32_t perdidos = politica == FILA_SOBRESCREVER ? fila.sobrescritos : fila.descartados;
+    printf("%s: %u recebidos, %u perdidos, ocupação máxima %u\n", nome, recebidos, perdidos, fila.ocupacaoMax);
+    CONFERIR(rasgados == 0, "%s: %u elementos rasgados", nome, rasgados);
+    CONFERIR(foraDeOrdem == 0, "%s: %u elementos fora de ordem", nome, foraDeOrdem);
+    CONFERIR(recebidos + perdidos == TOTAL, "%s: %u recebidos + %u perdidos != %u", nome, recebidos, perdidos, TOTAL);
+    CONFERIR(faltando == perdidos, "%s: %u faltando, %u contados", nome, faltando, perdidos);
+    CONFERIR(fila.ocupacaoMax <= CAPACIDADE, "%s: ocupação máxima %u", nome, fila.ocupacaoMax);
+    if (politica == FILA_DESCARTAR) {
+        CONFERIR(recusados == fila.descartados, "%s: %u push recusados, %u descartados", nome, recusados,
+                 fila.descartados);
+    } else {
+        CONFERIR(recusados == 0 && fila.descartados == 0, "%s: push recusado sobrescrevendo", nome);
+        CONFERIR(ultimo == TOTAL - 1, "%s: o último elemento se perdeu", nome);
+    }
+}
+
+int main() {
+    CONFERIR(!filaSpscInit(&fila, dados, seqs, sizeof(Elemento), 48, FILA_DESCARTAR), "capacidade não potência de 2");
+    CONFERIR(!filaSpscInit(&fila, dados, NULL, sizeof(Elemento), CAPACIDADE, FILA_SOBRESCREVER), "sobrescrever sem seq");
+
+    rodar(FILA_DESCARTAR, "descartar");
+    rodar(FILA_SOBRESCREVER, "sobrescrever");
+    return testeResultado();
+}
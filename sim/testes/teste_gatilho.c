@@ -0,0 +1,209 @@
+// Disparo sobre eventos conhecidos: um sinal com pulsos, quedas e cruzamentos
+// lentos com ruído, em posições sorteadas, passa pelo gatilho em blocos de
+// tamanho aleatório, e cada rajada é liberada alguns blocos depois de congelar.
+// Um modelo direto (comparações simples, amostra por amostra, com as mesmas
+// regras de pré-disparo, holdoff e histerese) diz em que amostra cada disparo
+// tem que acontecer; a rajada congelada tem que ser exatamente o trecho do
+// sinal em volta dela e o instante tem que ser o da amostra do disparo.
+
+#include <stdlib.h>
+#include <string.h>
+#include "gatilho.h"
+#include "teste.h"
+
+#define N 1000000
+#define TAXA 500000 // 2 us por amostra: o instante do disparo é exato
+#define US_POR_AMOSTRA (1000000 / TAXA)
+
+static uint16_t sinal[N];
+static uint16_t rajada[GATILHO_AMOSTRAS];
+
+static uint16_t ruido(int amplitude) {
+    return (uint16_t)(2048 + rand() % (2 * amplitude + 1) - amplitude);
+}
+
+// Pulsos de 'duracao' amostras em 'valor', espaçados de 'minimo' a 'maximo'; um
+// deles cai antes de o pré-disparo encher
+static void pulsos(uint16_t valor, int duracao, int minimo, int maximo) {
+    for (int i = 0; i < N; i++) {
+        sinal[i] = ruido(30);
+    }
+    for (int i = 200; i < N - duracao; i += minimo + rand() % (maximo - minimo)) {
+        for (int k = 0; k < duracao; k++) {
+            sinal[i + k] = valor;
+        }
+    }
+}
+
+// Pulsos para cima e para baixo alternados, para a janela
+static void pulsosJanela() {
+    pulsos(3800, 5, 3000, 15000);
+    for (int i = 7000; i < N - 5; i += 4000 + rand() % 9000) {
+        for (int k = 0; k < 5; k++) {
+            sinal[i + k] = 300;
+        }
+    }
+}
+
+// Onda triangular lenta com ruído forte: cruza o nível várias vezes em cada passagem
+static void triangularRuidosa() {
+    int periodo = 2000 + rand() % 500;
+    for (int i = 0; i < N; i++) {
+        int fase = i % periodo;
+        int rampa = fase < periodo / 2 ? fase : periodo - fase;
+        int v = 1400 + rampa * 1300 / (periodo / 2) + rand() % 241 - 120;
+        sinal[i] = (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+    }
+}
+
+static bool dispara(const GatilhoConfig *c, uint16_t x) {
+    switch (c->tipo) {
+    case GATILHO_JANELA:
+        return x < c->baixo || x > c->alto;
+    default:
+        return c->subida ? x >= c->nivel : x <= c->nivel;
+    }
+}
+
+static bool prepara(const GatilhoConfig *c, uint16_t x) {
+    return c->subida ? x <= c->nivel - c->histerese : x >= c->nivel + c->histerese;
+}
+
+typedef struct {
+    enum { ARMADO, DISPARADO, CONGELADO } estado;
+    bool preparado, houve;
+    uint32_t liberacao, disparo, fim;
+} Modelo;
+
+static void armar(Modelo *m, const GatilhoConfig *c, uint32_t total) {
+    m->estado = ARMADO;
+    m->preparado = false;
+    m->liberacao = total + c->preDisparo;
+    if (m->houve && m->disparo + c->holdoff > m->liberacao) {
+        m->liberacao = m->disparo + c->holdoff;
+    }
+}
+
+// Bloco [s, s + n) no modelo; true se a rajada completa neste bloco
+static bool modeloBloco(Modelo *m, const GatilhoConfig *c, uint32_t s, uint32_t n) {
+    if (m->estado == ARMADO) {
+        for (uint32_t j = s > m->liberacao ? s : m->liberacao; j < s + n; j++) {
+            if (c->tipo == GATILHO_BORDA && !m->preparado) {
+                m->preparado = prepara(c, sinal[j]);
+                continue;
+            }
+            if (dispara(c, sinal[j])) {
+                m->estado = DISPARADO;
+                m->houve = true;
+                m->preparado = false;
+                m->disparo = j;
+                m->fim = j + GATILHO_AMOSTRAS - c->preDisparo;
+                break;
+            }
+        }
+    }
+    if (m->estado == DISPARADO && s + n >= m->fim) {
+        m->estado = CONGELADO;
+        return true;
+    }
+    return false;
+}
+
+static void replay(const char *nome, const GatilhoConfig *c, uint32_t esperadosMin) {
+    CONFERIR(gatilhoInit(c), "%s: configuração recusada", nome);
+    Modelo m = {0};
+    armar(&m, c, 0);
+
+    uint32_t pos = 0, disparos = 0, diferentes = 0, liberarEm = 0;
+    while (pos < N) {
+        uint32_t n = 1 + rand() % 700;
+        n = pos + n > N ? N - pos : n;
+
+        // Núcleo 0: libera a rajada alguns blocos depois de ela congelar
+        if (m.estado == CONGELADO && liberarEm-- == 0) {
+            gatilhoLiberar();
+            armar(&m, c, pos);
+        }
+        bool esperado = m.estado != CONGELADO && modeloBloco(&m, c, pos, n);
+        uint64_t agora = (uint64_t)(pos + n - 1) * US_POR_AMOSTRA;
+        bool congelou = gatilhoAlimentar(&sinal[pos], n, agora);
+        if (congelou != esperado && diferentes++ < 5) {
+            CONFERIR(false, "%s: bloco %u..%u %s, modelo %s (disparo esperado na amostra %u)", nome, pos, pos + n - 1,
+                     congelou ? "congelou" : "não congelou", esperado ? "congela" : "não congela", m.disparo);
+        }
+        if (congelou && esperado) {
+            disparos++;
+            gatilhoCopiar(0, rajada, GATILHO_AMOSTRAS);
+            bool igual = memcmp(rajada, &sinal[m.disparo - c->preDisparo], sizeof(rajada)) == 0;
+            uint64_t instante = (uint64_t)m.disparo * US_POR_AMOSTRA;
+            if ((!igual || gatilhoInstante() != instante || !gatilhoCongelado()) && diferentes++ < 5) {
+                CONFERIR(false, "%s: disparo na amostra %u: rajada %s, instante %llu us (esperado %llu)", nome,
+                         m.disparo, igual ? "certa" : "diferente", (unsigned long long)gatilhoInstante(),
+                         (unsigned long long)instante);
+            }
+            liberarEm = rand() % 4;
+        }
+        pos += n;
+    }
+
+    GatilhoStats stats;
+    gatilhoGetStats(&stats);
+    printf("%-26s %4u disparos\n", nome, disparos);
+    CONFERIR(diferentes == 0, "%s: %u diferenças com o modelo", nome, diferentes);
+    CONFERIR(disparos >= esperadosMin, "%s: só %u disparos", nome, disparos);
+    // O último disparo pode ter ficado sem completar a rajada no fim do sinal
+    CONFERIR(stats.disparos == disparos || stats.disparos == disparos + 1, "%s: %u disparos nas estatísticas, %u rajadas",
+             nome, stats.disparos, disparos);
+}
+
+static void conferirConfiguracao() {
+    GatilhoConfig c = {.tipo = GATILHO_NIVEL, .subida = true, .nivel = 3000, .preDisparo = 1000, .taxa = TAXA};
+    CONFERIR(gatilhoInit(&c), "configuração válida recusada");
+    c.preDisparo = GATILHO_AMOSTRAS;
+    CONFERIR(!gatilhoInit(&c), "pré-disparo do tamanho da rajada aceito");
+    c.preDisparo = 1000;
+    c.nivel = 0;
+    CONFERIR(!gatilhoInit(&c), "nível 0 aceito");
+    c.nivel = 3000;
+    c.taxa = 0;
+    CONFERIR(!gatilhoInit(&c), "taxa 0 aceita");
+    c.taxa = TAXA;
+    c.tipo = GATILHO_BORDA;
+    c.histerese = 3001;
+    CONFERIR(!gatilhoInit(&c), "histerese abaixo de zero aceita");
+    GatilhoConfig j = {.tipo = GATILHO_JANELA, .baixo = 2000, .alto = 1000, .taxa = TAXA};
+    CONFERIR(!gatilhoInit(&j), "janela invertida aceita");
+}
+
+int main() {
+    srand(24);
+    conferirConfiguracao();
+
+    pulsos(3500, 10, 5000, 20000);
+    GatilhoConfig nivelSubida = {.tipo = GATILHO_NIVEL, .subida = true, .nivel = 3000, .preDisparo = 1000, .taxa = TAXA};
+    replay("nível, subida", &nivelSubida, 40);
+
+    pulsos(600, 10, 5000, 20000);
+    GatilhoConfig nivelDescida = {.tipo = GATILHO_NIVEL, .subida = false, .nivel = 1000, .preDisparo = 4000, .taxa = TAXA};
+    replay("nível, descida", &nivelDescida, 40);
+
+    // Holdoff maior que o intervalo dos pulsos: vários são ignorados
+    pulsos(3500, 3, 2000, 4000);
+    GatilhoConfig holdoff = nivelSubida;
+    holdoff.holdoff = 50000;
+    replay("nível, holdoff 50000", &holdoff, 15);
+
+    triangularRuidosa();
+    GatilhoConfig bordaSubida = {.tipo = GATILHO_BORDA, .subida = true, .nivel = 2200, .histerese = 300,
+                                 .preDisparo = 512, .taxa = TAXA};
+    replay("borda, subida", &bordaSubida, 40);
+    GatilhoConfig bordaDescida = {.tipo = GATILHO_BORDA, .subida = false, .nivel = 2000, .histerese = 300,
+                                  .preDisparo = GATILHO_AMOSTRAS - 1, .taxa = TAXA};
+    replay("borda, descida", &bordaDescida, 40);
+
+    pulsosJanela();
+    GatilhoConfig janela = {.tipo = GATILHO_JANELA, .baixo = 1500, .alto = 2600, .preDisparo = 0, .taxa = TAXA};
+    replay("janela", &janela, 40);
+
+    return testeResultado();
+}
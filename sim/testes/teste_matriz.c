@@ -0,0 +1,170 @@
+// Renderizador da matriz contra o ativarLedADC antigo (copiado aqui como
+// referência, com o npSetLED que invertia cada byte): mesmas linhas cheias e
+// apagadas para cada valor, a linha parcial com o brilho médio da curva de
+// gama depois dos 16 quadros do dithering; o tempo por quadro de cada um só
+// é mostrado.
+
+#include <math.h>
+#include <time.h>
+#include "matriz_led.h"
+#include "teste.h"
+
+#define BRILHO_MAXIMO 64
+#define ESCALA 2600 // Escala fixa do código antigo
+#define LINHA (ESCALA / MATRIZ_LADO)
+
+// Referência: como era antes das tabelas
+typedef struct {
+    uint8_t G, R, B;
+} sLED;
+
+static sLED leds[LED_COUNT];
+static uint32_t brilhoMaximo = BRILHO_MAXIMO;
+
+static uint8_t inverter_byte(uint8_t byte_original) {
+    uint8_t invertido = 0;
+    for (int i = 0; i < 8; i++) {
+        invertido = invertido << 1;
+        invertido = (invertido | ((byte_original >> i) & 0x1));
+    }
+    return invertido;
+}
+
+static void refSetLED(unsigned int index, uint8_t r, uint8_t g, uint8_t b) {
+    leds[index].R = inverter_byte(r);
+    leds[index].G = inverter_byte(g);
+    leds[index].B = inverter_byte(b);
+}
+
+static void refClear() {
+    for (unsigned int i = 0; i < LED_COUNT; i++) {
+        refSetLED(i, 0, 0, 0);
+    }
+}
+
+// Os cinco ramos do original dão isto: as linhas abaixo de val / 520 cheias e
+// a seguinte com brilhoMaximo * val / (520 * (linha + 1))
+static void ativarLedADC(uint16_t val) {
+    if (val > ESCALA) {
+        val = ESCALA;
+    }
+    refClear();
+    if (val == 0) {
+        return;
+    }
+    unsigned int linha = val >= ESCALA ? MATRIZ_LADO - 1 : val / LINHA;
+    uint8_t brilho = (brilhoMaximo * val) / (LINHA * (linha + 1));
+    for (unsigned int j = 0; j < linha * MATRIZ_LADO; j++) {
+        refSetLED(j, brilhoMaximo, 0, 0);
+    }
+    for (unsigned int i = linha * MATRIZ_LADO; i < (linha + 1) * MATRIZ_LADO; i++) {
+        refSetLED(i, brilho, 0, 0);
+    }
+}
+
+static uint8_t vermelho(uint32_t grb) {
+    return (grb >> 16) & 0xFF;
+}
+
+// Valores cuja faixa de 16 da tabela cai toda dentro da mesma linha
+static bool longeDaBorda(uint16_t val) {
+    uint16_t centro = val >> 4 ? (val & ~15) + 8 : 0;
+    return val / LINHA == centro / LINHA && (val & ~15) / LINHA == ((val | 15) + 1) / LINHA;
+}
+
+static void conferirNiveis() {
+    int conferidos = 0;
+    for (uint16_t val = 0; val < ESCALA; val++) {
+        if (!longeDaBorda(val)) {
+            continue;
+        }
+        conferidos++;
+        ativarLedADC(val);
+        unsigned int cheias = val / LINHA;
+
+        // Soma de 16 quadros seguidos, que cobrem um ciclo inteiro do dithering
+        uint32_t soma[LED_COUNT] = {0};
+        for (int q = 0; q < 1 << MATRIZ_BITS_DITHER; q++) {
+            matrizRenderizar(val, MATRIZ_BARRA);
+            for (int i = 0; i < LED_COUNT; i++) {
+                soma[i] += vermelho(npQuadroFrente()->grb[i]);
+            }
+        }
+
+        for (unsigned int i = 0; i < LED_COUNT; i++) {
+            uint8_t ref = inverter_byte(leds[i].R);
+            uint32_t cheio = BRILHO_MAXIMO << MATRIZ_BITS_DITHER;
+            if (i < cheias * MATRIZ_LADO) {
+                CONFERIR(ref == BRILHO_MAXIMO && soma[i] == cheio, "val %u LED %u: linha cheia (%u, %u/16)", val, i,
+                         ref, soma[i]);
+            } else if (i >= (cheias + 1) * MATRIZ_LADO) {
+                CONFERIR(ref == 0 && soma[i] == 0, "val %u LED %u: linha apagada (%u, %u/16)", val, i, ref, soma[i]);
+            } else {
+                // Linha parcial: o antigo era linear no valor; o novo segue a
+                // curva de gama da fração da linha, em 1/256
+                uint32_t centro = val >> 4 ? (val & ~15) + 8 : 0;
+                double fracao = (centro * MATRIZ_LADO * 256 / ESCALA & 0xFF) / 256.0;
+                double esperado = pow(fracao, 2.2) * cheio;
+                CONFERIR(fabs(soma[i] - esperado) <= 1, "val %u LED %u: %u/16, esperado %.1f", val, i, soma[i],
+                         esperado);
+            }
+        }
+    }
+    CONFERIR(conferidos > ESCALA * 3 / 4, "só %d valores conferidos", conferidos);
+}
+
+static double agoraNs() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// Soma de cada quadro gerado: sem ela o otimizador descarta o leds[] da
+// referência, que ninguém lê dentro da medição
+static volatile uint32_t sumidouro;
+
+// Varre a escala inteira 'voltas' vezes; ns por quadro
+static double medirAntes(int voltas) {
+    double t0 = agoraNs();
+    for (int v = 0; v < voltas; v++) {
+        for (uint16_t val = 0; val < 4096; val += 7) {
+            ativarLedADC(val);
+            uint32_t soma = 0;
+            for (int i = 0; i < LED_COUNT; i++) {
+                soma += leds[i].G << 16 | leds[i].R << 8 | leds[i].B;
+            }
+            sumidouro = soma;
+        }
+    }
+    return (agoraNs() - t0) / (voltas * (4096 / 7 + 1));
+}
+
+static double medirAgora(int voltas) {
+    double t0 = agoraNs();
+    for (int v = 0; v < voltas; v++) {
+        for (uint16_t val = 0; val < 4096; val += 7) {
+            matrizRenderizar(val, MATRIZ_BARRA);
+            uint32_t soma = 0;
+            for (int i = 0; i < LED_COUNT; i++) {
+                soma += npQuadroFrente()->grb[i];
+            }
+            sumidouro = soma;
+        }
+    }
+    return (agoraNs() - t0) / (voltas * (4096 / 7 + 1));
+}
+
+int main() {
+    npInit(7);
+    matrizInit(BRILHO_MAXIMO, ESCALA);
+    conferirNiveis();
+
+    medirAntes(50); // Aquece caches
+    medirAgora(50);
+    double antes = medirAntes(500);
+    double agora = medirAgora(500);
+    // Só informativo: no host otimizado o laço antigo vira código vetorial, e o
+    // novo inclui a comparação com o quadro anterior e o envio pela HAL simulada
+    printf("ns por quadro: antes %.1f, agora %.1f (%.1fx)\n", antes, agora, antes / agora);
+    return testeResultado();
+}
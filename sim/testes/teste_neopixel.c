@@ -0,0 +1,145 @@
+// Sequência de bits que sai no fio da matriz de LEDs: os quadros de palavras
+// GRB do neopixel.c, passados pelo registrador de saída da máquina PIO com a
+// configuração que está no ws2818b.pio, têm que dar exatamente os mesmos bits
+// que o npSetLED/npWrite antigos (um byte invertido por push, deslocamento
+// para a direita de 8 bits), copiados aqui como referência.
+
+#include <stdlib.h>
+#include <string.h>
+#include "neopixel.h"
+#include "teste.h"
+
+#define BITS_QUADRO (LED_COUNT * 24)
+
+// Referência: como era antes do quadro por DMA
+static uint8_t refFifo[LED_COUNT * 3];
+
+static uint8_t inverter_byte(uint8_t byte_original) {
+    uint8_t invertido = 0;
+    for (int i = 0; i < 8; i++) {
+        invertido = invertido << 1;
+        invertido = (invertido | ((byte_original >> i) & 0x1));
+    }
+    return invertido;
+}
+
+static void refSetLED(unsigned int index, uint8_t r, uint8_t g, uint8_t b) {
+    refFifo[3 * index] = inverter_byte(g);
+    refFifo[3 * index + 1] = inverter_byte(r);
+    refFifo[3 * index + 2] = inverter_byte(b);
+}
+
+// Registrador de saída com autopull: cada palavra do FIFO rende 'limiar' bits,
+// do bit 0 para cima deslocando para a direita ou do bit 31 para baixo
+// deslocando para a esquerda
+static int deslocar(const uint32_t *fifo, int n, bool direita, int limiar, uint8_t *bits) {
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t osr = fifo[i];
+        for (int b = 0; b < limiar; b++) {
+            if (direita) {
+                bits[k++] = osr & 1;
+                osr >>= 1;
+            } else {
+                bits[k++] = osr >> 31;
+                osr <<= 1;
+            }
+        }
+    }
+    return k;
+}
+
+static int bitsReferencia(uint8_t *bits) {
+    uint32_t fifo[LED_COUNT * 3];
+    for (int i = 0; i < LED_COUNT * 3; i++) {
+        fifo[i] = refFifo[i]; // pio_sm_put_blocking de um uint8_t
+    }
+    return deslocar(fifo, LED_COUNT * 3, true, 8, bits);
+}
+
+// Configuração do registrador de saída tirada do ws2818b.pio
+static bool direitaPio;
+static int limiarPio;
+
+static bool lerPio() {
+    FILE *f = fopen(WS2818B_PIO, "r");
+    if (!f) {
+        return false;
+    }
+    char linha[256];
+    bool achou = false;
+    while (!achou && fgets(linha, sizeof(linha), f)) {
+        char *p = strstr(linha, "sm_config_set_out_shift(");
+        char direita[8], autopull[8];
+        if (p && sscanf(p, "sm_config_set_out_shift(&c, %7[a-z], %7[a-z], %d)", direita, autopull, &limiarPio) == 3) {
+            direitaPio = strcmp(direita, "true") == 0;
+            achou = strcmp(autopull, "true") == 0;
+        }
+    }
+    fclose(f);
+    return achou;
+}
+
+static int bitsQuadro(uint8_t *bits) {
+    return deslocar(npQuadroFrente()->grb, LED_COUNT, direitaPio, limiarPio, bits);
+}
+
+static bool conferirQuadro(const char *nome) {
+    static uint8_t ref[BITS_QUADRO], agora[BITS_QUADRO];
+    CONFERIR(npWrite(), "%s: npWrite recusou o quadro", nome);
+    int nRef = bitsReferencia(ref);
+    int nAgora = bitsQuadro(agora);
+    CONFERIR(nRef == BITS_QUADRO && nAgora == BITS_QUADRO, "%s: %d bits na referência, %d agora", nome, nRef, nAgora);
+    for (int i = 0; i < BITS_QUADRO && i < nAgora; i++) {
+        if (ref[i] != agora[i]) {
+            CONFERIR(false, "%s: bit %d (LED %d) diferente", nome, i, i / 24);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    CONFERIR(lerPio(), "configuração do registrador de saída não encontrada em %s", WS2818B_PIO);
+    npInit(7);
+
+    // Quadros inteiros aleatórios
+    srand(1);
+    for (int quadro = 0; quadro < 200; quadro++) {
+        for (int i = 0; i < LED_COUNT; i++) {
+            uint8_t r = rand(), g = rand(), b = rand();
+            npSetLED(i, r, g, b);
+            refSetLED(i, r, g, b);
+        }
+        if (!conferirQuadro("aleatório")) {
+            break;
+        }
+    }
+
+    // Cada bit de cada cor sozinho, para pegar troca de ordem ou de canal
+    for (int led = 0; led < LED_COUNT; led++) {
+        for (int bit = 0; bit < 24; bit++) {
+            uint8_t c[3] = {0, 0, 0};
+            c[bit / 8] = 1u << (bit % 8);
+            npClear();
+            memset(refFifo, inverter_byte(0), sizeof(refFifo));
+            npSetLED(led, c[0], c[1], c[2]);
+            refSetLED(led, c[0], c[1], c[2]);
+            conferirQuadro("bit isolado");
+        }
+    }
+
+    // O quadro de trás começa com o conteúdo do último enviado: só um LED
+    // mudando não apaga os outros
+    npClear();
+    memset(refFifo, inverter_byte(0), sizeof(refFifo));
+    for (int i = 0; i < LED_COUNT; i++) {
+        npSetLED(i, i * 10, 255 - i, i);
+        refSetLED(i, i * 10, 255 - i, i);
+    }
+    conferirQuadro("cheio");
+    npSetLED(12, 1, 2, 3);
+    refSetLED(12, 1, 2, 3);
+    conferirQuadro("incremental");
+    return testeResultado();
+}
@@ -0,0 +1,211 @@
+// Registro na flash simulada: instantes com desvio que ainda cabem na grade
+// de uma página, desgaste igual entre os setores depois de várias voltas do
+// anel e cortes de energia em toda a extensão de uma sessão, com a
+// recuperação no registroInit() seguinte.
+
+#include <stdlib.h>
+#include <string.h>
+#include "registro.h"
+#include "teste.h"
+
+#define PERIODO 100
+#define TOLERANCIA (PERIODO / 4)
+
+typedef struct {
+    uint16_t sessao;
+    uint32_t instante;
+    uint16_t valor;
+} Exportado;
+
+static Exportado *exportados;
+static uint32_t nExportados;
+
+static void guardar(uint16_t sessao, uint32_t instanteMs, uint16_t valor, void *ctx) {
+    (void)ctx;
+    exportados[nExportados++] = (Exportado){sessao, instanteMs, valor};
+}
+
+static uint32_t exportar() {
+    nExportados = 0;
+    return registroExportar(guardar, NULL);
+}
+
+// Valores espalhados: diferenças de 3 bytes, páginas de uns 80 registros
+static uint16_t valorDe(uint32_t k) {
+    return (k * 2654435761u) >> 16;
+}
+
+static void apagarFlash() {
+    memset(registroFlashSimulada(), 0xFF, REGISTRO_TAM_REGIAO);
+    registroInit();
+}
+
+static void escrever(uint32_t k0, uint32_t n) {
+    for (uint32_t k = k0; k < k0 + n; k++) {
+        registroAdicionar(valorDe(k), k * PERIODO);
+        registroProcessar(k * PERIODO);
+    }
+}
+
+static void descarregar(uint32_t agoraMs) {
+    registroDescarregar();
+    for (int i = 0; i < 100; i++) {
+        registroProcessar(agoraMs);
+    }
+}
+
+static void conferirDesvio() {
+    apagarFlash();
+    srand(4);
+    uint32_t instantes[200];
+    uint16_t valor = 1000;
+    for (uint32_t k = 0; k < 200; k++) {
+        instantes[k] = 50000 + k * PERIODO + (k ? rand() % (2 * 20 + 1) - 20 : 0);
+        valor += rand() % 21 - 10;
+        registroAdicionar(valor, instantes[k]);
+    }
+    descarregar(instantes[199]);
+    RegistroStats stats;
+    registroGetStats(&stats);
+    CONFERIR(stats.paginasGravadas == 1, "200 registros com desvio em %u páginas", stats.paginasGravadas);
+    CONFERIR(exportar() == 200, "%u registros exportados", nExportados);
+    for (uint32_t k = 0; k < 200 && k < nExportados; k++) {
+        int32_t erro = (int32_t)(exportados[k].instante - instantes[k]);
+        CONFERIR(abs(erro) <= TOLERANCIA, "registro %u a %d ms do instante real", k, erro);
+    }
+
+    // Um registro faltando (salto de dois períodos) abre uma página nova
+    registroAdicionar(1, 80000);
+    registroAdicionar(2, 80000 + PERIODO);
+    registroAdicionar(3, 80000 + 3 * PERIODO);
+    descarregar(90000);
+    registroGetStats(&stats);
+    CONFERIR(stats.paginasGravadas == 3, "salto no meio da página: %u páginas", stats.paginasGravadas);
+    CONFERIR(exportar() == 203 && exportados[202].instante == 80000 + 3 * PERIODO, "instante depois do salto");
+}
+
+// Os registros exportados são os últimos escritos, em ordem, até 'ultimo'
+static void conferirCauda(uint32_t ultimo, const char *nome) {
+    for (uint32_t i = 0; i < nExportados; i++) {
+        uint32_t k = ultimo + 1 - nExportados + i;
+        if (exportados[i].instante != k * PERIODO || exportados[i].valor != valorDe(k)) {
+            CONFERIR(false, "%s: exportado %u é %u ms, esperado %u ms", nome, i, exportados[i].instante, k * PERIODO);
+            return;
+        }
+    }
+}
+
+static void conferirDesgaste() {
+    apagarFlash();
+    const uint32_t total = 400000; // Umas cinco voltas do anel
+    escrever(0, total);
+    descarregar(total * PERIODO);
+
+    RegistroStats stats;
+    registroGetStats(&stats);
+    CONFERIR(stats.perdidos == 0, "%u registros perdidos", stats.perdidos);
+    CONFERIR(stats.apagamentosMin >= 4 && stats.apagamentosMax - stats.apagamentosMin <= 1,
+             "desgaste entre %u e %u apagamentos", stats.apagamentosMin, stats.apagamentosMax);
+
+    // Só o setor que está sendo reaproveitado fica de fora
+    exportar();
+    uint32_t porSetor = nExportados / REGISTRO_SETORES;
+    CONFERIR(nExportados >= (REGISTRO_SETORES - 2) * porSetor, "%u registros exportados", nExportados);
+    conferirCauda(total - 1, "desgaste");
+
+    // Um boot novo acha o ponto de escrita e o desgaste de cada setor
+    registroInit();
+    RegistroStats depois;
+    registroGetStats(&depois);
+    CONFERIR(depois.apagamentosMin == stats.apagamentosMin && depois.apagamentosMax == stats.apagamentosMax,
+             "desgaste depois do boot entre %u e %u", depois.apagamentosMin, depois.apagamentosMax);
+    uint32_t antes = exportar();
+    escrever(total, 1000);
+    descarregar((total + 1000) * PERIODO);
+    exportar();
+    CONFERIR(nExportados + 2 * porSetor >= antes, "boot novo perdeu registros: %u antes, %u depois", antes,
+             nExportados);
+    CONFERIR(exportados[nExportados - 1].sessao == depois.sessao, "sessão do último registro");
+    conferirCauda(total + 1000 - 1, "depois do boot");
+}
+
+// Corte de energia em vários pontos de uma sessão que grava páginas, apaga
+// setores reaproveitados e abre setores novos. Depois do boot seguinte: nada
+// inventado ou fora de ordem, no máximo o setor em apagamento e a página em
+// gravação perdidos, e a sessão nova grava e exporta normalmente.
+static void conferirCortes() {
+    static uint8_t base[REGISTRO_TAM_REGIAO];
+    const uint32_t kBase = 90000, kSessao = 6000, kDepois = 500;
+
+    apagarFlash();
+    escrever(0, kBase); // Passa de uma volta do anel
+    descarregar(kBase * PERIODO);
+    memcpy(base, registroFlashSimulada(), REGISTRO_TAM_REGIAO);
+    registroInit();
+    uint32_t nBase = exportar();
+
+    // Bytes que a sessão leva à flash sem corte
+    escrever(kBase, kSessao);
+    descarregar((kBase + kSessao) * PERIODO);
+    RegistroStats stats;
+    registroGetStats(&stats);
+    uint32_t bytesSessao = (stats.paginasGravadas + stats.setoresApagados + 2) * REGISTRO_TAM_PAGINA +
+                           stats.setoresApagados * REGISTRO_TAM_SETOR;
+    CONFERIR(stats.setoresApagados >= 2, "sessão sem apagamentos (%u)", stats.setoresApagados);
+
+    uint32_t casos = 0;
+    for (uint32_t corte = 0; corte < bytesSessao; corte += bytesSessao / 300 + 37) {
+        memcpy(registroFlashSimulada(), base, REGISTRO_TAM_REGIAO);
+        registroInit();
+        registroSimularCorte(corte);
+        escrever(kBase, kSessao);
+        descarregar((kBase + kSessao) * PERIODO);
+
+        registroInit(); // A energia volta
+        registroGetStats(&stats);
+        exportar();
+        casos++;
+
+        bool ok = true;
+        for (uint32_t i = 0; i < nExportados && ok; i++) {
+            uint32_t k = exportados[i].instante / PERIODO;
+            ok = exportados[i].instante % PERIODO == 0 && exportados[i].valor == valorDe(k) &&
+                 (i == 0 || exportados[i].instante > exportados[i - 1].instante);
+            CONFERIR(ok, "corte em %u: registro %u inválido (%u ms, %u)", corte, i, exportados[i].instante,
+                     exportados[i].valor);
+        }
+        uint32_t porSetor = nBase / REGISTRO_SETORES;
+        CONFERIR(nExportados + 2 * porSetor >= nBase, "corte em %u: %u registros, %u antes da sessão", corte,
+                 nExportados, nBase);
+
+        uint32_t ultimo = exportados[nExportados - 1].instante / PERIODO;
+        escrever(kBase + kSessao, kDepois);
+        descarregar((kBase + kSessao + kDepois) * PERIODO);
+        exportar();
+        uint32_t novos = 0;
+        for (uint32_t i = 0; i < nExportados; i++) {
+            novos += exportados[i].sessao == stats.sessao;
+        }
+        CONFERIR(novos == kDepois, "corte em %u: %u de %u registros da sessão depois do corte", corte, novos,
+                 kDepois);
+        if (novos != kDepois || nExportados <= kDepois) {
+            continue;
+        }
+        CONFERIR(exportados[nExportados - kDepois - 1].instante / PERIODO == ultimo,
+                 "corte em %u: registros anteriores mudaram depois do boot", corte);
+        // Os da sessão nova são os últimos e vêm inteiros
+        memmove(exportados, &exportados[nExportados - kDepois], kDepois * sizeof(Exportado));
+        nExportados = kDepois;
+        conferirCauda(kBase + kSessao + kDepois - 1, "sessão depois do corte");
+    }
+    CONFERIR(casos >= 200, "só %u cortes", casos);
+}
+
+int main() {
+    exportados = malloc(sizeof(Exportado) * REGISTRO_TAM_REGIAO);
+    conferirDesvio();
+    conferirDesgaste();
+    conferirCortes();
+    free(exportados);
+    return testeResultado();
+}
@@ -0,0 +1,127 @@
+// Divisores por modo de clock: nos três perfis (48, 125 e 200 MHz) a PIO do
+// WS2812 e o I2C do OLED têm que sair com os valores conhecidos e válidos; numa
+// varredura do clk_sys, o divisor truncado em 16.8, o período de bit e o baud
+// do I2C têm que bater com uma conta de referência em double, e 'valido' tem
+// que valer exatamente quando os dois ficam dentro das tolerâncias.
+
+#include <math.h>
+#include <string.h>
+#include "relogio.h"
+#include "ssd1306_i2c.h"
+#include "teste.h"
+
+#define I2C_HZ (SSD1306_I2C_CLK * 1000)
+
+typedef struct {
+    RelogioModo modo;
+    uint32_t sysHz;
+    uint16_t pioDivInt;
+    uint8_t pioDivFrac;
+    uint32_t i2cHz;
+} Esperado;
+
+// 125 MHz / 8 MHz = 15,625 = 15 + 160/256; o I2C a 125 MHz fica em 313 ciclos
+static const Esperado esperados[] = {
+    {RELOGIO_ECONOMIA, 48000000, 6, 0, 400000},
+    {RELOGIO_NORMAL, 125000000, 15, 160, 399361},
+    {RELOGIO_TURBO, 200000000, 25, 0, 400000},
+};
+
+static void conferirPerfis() {
+    for (size_t i = 0; i < sizeof(esperados) / sizeof(esperados[0]); i++) {
+        const Esperado *e = &esperados[i];
+        RelogioDivisores d;
+        const char *nome = relogioNome(e->modo);
+        CONFERIR(relogioFrequencia(e->modo) == e->sysHz, "%s: %u Hz", nome, relogioFrequencia(e->modo));
+        CONFERIR(relogioCalcular(relogioFrequencia(e->modo), I2C_HZ, &d), "%s: divisores inválidos", nome);
+        CONFERIR(d.pioDivInt == e->pioDivInt && d.pioDivFrac == e->pioDivFrac, "%s: PIO %u + %u/256, esperado %u + %u/256",
+                 nome, d.pioDivInt, d.pioDivFrac, e->pioDivInt, e->pioDivFrac);
+        CONFERIR(d.bitNs == 1000000000u / RELOGIO_WS2812_HZ, "%s: bit de %u ns", nome, d.bitNs);
+        CONFERIR(d.i2cHz == e->i2cHz, "%s: I2C em %u Hz, esperado %u", nome, d.i2cHz, e->i2cHz);
+        printf("%-6s %3u MHz: PIO %2u + %3u/256, bit %u ns, I2C %u Hz\n", nome, e->sysHz / 1000000, d.pioDivInt,
+               d.pioDivFrac, d.bitNs, d.i2cHz);
+    }
+}
+
+// Referência independente para um clk_sys qualquer
+static void conferirFrequencia(uint32_t sysHz, uint32_t i2cHz, uint32_t *diferentes) {
+    RelogioDivisores d;
+    bool valido = relogioCalcular(sysHz, i2cHz, &d);
+
+    double div = floor(sysHz * 256.0 / (RELOGIO_WS2812_CICLOS_BIT * RELOGIO_WS2812_HZ)) / 256;
+    double bitNs = div * RELOGIO_WS2812_CICLOS_BIT * 1e9 / sysHz;
+    double nominal = 1e9 / RELOGIO_WS2812_HZ;
+    bool pioOk = div >= 1 && fabs(floor(bitNs) - nominal) <= nominal * RELOGIO_TOLERANCIA_WS2812 / 100;
+
+    uint32_t periodo = (uint32_t)lround((double)sysHz / i2cHz);
+    uint32_t baixo = periodo * 3 / 5, alto = periodo - baixo;
+    uint32_t baud = sysHz / periodo;
+    bool i2cOk = baixo >= 8 && alto >= 8 && baud <= i2cHz && baud >= i2cHz * (1 - RELOGIO_TOLERANCIA_I2C / 100.0);
+
+    bool igual = d.pioDivInt == (uint16_t)div && d.pioDivFrac == (uint8_t)lround((div - floor(div)) * 256) &&
+                 d.bitNs == (uint32_t)floor(bitNs) && d.i2cHz == baud && valido == (pioOk && i2cOk) &&
+                 d.valido == valido;
+    if (!igual && (*diferentes)++ < 5) {
+        CONFERIR(false, "%u Hz, I2C %u: PIO %u + %u/256, bit %u ns, I2C %u Hz, %s; referência %.4f, %.0f ns, %u Hz, %s",
+                 sysHz, i2cHz, d.pioDivInt, d.pioDivFrac, d.bitNs, d.i2cHz, valido ? "válido" : "inválido", div, bitNs,
+                 baud, pioOk && i2cOk ? "válido" : "inválido");
+    }
+    // Válido nunca deixa o I2C acima do pedido
+    if (valido && d.i2cHz > i2cHz && (*diferentes)++ < 5) {
+        CONFERIR(false, "%u Hz: I2C em %u Hz, acima dos %u pedidos", sysHz, d.i2cHz, i2cHz);
+    }
+}
+
+static void conferirVarredura() {
+    uint32_t diferentes = 0, validos = 0, total = 0;
+    for (uint32_t khz = 10000; khz <= 250000; khz += 1) {
+        conferirFrequencia(khz * 1000, I2C_HZ, &diferentes);
+        conferirFrequencia(khz * 1000, SSD1306_I2C_CLK_FAST_PLUS * 1000, &diferentes);
+        RelogioDivisores d;
+        validos += relogioCalcular(khz * 1000, I2C_HZ, &d);
+        total++;
+    }
+    printf("varredura de 10 a 250 MHz: %u de %u frequências válidas com I2C a %u kHz\n", validos, total,
+           SSD1306_I2C_CLK);
+    CONFERIR(diferentes == 0, "%u frequências diferentes da referência", diferentes);
+}
+
+static void conferirLimites() {
+    RelogioDivisores d;
+    CONFERIR(!relogioCalcular(0, I2C_HZ, &d) && !d.valido, "clk_sys zero aceito");
+    CONFERIR(!relogioCalcular(125000000, 0, &d) && !d.valido, "I2C zero aceito");
+    CONFERIR(!relogioCalcular(4000000, I2C_HZ, &d), "4 MHz: divisor da PIO abaixo de 1 aceito");
+    CONFERIR(!relogioCalcular(125000000, 100, &d), "I2C a 100 Hz: período acima do registrador aceito");
+}
+
+static void saida(const char *linha, void *ctx) {
+    int *linhas = ctx;
+    (*linhas)++;
+    CONFERIR(strncmp(linha, "CLK ", 4) == 0, "linha do relatório: %s", linha);
+}
+
+static void conferirContabilidade() {
+    // O boot começa em NORMAL; 1 s a 50% ocioso, 2 s em TURBO todo ocupado
+    relogioContabilizar(1000000, 500);
+    CONFERIR(relogioMudar(RELOGIO_TURBO) && relogioModo() == RELOGIO_TURBO, "troca para TURBO");
+    relogioContabilizar(3000000, 0);
+    relogioMudar(RELOGIO_NORMAL);
+    const RelogioStats *normal = relogioStats(RELOGIO_NORMAL), *turbo = relogioStats(RELOGIO_TURBO);
+    CONFERIR(normal->tempoUs == 1000000 && normal->ocupadoUs == 500000 && normal->entradas == 2,
+             "NORMAL: %llu us, %llu ocupados, %u entradas", (unsigned long long)normal->tempoUs,
+             (unsigned long long)normal->ocupadoUs, normal->entradas);
+    CONFERIR(turbo->tempoUs == 2000000 && turbo->ocupadoUs == 2000000 && turbo->entradas == 1,
+             "TURBO: %llu us, %llu ocupados, %u entradas", (unsigned long long)turbo->tempoUs,
+             (unsigned long long)turbo->ocupadoUs, turbo->entradas);
+    int linhas = 0;
+    relogioRelatorio(saida, &linhas);
+    CONFERIR(linhas == RELOGIO_NUM_MODOS, "relatório com %d linhas", linhas);
+}
+
+int main() {
+    conferirPerfis();
+    conferirVarredura();
+    conferirLimites();
+    conferirContabilidade();
+    return testeResultado();
+}
@@ -0,0 +1,106 @@
+// Atualização por regiões sujas do OLED, com o barramento simulado do
+// sim_oled.c: a RAM do display tem que ficar igual ao framebuffer depois de
+// cada SSD1306_update() e os bytes no I2C têm que ser só os das colunas que
+// mudaram, mais 7 de endereço e 1 de controle por área.
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim_oled.h"
+#include "ssd1306.h"
+#include "ssd1306_gfx.h"
+#include "teste.h"
+
+#define BYTES_AREA(colunas, paginas) (7 + 1 + (colunas) * (paginas))
+#define BYTES_QUADRO_INTEIRO (1 + SSD1306_BUF_LEN) // O envio antigo, um quadro por update
+
+// Bytes que um update pôs no barramento
+static uint32_t atualizar() {
+    uint32_t antes = simOledBytes();
+    SSD1306_update();
+    return simOledBytes() - antes;
+}
+
+static void conferirRam(const char *nome) {
+    CONFERIR(memcmp(simOledRam(), SSD1306_framebuffer(), SSD1306_BUF_LEN) == 0, "%s: RAM do display diferente",
+             nome);
+}
+
+int main() {
+    SSD1306_set_transport(&simOledTransporte);
+    SSD1306_init();
+    uint8_t *fb = SSD1306_framebuffer();
+    conferirRam("init");
+
+    uint32_t quadros = simOledQuadros();
+    CONFERIR(atualizar() == 0 && simOledQuadros() == quadros, "update sem mudança mandou um quadro");
+
+    SetPixel(fb, 70, 13, true);
+    uint32_t n = atualizar();
+    CONFERIR(n == BYTES_AREA(1, 1), "um pixel: %u bytes", n);
+    conferirRam("um pixel");
+
+    // Pixel já aceso: desenha, mas o conteúdo não muda; a coluna vai de novo
+    SetPixel(fb, 70, 13, true);
+    n = atualizar();
+    CONFERIR(n == BYTES_AREA(1, 1), "pixel repetido: %u bytes", n);
+
+    // Linha de volume do updateOLED: 10 caracteres de 8 colunas numa página
+    WriteString(fb, 0, 8, "- - - - - ");
+    n = atualizar();
+    CONFERIR(n == BYTES_AREA(80, 1), "linha de volume: %u bytes", n);
+    CONFERIR(n < BYTES_QUADRO_INTEIRO / 5, "linha de volume: %u bytes, quadro inteiro %u", n, BYTES_QUADRO_INTEIRO);
+    conferirRam("linha de volume");
+
+    // Páginas seguidas com o mesmo trecho sujo saem numa área só
+    FillRect(fb, 20, 0, 30, SSD1306_HEIGHT, true);
+    n = atualizar();
+    CONFERIR(n == BYTES_AREA(30, SSD1306_NUM_PAGES), "retângulo em todas as páginas: %u bytes", n);
+    conferirRam("retângulo");
+
+    // Trechos diferentes em cada página: uma área por página
+    SetPixel(fb, 1, 0, false);
+    SetPixel(fb, 100, 9, true);
+    DrawHLine(fb, 40, 59, 20, false);
+    n = atualizar();
+    CONFERIR(n == BYTES_AREA(1, 1) + BYTES_AREA(1, 1) + BYTES_AREA(20, 1), "três páginas diferentes: %u bytes", n);
+    conferirRam("três páginas");
+
+    // Dois desenhos na mesma página antes do update juntam os trechos
+    SetPixel(fb, 10, 30, true);
+    SetPixel(fb, 12, 31, true);
+    n = atualizar();
+    CONFERIR(n == BYTES_AREA(3, 1), "dois pixels próximos: %u bytes", n);
+
+    SSD1306_clear();
+    n = atualizar();
+    CONFERIR(n == BYTES_AREA(SSD1306_WIDTH, SSD1306_NUM_PAGES), "tela limpa: %u bytes", n);
+    conferirRam("tela limpa");
+
+    // Desenho aleatório: a RAM acompanha e nunca sai mais que um quadro inteiro
+    // mais os endereços de cada página
+    srand(2);
+    for (int i = 0; i < 2000; i++) {
+        int x0 = rand() % 140 - 6, y0 = rand() % 40 - 4;
+        int x1 = rand() % 140 - 6, y1 = rand() % 40 - 4;
+        switch (rand() % 4) {
+        case 0:
+            SetPixel(fb, x0, y0, rand() & 1);
+            break;
+        case 1:
+            DrawLine(fb, x0, y0, x1, y1, rand() & 1);
+            break;
+        case 2:
+            FillRect(fb, x0, y0, rand() % 30, rand() % 20, rand() & 1);
+            break;
+        default:
+            WriteString(fb, abs(x0) % SSD1306_WIDTH, abs(y0) % SSD1306_HEIGHT, "AB12");
+            break;
+        }
+        if (rand() % 3 == 0) {
+            n = atualizar();
+            CONFERIR(n <= SSD1306_NUM_PAGES * BYTES_AREA(SSD1306_WIDTH, 1), "desenho %d: %u bytes", i, n);
+            conferirRam("desenho aleatório");
+        }
+    }
+    return testeResultado();
+}
@@ -0,0 +1,171 @@
+// Texto 5x7: cada célula desenhada pelo DrawText, em qualquer x e y (com
+// corte nas bordas), opaca ou transparente, contra uma referência pixel a
+// pixel; UTF-8 com as letras acentuadas e '?' para o resto; rótulos que só
+// redesenham e mandam ao display as células que mudaram; e, só mostrados, os
+// caracteres por segundo contra o WriteString antigo de 8x8.
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim_oled.h"
+#include "ssd1306.h"
+#include "ssd1306_font5x7.h"
+#include "ssd1306_text.h"
+#include "teste.h"
+
+static uint8_t fundo[SSD1306_BUF_LEN];
+static uint8_t ref[SSD1306_BUF_LEN];
+static uint8_t agora[SSD1306_BUF_LEN];
+
+static void pixel(uint8_t *buf, int x, int y, bool on) {
+    if (x < 0 || x >= SSD1306_WIDTH || y < 0 || y >= SSD1306_HEIGHT) {
+        return;
+    }
+    if (on) {
+        buf[(y / 8) * SSD1306_WIDTH + x] |= 1 << (y % 8);
+    } else {
+        buf[(y / 8) * SSD1306_WIDTH + x] &= ~(1 << (y % 8));
+    }
+}
+
+// Uma célula de TEXT_ADVANCE x TEXT_HEIGHT pixels, a última coluna vazia
+static void refCelula(uint8_t *buf, int x, int y, const uint8_t *glifo, bool opaco) {
+    for (int c = 0; c < TEXT_ADVANCE; c++) {
+        for (int r = 0; r < TEXT_HEIGHT; r++) {
+            bool aceso = c < FONT5X7_WIDTH && ((glifo[c] >> r) & 1);
+            if (aceso || opaco) {
+                pixel(buf, x + c, y + r, aceso);
+            }
+        }
+    }
+}
+
+static void conferirCelulas() {
+    srand(18);
+    for (size_t i = 0; i < sizeof(fundo); i++) {
+        fundo[i] = rand();
+    }
+    uint32_t diferentes = 0, casos = 0;
+    for (int y = -TEXT_HEIGHT - 1; y <= SSD1306_HEIGHT; y++) {
+        for (int x = -TEXT_ADVANCE - 1; x <= SSD1306_WIDTH; x += 3) {
+            for (int opaco = 0; opaco < 2; opaco++) {
+                char str[2] = {(char)(FONT5X7_FIRST + rand() % (FONT5X7_LAST - FONT5X7_FIRST + 1)), 0};
+                memcpy(ref, fundo, sizeof(ref));
+                memcpy(agora, fundo, sizeof(agora));
+                refCelula(ref, x, y, font5x7[str[0] - FONT5X7_FIRST], opaco);
+                DrawText(agora, x, y, str, opaco);
+                casos++;
+                if (memcmp(ref, agora, sizeof(ref)) != 0 && diferentes++ < 5) {
+                    CONFERIR(false, "'%s' em (%d, %d) %s diferente da referência", str, x, y,
+                             opaco ? "opaco" : "transparente");
+                }
+            }
+        }
+    }
+    CONFERIR(diferentes == 0, "%u de %u células diferentes", diferentes, casos);
+}
+
+static void conferirUtf8() {
+    // "ção" são três células: c cedilha, a til e o
+    CONFERIR(TextWidth("ção") == 3 * TEXT_ADVANCE, "largura de \"ção\": %d", TextWidth("ção"));
+    CONFERIR(TextWidth("€") == TEXT_ADVANCE, "caractere de 3 bytes não é uma célula só");
+
+    memset(ref, 0, sizeof(ref));
+    memset(agora, 0, sizeof(agora));
+    refCelula(ref, 0, 3, font5x7[font5x7_latin1[0xE7 - 0xA0]], true);
+    refCelula(ref, 6, 3, font5x7[font5x7_latin1[0xE3 - 0xA0]], true);
+    refCelula(ref, 12, 3, font5x7['o' - FONT5X7_FIRST], true);
+    refCelula(ref, 18, 3, font5x7['?' - FONT5X7_FIRST], true); // Fora da fonte
+    refCelula(ref, 24, 3, font5x7['?' - FONT5X7_FIRST], true); // UTF-8 inválido
+    DrawText(agora, 0, 3, "ção€\xff", true);
+    CONFERIR(memcmp(ref, agora, sizeof(ref)) == 0, "acentos e '?' diferentes da referência");
+}
+
+// Bytes no barramento para levar o framebuffer ao display
+static uint32_t atualizar() {
+    uint32_t antes = simOledBytes();
+    SSD1306_update();
+    return simOledBytes() - antes;
+}
+
+static void conferirRotulo() {
+    SSD1306_set_transport(&simOledTransporte);
+    SSD1306_init();
+    uint8_t *fb = SSD1306_framebuffer();
+    struct text_label r;
+    TextLabelInit(&r, 10, 12);
+
+    CONFERIR(DrawLabel(fb, &r, "Volume: 10"), "primeiro desenho");
+    uint32_t n = atualizar();
+    // y = 12 ocupa duas páginas com o mesmo trecho: uma área só
+    CONFERIR(n == 7 + 1 + 2 * 10 * TEXT_ADVANCE, "rótulo novo: %u bytes", n);
+
+    CONFERIR(!DrawLabel(fb, &r, "Volume: 10"), "mesmo texto redesenhado");
+    CONFERIR(atualizar() == 0, "mesmo texto mandou bytes");
+
+    CONFERIR(DrawLabel(fb, &r, "Volume: 11"), "texto mudou e não desenhou");
+    n = atualizar();
+    CONFERIR(n == 7 + 1 + 2 * TEXT_ADVANCE, "uma célula mudou: %u bytes", n);
+
+    CONFERIR(DrawLabel(fb, &r, "Volume: 9"), "texto encurtou e não desenhou");
+    n = atualizar();
+    CONFERIR(n == 7 + 1 + 2 * 2 * TEXT_ADVANCE, "texto mais curto: %u bytes", n);
+
+    memset(ref, 0, sizeof(ref));
+    DrawText(ref, 10, 12, "Volume: 9", true);
+    CONFERIR(memcmp(ref, simOledRam(), sizeof(ref)) == 0, "display diferente do texto final");
+}
+
+static double segundos() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static const char *texto = "INTENSIDADE 1234";
+
+static void escreverAntes(uint8_t *buf, int i) {
+    WriteString(buf, 0, (i & 3) * 8, (char *)texto);
+}
+
+static void escreverAlinhado(uint8_t *buf, int i) {
+    DrawText(buf, 0, (i & 3) * 8, texto, true);
+}
+
+static void escreverQualquerY(uint8_t *buf, int i) {
+    DrawText(buf, 0, 3 + (i & 15), texto, true);
+}
+
+// Milhões de caracteres por segundo
+static double medir(void (*escrever)(uint8_t *buf, int i)) {
+    uint8_t *fb = SSD1306_framebuffer();
+    double t0 = segundos(), t;
+    long n = 0;
+    do {
+        for (int i = 0; i < 10000; i++) {
+            escrever(fb, i);
+        }
+        n += 10000;
+        t = segundos();
+    } while (t - t0 < 0.2);
+    return n * strlen(texto) / (t - t0) / 1e6;
+}
+
+static void medirVelocidade() {
+    medir(escreverAntes); // Aquece
+    double antes = medir(escreverAntes);
+    double alinhado = medir(escreverAlinhado);
+    double qualquerY = medir(escreverQualquerY);
+    // Só informativo: a razão entre os caminhos no host depende do compilador
+    // e da máquina, e não diz nada do RP2040
+    printf("Mchar/s: WriteString %.1f, DrawText alinhado %.1f (%.2fx), em qualquer y %.1f (%.2fx)\n", antes,
+           alinhado, alinhado / antes, qualquerY, qualquerY / antes);
+}
+
+int main() {
+    conferirCelulas();
+    conferirUtf8();
+    conferirRotulo();
+    medirVelocidade();
+    return testeResultado();
+}
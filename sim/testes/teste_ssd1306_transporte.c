@@ -0,0 +1,104 @@
+// Transporte assíncrono do OLED: com o barramento ocupado, os updates só
+// acumulam as regiões sujas, e o SSD1306_poll() manda tudo num quadro só
+// quando o anterior termina. O transporte daqui aplica cada quadro no SSD1306
+// simulado do sim_oled.c e fica ocupado até o teste liberar.
+
+#include <string.h>
+#include "sim_oled.h"
+#include "ssd1306.h"
+#include "ssd1306_gfx.h"
+#include "teste.h"
+
+static bool ocupado;
+static uint32_t iniciados;
+static uint32_t concluidos;
+
+static void iniciar(const uint32_t *palavras, int n) {
+    CONFERIR(!ocupado, "quadro iniciado com o barramento ocupado");
+    simOledTransporte.start(palavras, n);
+    ocupado = true;
+    iniciados++;
+}
+
+static bool estaOcupado(void) {
+    return ocupado;
+}
+
+static const struct ssd1306_transport lento = {
+    .start = iniciar,
+    .busy = estaOcupado,
+};
+
+static void quadroConcluido(void) {
+    concluidos++;
+}
+
+static void conferirRam(const char *nome) {
+    CONFERIR(memcmp(simOledRam(), SSD1306_framebuffer(), SSD1306_BUF_LEN) == 0, "%s: RAM do display diferente",
+             nome);
+}
+
+int main() {
+    SSD1306_set_transport(&lento);
+    SSD1306_set_done_callback(quadroConcluido);
+    SSD1306_init();
+    uint8_t *fb = SSD1306_framebuffer();
+
+    // Os comandos de init ocupam o barramento; a tela limpa fica pendente e
+    // sai no primeiro poll depois deles
+    CONFERIR(iniciados == 1 && SSD1306_busy(), "init: %u envios", iniciados);
+    ocupado = false;
+    SSD1306_poll();
+    CONFERIR(iniciados == 2 && concluidos == 0, "tela limpa do init: %u envios, %u concluídos", iniciados,
+             concluidos);
+    conferirRam("init");
+
+    // Vários updates com o barramento ocupado viram um quadro só
+    SetPixel(fb, 5, 5, true);
+    SSD1306_update();
+    uint32_t bytes = simOledBytes();
+    for (int i = 0; i < 10; i++) {
+        DrawHLine(fb, 10 * i, 10 * i + 5, 20, true);
+        SSD1306_update();
+        SSD1306_poll();
+    }
+    CONFERIR(iniciados == 2, "%u quadros iniciados com o barramento ocupado", iniciados - 2);
+    CONFERIR(SSD1306_busy(), "regiões pendentes não aparecem em SSD1306_busy()");
+    CONFERIR(concluidos == 0, "callback antes do fim do quadro");
+
+    ocupado = false;
+    SSD1306_poll();
+    CONFERIR(concluidos == 1, "callback da tela limpa: %u", concluidos);
+    CONFERIR(iniciados == 3, "%u quadros para os updates acumulados", iniciados - 2);
+    // O pixel na página 0 e as dez linhas na página 2, que juntam num trecho
+    // só de 0 a 95
+    uint32_t n = simOledBytes() - bytes;
+    CONFERIR(n == (7 + 1 + 1) + (7 + 1 + 96), "updates acumulados: %u bytes", n);
+    conferirRam("updates acumulados");
+
+    ocupado = false;
+    SSD1306_poll();
+    CONFERIR(concluidos == 2 && !SSD1306_busy(), "quadro acumulado não concluiu");
+
+    // Nada pendente: poll não inicia nada
+    uint32_t quadros = iniciados;
+    SSD1306_poll();
+    CONFERIR(iniciados == quadros, "poll sem regiões sujas iniciou um quadro");
+
+    // Quadros por segundo: 50 quadros num segundo do relógio virtual
+    SSD1306_poll();
+    sleep_ms(1000);
+    SSD1306_poll();
+    for (int i = 0; i < 50; i++) {
+        SetPixel(fb, i, 30, true);
+        SSD1306_update();
+        sleep_ms(19);
+        ocupado = false;
+        SSD1306_poll();
+    }
+    sleep_ms(1000 - 50 * 19);
+    SSD1306_poll();
+    CONFERIR(SSD1306_fps() == 50, "%u quadros por segundo", SSD1306_fps());
+    conferirRam("quadros por segundo");
+    return testeResultado();
+}
@@ -0,0 +1,186 @@
+// Telas pré-renderizadas (telas.txt -> telas.h, gerado no build pelo
+// tools/gerar_telas.py): cada tela e cada variante de trecho tem que ser
+// byte a byte o que o DrawText opaco desenha em tempo de execução com os
+// mesmos textos, e trocar a variante com SSD1306_blit() tem que mandar ao
+// display só as colunas que mudaram, como o updateOLED espera.
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim_oled.h"
+#include "ssd1306.h"
+#include "ssd1306_text.h"
+#include "telas.h"
+#include "teste.h"
+
+#define BYTES_AREA(colunas, paginas) (7 + 1 + (colunas) * (paginas))
+#define MAX_TEXTOS 16
+
+typedef struct {
+    int x, y;
+    char texto[64];
+} Texto;
+
+typedef struct {
+    const char *nome;
+    bool trecho;
+    const uint8_t *bitmap; // Variantes seguidas, LARGURA * PAGINAS bytes cada
+    int x, pagina, largura, paginas, variantes;
+    Texto textos[MAX_TEXTOS];
+    int n;
+    bool lido;
+} Definicao;
+
+static Definicao definicoes[] = {
+    {"VOLUME", false, telaVolume, 0, 0, SSD1306_WIDTH, SSD1306_NUM_PAGES, 1},
+    {"VOLUME_NIVEL", true, trechoVolumeNivel[0], TRECHO_VOLUME_NIVEL_X, TRECHO_VOLUME_NIVEL_PAGINA,
+     TRECHO_VOLUME_NIVEL_LARGURA, TRECHO_VOLUME_NIVEL_PAGINAS, TRECHO_VOLUME_NIVEL_VARIANTES},
+};
+#define N_DEFINICOES (int)(sizeof(definicoes) / sizeof(definicoes[0]))
+
+// Lê telas.txt com as mesmas regras do gerador; devolve false se alguma tela
+// ou trecho de lá não tem bitmap correspondente aqui
+static bool lerDefinicoes() {
+    FILE *f = fopen(TELAS_TXT, "r");
+    if (!f) {
+        CONFERIR(false, "não abriu %s", TELAS_TXT);
+        return false;
+    }
+    char linha[256], tipo[16], nome[64];
+    Definicao *atual = NULL;
+    bool ok = true;
+    while (fgets(linha, sizeof(linha), f)) {
+        char *p = linha + strspn(linha, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') {
+            continue;
+        }
+        int x, y;
+        if (sscanf(p, "texto %d %d", &x, &y) == 2 && atual) {
+            char *ini = strchr(p, '"'), *fim = strrchr(p, '"');
+            if (!ini || fim == ini || atual->n == MAX_TEXTOS) {
+                CONFERIR(false, "linha inválida: %s", p);
+                ok = false;
+                continue;
+            }
+            Texto *t = &atual->textos[atual->n++];
+            t->x = x;
+            t->y = y;
+            snprintf(t->texto, sizeof(t->texto), "%.*s", (int)(fim - ini - 1), ini + 1);
+        } else if (sscanf(p, "%15s %63s", tipo, nome) == 2) {
+            atual = NULL;
+            for (int i = 0; i < N_DEFINICOES; i++) {
+                if (strcmp(definicoes[i].nome, nome) == 0 && definicoes[i].trecho == (strcmp(tipo, "trecho") == 0)) {
+                    atual = &definicoes[i];
+                }
+            }
+            CONFERIR(atual != NULL, "%s %s de telas.txt sem bitmap no teste", tipo, nome);
+            ok = ok && atual;
+            if (atual) {
+                atual->lido = true;
+            }
+        }
+    }
+    fclose(f);
+    for (int i = 0; i < N_DEFINICOES; i++) {
+        CONFERIR(definicoes[i].lido, "%s não está em telas.txt", definicoes[i].nome);
+    }
+    return ok;
+}
+
+// Região x..x+largura, pagina..pagina+paginas de um buffer inteiro
+static void recortar(const uint8_t *buf, const Definicao *d, uint8_t *saida) {
+    for (int p = 0; p < d->paginas; p++) {
+        memcpy(&saida[p * d->largura], &buf[(d->pagina + p) * SSD1306_WIDTH + d->x], d->largura);
+    }
+}
+
+static void conferirBitmaps() {
+    static uint8_t buf[SSD1306_BUF_LEN], regiao[SSD1306_BUF_LEN];
+    for (int i = 0; i < N_DEFINICOES; i++) {
+        const Definicao *d = &definicoes[i];
+        int tamanho = d->largura * d->paginas;
+        int variantes = d->trecho ? d->n : 1;
+        CONFERIR(variantes == d->variantes, "%s: %d variantes em telas.txt, %d em telas.h", d->nome, variantes,
+                 d->variantes);
+        for (int v = 0; v < variantes && v < d->variantes; v++) {
+            memset(buf, 0, sizeof(buf));
+            if (d->trecho) {
+                DrawText(buf, d->textos[v].x, d->textos[v].y, d->textos[v].texto, true);
+            } else {
+                for (int t = 0; t < d->n; t++) {
+                    DrawText(buf, d->textos[t].x, d->textos[t].y, d->textos[t].texto, true);
+                }
+            }
+            recortar(buf, d, regiao);
+            const uint8_t *pronto = d->bitmap + v * tamanho;
+            int coluna = -1;
+            for (int b = 0; b < tamanho && coluna < 0; b++) {
+                if (pronto[b] != regiao[b]) {
+                    coluna = b;
+                }
+            }
+            CONFERIR(coluna < 0, "%s variante %d: byte %d é 0x%02x, DrawText desenha 0x%02x", d->nome, v, coluna,
+                     coluna < 0 ? 0 : pronto[coluna], coluna < 0 ? 0 : regiao[coluna]);
+            // Nada do que o DrawText desenhou pode ficar fora da região guardada
+            uint32_t aceso = 0, dentro = 0;
+            for (int b = 0; b < SSD1306_BUF_LEN; b++) {
+                aceso += __builtin_popcount(buf[b]);
+            }
+            for (int b = 0; b < tamanho; b++) {
+                dentro += __builtin_popcount(regiao[b]);
+            }
+            CONFERIR(aceso == dentro, "%s variante %d: %u pixels fora da região", d->nome, v, aceso - dentro);
+        }
+    }
+}
+
+// O caminho do updateOLED: tela inteira e depois cada troca de nível
+static void conferirTroca() {
+    SSD1306_set_transport(&simOledTransporte);
+    SSD1306_init();
+    SSD1306_update();
+    uint8_t *fb = SSD1306_framebuffer();
+    SSD1306_blit(telaVolume, 0, 0, SSD1306_WIDTH, SSD1306_NUM_PAGES);
+    SSD1306_blit(trechoVolumeNivel[0], TRECHO_VOLUME_NIVEL_X, TRECHO_VOLUME_NIVEL_PAGINA,
+                 TRECHO_VOLUME_NIVEL_LARGURA, TRECHO_VOLUME_NIVEL_PAGINAS);
+    SSD1306_update();
+    CONFERIR(memcmp(simOledRam(), fb, SSD1306_BUF_LEN) == 0, "tela do volume: RAM do display diferente");
+
+    static uint8_t antes[SSD1306_BUF_LEN];
+    int niveis[] = {1, 2, 3, 4, 5, 4, 2, 0, 5, 5};
+    for (size_t i = 0; i < sizeof(niveis) / sizeof(niveis[0]); i++) {
+        int nivel = niveis[i];
+        memcpy(antes, fb, sizeof(antes));
+        SSD1306_blit(trechoVolumeNivel[nivel], TRECHO_VOLUME_NIVEL_X, TRECHO_VOLUME_NIVEL_PAGINA,
+                     TRECHO_VOLUME_NIVEL_LARGURA, TRECHO_VOLUME_NIVEL_PAGINAS);
+
+        // Esperado: por página, do primeiro ao último byte que mudou
+        uint32_t esperado = 0;
+        for (int p = 0; p < SSD1306_NUM_PAGES; p++) {
+            int primeiro = -1, ultimo = -1;
+            for (int c = 0; c < SSD1306_WIDTH; c++) {
+                if (antes[p * SSD1306_WIDTH + c] != fb[p * SSD1306_WIDTH + c]) {
+                    primeiro = primeiro < 0 ? c : primeiro;
+                    ultimo = c;
+                }
+            }
+            if (primeiro >= 0) {
+                esperado += BYTES_AREA(ultimo - primeiro + 1, 1);
+            }
+        }
+        uint32_t bytes = simOledBytes();
+        SSD1306_update();
+        bytes = simOledBytes() - bytes;
+        CONFERIR(bytes == esperado, "nível %d: %u bytes no barramento, esperado %u", nivel, bytes, esperado);
+        CONFERIR(bytes <= BYTES_AREA(TRECHO_VOLUME_NIVEL_LARGURA, TRECHO_VOLUME_NIVEL_PAGINAS),
+                 "nível %d: %u bytes, mais que o trecho inteiro", nivel, bytes);
+        CONFERIR(memcmp(simOledRam(), fb, SSD1306_BUF_LEN) == 0, "nível %d: RAM do display diferente", nivel);
+    }
+}
+
+int main() {
+    if (lerDefinicoes()) {
+        conferirBitmaps();
+    }
+    conferirTroca();
+    return testeResultado();
+}
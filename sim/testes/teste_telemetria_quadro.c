@@ -0,0 +1,198 @@
+// Quadros de telemetria: CRC-16 contra o valor de conferência do
+// CRC-16/CCITT-FALSE e um cálculo bit a bit, COBS com os vetores conhecidos e
+// ida e volta em dados aleatórios, montagem e abertura de quadros, quadros
+// corrompidos recusados e ressincronização num fluxo com lixo no meio.
+
+#include <stdlib.h>
+#include <string.h>
+#include "telemetria_quadro.h"
+#include "teste.h"
+
+static uint16_t crcBitABit(const uint8_t *dados, size_t n) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= dados[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static void conferirCrc() {
+    CONFERIR(telemetriaCrc16((const uint8_t *)"123456789", 9) == 0x29B1, "valor de conferência: %04X",
+             telemetriaCrc16((const uint8_t *)"123456789", 9));
+    uint8_t dados[300];
+    for (int caso = 0; caso < 200; caso++) {
+        size_t n = rand() % sizeof(dados);
+        for (size_t i = 0; i < n; i++) {
+            dados[i] = rand();
+        }
+        CONFERIR(telemetriaCrc16(dados, n) == crcBitABit(dados, n), "CRC de %zu bytes", n);
+    }
+}
+
+static void conferirVetor(const char *nome, const uint8_t *entrada, size_t n, const uint8_t *esperado, size_t m) {
+    uint8_t saida[TELEMETRIA_MAX_QUADRO];
+    uint8_t volta[TELEMETRIA_MAX_QUADRO];
+    size_t tam = cobsCodificar(entrada, n, saida);
+    CONFERIR(tam == m && memcmp(saida, esperado, m) == 0, "COBS %s: %zu bytes, esperado %zu", nome, tam, m);
+    size_t tamVolta = cobsDecodificar(saida, tam - 1, volta);
+    CONFERIR(tamVolta == n && memcmp(volta, entrada, n) == 0, "COBS %s: volta com %zu bytes", nome, tamVolta);
+}
+
+static void conferirCobs() {
+    conferirVetor("vazio", NULL, 0, (const uint8_t[]){0x01, 0x00}, 2);
+    conferirVetor("00", (const uint8_t[]){0x00}, 1, (const uint8_t[]){0x01, 0x01, 0x00}, 3);
+    conferirVetor("00 00", (const uint8_t[]){0x00, 0x00}, 2, (const uint8_t[]){0x01, 0x01, 0x01, 0x00}, 4);
+    conferirVetor("11 22 00 33", (const uint8_t[]){0x11, 0x22, 0x00, 0x33}, 4,
+                  (const uint8_t[]){0x03, 0x11, 0x22, 0x02, 0x33, 0x00}, 6);
+    conferirVetor("11 00 00 00", (const uint8_t[]){0x11, 0x00, 0x00, 0x00}, 4,
+                  (const uint8_t[]){0x02, 0x11, 0x01, 0x01, 0x01, 0x00}, 6);
+
+    // 254 bytes sem zero fecham um bloco de código FF; 255 abrem outro
+    static uint8_t entrada[255], esperado[260];
+    for (int i = 0; i < 255; i++) {
+        entrada[i] = i + 1;
+    }
+    esperado[0] = 0xFF;
+    memcpy(&esperado[1], entrada, 254);
+    esperado[255] = 0x01;
+    esperado[256] = 0x00;
+    conferirVetor("254 sem zero", entrada, 254, esperado, 257);
+    esperado[255] = 0x02;
+    esperado[256] = 0xFF;
+    esperado[257] = 0x00;
+    conferirVetor("255 sem zero", entrada, 255, esperado, 258);
+
+    // Aleatórios com proporções diferentes de zeros
+    uint8_t dados[TELEMETRIA_MAX_PACOTE], quadro[TELEMETRIA_MAX_QUADRO], volta[TELEMETRIA_MAX_QUADRO];
+    for (int caso = 0; caso < 3000; caso++) {
+        size_t n = rand() % (TELEMETRIA_MAX_PACOTE + 1);
+        int zeros = caso % 4 == 0 ? 0 : 1 + caso % 50; // Um zero a cada tantos bytes, em média
+        for (size_t i = 0; i < n; i++) {
+            dados[i] = zeros && rand() % zeros == 0 ? 0 : 1 + rand() % 255;
+        }
+        size_t tam = cobsCodificar(dados, n, quadro);
+        CONFERIR(tam <= n + n / 254 + 2, "COBS de %zu bytes com %zu", n, tam);
+        CONFERIR(memchr(quadro, 0, tam - 1) == NULL && quadro[tam - 1] == 0, "zero dentro do quadro de %zu", n);
+        size_t tamVolta = cobsDecodificar(quadro, tam - 1, volta);
+        CONFERIR(tamVolta == n && memcmp(volta, dados, n) == 0, "volta de %zu bytes com %zu", n, tamVolta);
+    }
+
+    // Quadros inválidos: zero no meio, código passando do fim
+    CONFERIR(cobsDecodificar((const uint8_t[]){0x03, 0x11, 0x00}, 3, volta) == 0, "zero dentro do bloco");
+    CONFERIR(cobsDecodificar((const uint8_t[]){0x05, 0x11, 0x22}, 3, volta) == 0, "código além do fim");
+}
+
+static void aleatorio(TelemetriaCabecalho *cab, uint8_t *carga, size_t *tam) {
+    cab->tipo = 1 + rand() % 5;
+    cab->decimacao = rand();
+    cab->n = rand();
+    cab->seq = (uint32_t)rand() << 8 ^ rand();
+    cab->instante = (uint64_t)rand() << 33 ^ (uint64_t)rand() << 8 ^ rand();
+    *tam = rand() % 4 == 0 ? TELEMETRIA_MAX_CARGA : rand() % (TELEMETRIA_MAX_CARGA + 1);
+    for (size_t i = 0; i < *tam; i++) {
+        carga[i] = rand() % 3 == 0 ? 0 : rand();
+    }
+}
+
+static bool igual(const TelemetriaCabecalho *a, const TelemetriaCabecalho *b) {
+    return a->tipo == b->tipo && a->decimacao == b->decimacao && a->n == b->n && a->seq == b->seq &&
+           a->instante == b->instante;
+}
+
+static void conferirQuadros() {
+    TelemetriaCabecalho cab, lido;
+    uint8_t carga[TELEMETRIA_MAX_CARGA], cargaLida[TELEMETRIA_MAX_CARGA];
+    uint8_t quadro[TELEMETRIA_MAX_QUADRO];
+    size_t tam, tamLido;
+
+    for (int caso = 0; caso < 500; caso++) {
+        aleatorio(&cab, carga, &tam);
+        size_t n = telemetriaMontarQuadro(&cab, carga, tam, quadro);
+        CONFERIR(n > 0 && n <= TELEMETRIA_MAX_QUADRO, "quadro com %zu bytes", n);
+        bool ok = telemetriaAbrirQuadro(quadro, n - 1, &lido, cargaLida, &tamLido);
+        CONFERIR(ok && igual(&cab, &lido) && tamLido == tam && memcmp(carga, cargaLida, tam) == 0,
+                 "ida e volta com %zu bytes de carga", tam);
+
+        // Um bit trocado em qualquer posição: o CRC (ou o COBS) recusa
+        if (caso % 10 == 0) {
+            for (size_t i = 0; i < n - 1; i++) {
+                for (int b = 0; b < 8; b++) {
+                    quadro[i] ^= 1 << b;
+                    CONFERIR(!telemetriaAbrirQuadro(quadro, n - 1, &lido, cargaLida, &tamLido),
+                             "bit %d do byte %zu trocado e aceito", b, i);
+                    quadro[i] ^= 1 << b;
+                }
+            }
+        }
+    }
+
+    // Carga maior que o máximo não monta
+    aleatorio(&cab, carga, &tam);
+    uint8_t grande[TELEMETRIA_MAX_CARGA + 1] = {0};
+    CONFERIR(telemetriaMontarQuadro(&cab, grande, sizeof(grande), quadro) == 0, "carga acima do máximo montou");
+}
+
+// Fluxo de quadros com lixo entre alguns deles: o receptor separa nos zeros,
+// recusa os pedaços inválidos e recupera todos os quadros inteiros. Lixo que
+// não termina num zero gruda no quadro seguinte, que também se perde.
+static void conferirRessincronizacao() {
+    static uint8_t fluxo[200 * (TELEMETRIA_MAX_QUADRO + 20)];
+    size_t fim = 0;
+    uint32_t inteiros = 0;
+    TelemetriaCabecalho cab;
+    uint8_t carga[TELEMETRIA_MAX_CARGA];
+    size_t tam;
+
+    for (int i = 0; i < 200; i++) {
+        bool grudado = false;
+        if (i % 7 == 3) {
+            for (int k = 0; k < 15; k++) {
+                fluxo[fim++] = rand() % 4 == 0 ? 0 : rand(); // Lixo, com zeros no meio
+            }
+            grudado = fluxo[fim - 1] != 0;
+        }
+        aleatorio(&cab, carga, &tam);
+        cab.seq = i;
+        size_t n = telemetriaMontarQuadro(&cab, carga, tam, &fluxo[fim]);
+        if (i % 11 == 5) {
+            memmove(&fluxo[fim], &fluxo[fim + n / 2], n - n / 2); // Perdeu o começo
+            n -= n / 2;
+        } else if (!grudado) {
+            inteiros++;
+        }
+        fim += n;
+    }
+
+    uint32_t recebidos = 0, invalidos = 0;
+    int64_t ultimoSeq = -1;
+    size_t inicio = 0;
+    for (size_t i = 0; i < fim; i++) {
+        if (fluxo[i] != 0) {
+            continue;
+        }
+        TelemetriaCabecalho lido;
+        uint8_t cargaLida[TELEMETRIA_MAX_CARGA];
+        if (i > inicio && telemetriaAbrirQuadro(&fluxo[inicio], i - inicio, &lido, cargaLida, &tam)) {
+            CONFERIR((int64_t)lido.seq > ultimoSeq, "seq %u depois de %lld", lido.seq, (long long)ultimoSeq);
+            ultimoSeq = lido.seq;
+            recebidos++;
+        } else {
+            invalidos++;
+        }
+        inicio = i + 1;
+    }
+    CONFERIR(recebidos == inteiros, "%u quadros recebidos de %u inteiros", recebidos, inteiros);
+    CONFERIR(invalidos > 0, "nenhum pedaço inválido no fluxo com lixo");
+}
+
+int main() {
+    srand(3);
+    conferirCrc();
+    conferirCobs();
+    conferirQuadros();
+    conferirRessincronizacao();
+    return testeResultado();
+}
@@ -0,0 +1,74 @@
+// Tabela de tons: para cada clk_sys da placa, a frequência que cada par
+// (divisor, wrap) gera de fato, recalculada aqui em ponto flutuante, contra a
+// pedida. Imprime o erro máximo e médio de cada clock ao lado do cálculo antigo
+// do pwmBuzzer (divisor 4, wrap = clk / freq no registrador de 16 bits).
+
+#include <math.h>
+#include "tom.h"
+#include "teste.h"
+
+#define ERRO_MAX_PPM 100 // Bem abaixo do que se ouve (~0,3% = 3000 ppm)
+
+static const uint32_t clocks[] = {48000000, 125000000, 133000000, 200000000};
+
+static double gerada(uint32_t clkHz, const TomPwm *p) {
+    return clkHz / (p->div16 / 16.0 * (p->wrap + 1.0));
+}
+
+// pwmBuzzer() antes da tabela: o wrap de 32 bits era truncado no registrador
+static double geradaAntes(uint32_t clkHz, uint32_t freq) {
+    uint16_t wrap = clkHz / freq;
+    return clkHz / (4.0 * (wrap + 1.0));
+}
+
+static double ppm(double obtida, double pedida) {
+    return fabs(obtida - pedida) / pedida * 1e6;
+}
+
+int main() {
+    printf("%10s %12s %12s %14s\n", "clk (MHz)", "máx (ppm)", "médio (ppm)", "antes máx (%)");
+    for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+        uint32_t clk = clocks[c];
+        uint32_t informado = tomTabelaInit(clk);
+        double maximo = 0, soma = 0, maximoAntes = 0;
+        uint32_t wrapMin = UINT32_MAX;
+
+        for (uint32_t f = TOM_FREQ_MIN; f <= TOM_FREQ_MAX; f++) {
+            const TomPwm *p = tomTabela(f);
+            CONFERIR(p->div16 >= 16 && p->div16 <= 0xFFF, "%u Hz a %u MHz: divisor %u/16", f, clk / 1000000,
+                     p->div16);
+            double erro = ppm(gerada(clk, p), f);
+            soma += erro;
+            maximo = fmax(maximo, erro);
+            maximoAntes = fmax(maximoAntes, ppm(geradaAntes(clk, f), f));
+            if (p->wrap < wrapMin) {
+                wrapMin = p->wrap;
+            }
+
+            // Nenhum dos oito divisores a partir do menor que cabe dá erro menor
+            // (o erro é comparado em ppm inteiros, então empata dentro de 1 ppm)
+            uint32_t minimo = (((uint64_t)clk << 4) / f + 65535) >> 16;
+            for (uint32_t div16 = minimo < 16 ? 16 : minimo; div16 < minimo + 8 && div16 <= 0xFFF; div16++) {
+                double top = round(clk * 16.0 / (div16 * (double)f));
+                if (top >= 2 && top <= 65536) {
+                    TomPwm outro = {(uint16_t)(top - 1), (uint16_t)div16};
+                    CONFERIR(ppm(gerada(clk, &outro), f) >= erro - 1, "%u Hz a %u MHz: divisor %u/16 é melhor", f,
+                             clk / 1000000, div16);
+                }
+            }
+        }
+
+        printf("%10.0f %12.1f %12.1f %14.0f\n", clk / 1e6, maximo, soma / TOM_NUM_FREQ, maximoAntes / 1e4);
+        CONFERIR(fabs(maximo - informado) <= 1, "%u MHz: tomTabelaInit informou %u ppm, medido %.1f", clk / 1000000,
+                 informado, maximo);
+        CONFERIR(maximo <= ERRO_MAX_PPM, "%u MHz: erro máximo %.1f ppm", clk / 1000000, maximo);
+        // Resolução do volume: mais de 13 bits de duty em toda a faixa, mesmo a
+        // 48 MHz e 2 kHz, onde o divisor já é 1
+        CONFERIR(wrapMin >= 10000, "%u MHz: wrap mínimo %u", clk / 1000000, wrapMin);
+    }
+
+    // Fora da faixa a tabela limita
+    CONFERIR(tomTabela(10) == tomTabela(TOM_FREQ_MIN) && tomTabela(60000) == tomTabela(TOM_FREQ_MAX),
+             "frequência fora da faixa não foi limitada");
+    return testeResultado();
+}
@@ -5,7 +5,19 @@ extern void SSD1306_send_cmd_list(uint8_t *buf, int num);
 extern void SSD1306_send_buf(uint8_t buf[], int buflen);
 extern void SSD1306_init();
 extern void SSD1306_scroll(bool on);
+extern void SSD1306_scroll_one_column(bool left, uint8_t start_page, uint8_t end_page);
 extern void render(uint8_t *buf, struct render_area *area);
+extern uint8_t *SSD1306_framebuffer();
+extern void SSD1306_mark_dirty(int x0, int x1, int page0, int page1);
+extern void SSD1306_clear();
+extern void SSD1306_blit(const uint8_t *src, int x, int page, int width, int pages);
+extern void SSD1306_update();
+extern void SSD1306_poll();
+extern bool SSD1306_busy();
+extern uint32_t SSD1306_fps();
+extern uint SSD1306_set_clock_khz(uint khz);
+extern void SSD1306_set_transport(const struct ssd1306_transport *t);
+extern void SSD1306_set_done_callback(void (*cb)(void));
 extern void SetPixel(uint8_t *buf, int x, int y, bool on);
 extern void DrawLine(uint8_t *buf, int x0, int y0, int x1, int y1, bool on);
 extern void WriteChar(uint8_t *buf, int16_t x, int16_t y, uint8_t ch);
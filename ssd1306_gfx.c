@@ -0,0 +1,181 @@
+#include <string.h>
+#include "ssd1306_gfx.h"
+#include "ssd1306.h"
+
+// Columns x0..x1 of one page row, already clipped
+static inline void span(uint8_t *row, int x0, int x1, uint8_t mask, bool on)
+{
+  if (mask == 0xFF)
+  {
+    memset(&row[x0], on ? 0xFF : 0x00, x1 - x0 + 1);
+    return;
+  }
+  if (on)
+  {
+    for (int x = x0; x <= x1; x++)
+      row[x] |= mask;
+  }
+  else
+  {
+    uint8_t keep = ~mask;
+    for (int x = x0; x <= x1; x++)
+      row[x] &= keep;
+  }
+}
+
+// Orders and clips an inclusive area; false if nothing is left on screen
+static bool clip(int *x0, int *x1, int *y0, int *y1)
+{
+  int t;
+  if (*x0 > *x1)
+  {
+    t = *x0;
+    *x0 = *x1;
+    *x1 = t;
+  }
+  if (*y0 > *y1)
+  {
+    t = *y0;
+    *y0 = *y1;
+    *y1 = t;
+  }
+  if (*x0 < 0)
+    *x0 = 0;
+  if (*x1 > SSD1306_WIDTH - 1)
+    *x1 = SSD1306_WIDTH - 1;
+  if (*y0 < 0)
+    *y0 = 0;
+  if (*y1 > SSD1306_HEIGHT - 1)
+    *y1 = SSD1306_HEIGHT - 1;
+  return *x0 <= *x1 && *y0 <= *y1;
+}
+
+// Clipped area: one span per page, masked only on the first and last page
+static void fill(uint8_t *buf, int x0, int x1, int y0, int y1, bool on)
+{
+  int page0 = y0 >> 3, page1 = y1 >> 3;
+  for (int page = page0; page <= page1; page++)
+  {
+    uint8_t mask = 0xFF;
+    if (page == page0)
+      mask &= (uint8_t)(0xFF << (y0 & 7));
+    if (page == page1)
+      mask &= (uint8_t)(0xFF >> (7 - (y1 & 7)));
+    span(&buf[page * SSD1306_WIDTH], x0, x1, mask, on);
+  }
+}
+
+static inline void mark(const uint8_t *buf, int x0, int x1, int y0, int y1)
+{
+  if (buf == SSD1306_framebuffer())
+    SSD1306_mark_dirty(x0, x1, y0 >> 3, y1 >> 3);
+}
+
+static void fill_area(uint8_t *buf, int x0, int x1, int y0, int y1, bool on)
+{
+  if (!clip(&x0, &x1, &y0, &y1))
+    return;
+  fill(buf, x0, x1, y0, y1, on);
+  mark(buf, x0, x1, y0, y1);
+}
+
+void FillSpan(uint8_t *buf, int x0, int x1, int page, uint8_t mask, bool on)
+{
+  int y0 = page * 8, y1 = page * 8 + 7;
+  if (page < 0 || page >= (int)SSD1306_NUM_PAGES || mask == 0 || !clip(&x0, &x1, &y0, &y1))
+    return;
+  span(&buf[page * SSD1306_WIDTH], x0, x1, mask, on);
+  mark(buf, x0, x1, y0, y1);
+}
+
+void DrawHLine(uint8_t *buf, int x0, int x1, int y, bool on)
+{
+  fill_area(buf, x0, x1, y, y, on);
+}
+
+void DrawVLine(uint8_t *buf, int x, int y0, int y1, bool on)
+{
+  fill_area(buf, x, x, y0, y1, on);
+}
+
+void FillRect(uint8_t *buf, int x, int y, int w, int h, bool on)
+{
+  if (w > 0 && h > 0)
+    fill_area(buf, x, x + w - 1, y, y + h - 1, on);
+}
+
+void DrawRect(uint8_t *buf, int x, int y, int w, int h, bool on)
+{
+  if (w <= 2 || h <= 2)
+  {
+    FillRect(buf, x, y, w, h, on);
+    return;
+  }
+
+  // Each edge is clipped on its own; the dirty spans of a page cover the
+  // whole width between the two sides anyway, so one mark is enough
+  int edges[4][4] = {
+      {x, x + w - 1, y, y},                     // top
+      {x, x + w - 1, y + h - 1, y + h - 1},     // bottom
+      {x, x, y + 1, y + h - 2},                 // left
+      {x + w - 1, x + w - 1, y + 1, y + h - 2}, // right
+  };
+  for (int i = 0; i < 4; i++)
+  {
+    int *e = edges[i];
+    if (clip(&e[0], &e[1], &e[2], &e[3]))
+      fill(buf, e[0], e[1], e[2], e[3], on);
+  }
+
+  int x0 = x, x1 = x + w - 1, y0 = y, y1 = y + h - 1;
+  if (clip(&x0, &x1, &y0, &y1))
+    mark(buf, x0, x1, y0, y1);
+}
+
+void BlitBitmap(uint8_t *buf, int x, int y, const uint8_t *bmp, int w, int h, bool opaque)
+{
+  if (w <= 0 || h <= 0 || x >= SSD1306_WIDTH || x + w <= 0 || y >= SSD1306_HEIGHT || y + h <= 0)
+    return;
+
+  int c0 = x < 0 ? -x : 0;
+  int c1 = x + w > SSD1306_WIDTH ? SSD1306_WIDTH - x : w; // Exclusive
+  int shift = y & 7;
+  int pages = (h + 7) >> 3;
+
+  for (int p = 0; p < pages; p++, bmp += w)
+  {
+    int page = (y >> 3) + p; // Arithmetic shift: y = -3 is page -1, shift 5
+    if (page >= (int)SSD1306_NUM_PAGES)
+      break;
+    if (page < -1 || (page == -1 && shift == 0))
+      continue;
+
+    // Rows of the last source page past 'h' are not part of the bitmap
+    uint8_t valid = (p == pages - 1 && (h & 7)) ? (uint8_t)(0xFF >> (8 - (h & 7))) : 0xFF;
+    uint8_t *top = page >= 0 ? &buf[page * SSD1306_WIDTH] : NULL;
+    uint8_t *bottom = (shift && page + 1 < (int)SSD1306_NUM_PAGES) ? &buf[(page + 1) * SSD1306_WIDTH] : NULL;
+
+    // Common case: page aligned, opaque, full page, a straight copy
+    if (top && shift == 0 && opaque && valid == 0xFF)
+    {
+      memcpy(&top[x + c0], &bmp[c0], c1 - c0);
+      continue;
+    }
+
+    uint8_t top_clear = opaque ? (uint8_t)(valid << shift) : 0;
+    uint8_t bottom_clear = opaque ? (uint8_t)(valid >> (8 - shift)) : 0;
+    if (top)
+    {
+      for (int c = c0; c < c1; c++)
+        top[x + c] = (top[x + c] & ~top_clear) | (uint8_t)((bmp[c] & valid) << shift);
+    }
+    if (bottom)
+    {
+      for (int c = c0; c < c1; c++)
+        bottom[x + c] = (bottom[x + c] & ~bottom_clear) | (uint8_t)((bmp[c] & valid) >> (8 - shift));
+    }
+  }
+
+  int y1 = y + h - 1;
+  mark(buf, x + c0, x + c1 - 1, y < 0 ? 0 : y, y1 > SSD1306_HEIGHT - 1 ? SSD1306_HEIGHT - 1 : y1);
+}
@@ -0,0 +1,32 @@
+#ifndef SSD1306_GFX_H_
+#define SSD1306_GFX_H_
+
+#include "ssd1306_i2c.h"
+
+// Drawing primitives that work on whole page bytes instead of single pixels.
+// A page byte holds 8 vertical pixels, so anything 8 pixels tall or less is
+// one masked read-modify-write per column, and fully covered bytes are plain
+// memset/memcpy. SetPixel and DrawLine in ssd1306.h are kept on top of these.
+//
+// All primitives take any coordinates and clip at the buffer edges (a buffer
+// is SSD1306_WIDTH bytes per page, like the framebuffer). Drawing into the
+// framebuffer marks the touched columns dirty once per call, not per pixel.
+
+// Sets (on) or clears the bits in 'mask' of columns x0..x1 of one page
+void FillSpan(uint8_t *buf, int x0, int x1, int page, uint8_t mask, bool on);
+
+// Lines with inclusive end points, in either order
+void DrawHLine(uint8_t *buf, int x0, int x1, int y, bool on);
+void DrawVLine(uint8_t *buf, int x, int y0, int y1, bool on);
+
+// 'w' x 'h' pixels with the top left corner at x, y
+void FillRect(uint8_t *buf, int x, int y, int w, int h, bool on);
+void DrawRect(uint8_t *buf, int x, int y, int w, int h, bool on);
+
+// 1 bpp bitmap in page layout ('w' bytes per page, (h + 7) / 8 pages, LSB on
+// top, the same layout SSD1306_blit and the prerendered screens use), drawn
+// at any pixel y. Opaque clears the 'w' x 'h' area behind the set bits;
+// otherwise only set bits are drawn.
+void BlitBitmap(uint8_t *buf, int x, int y, const uint8_t *bmp, int w, int h, bool opaque);
+
+#endif
@@ -11,8 +11,11 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
 #include "ssd1306_font.h"
 #include "ssd1306_i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_gfx.h"
 
 void calc_render_area_buflen(struct render_area *area)
 {
@@ -20,19 +23,112 @@ void calc_render_area_buflen(struct render_area *area)
   area->buflen = (area->end_col - area->start_col + 1) * (area->end_page - area->start_page + 1);
 }
 
+// Frame buffer shared by the application and the driver
+static uint8_t fb[SSD1306_BUF_LEN];
+
+// Dirty column span per page; start > end means the page is clean
+static uint8_t dirty_start[SSD1306_NUM_PAGES];
+static uint8_t dirty_end[SSD1306_NUM_PAGES];
+
+// Everything goes to the bus as IC_DATA_CMD words: the data byte plus the
+// STOP bit on the last byte of each transaction. The DMA can only raise STOP
+// through these words, so frames are widened into this buffer once per
+// transfer. Worst case is every page as its own area: a 7-byte address
+// command transaction plus a full page of data.
+#define SSD1306_STREAM_LEN (SSD1306_NUM_PAGES * (7 + 1 + SSD1306_WIDTH))
+static uint32_t stream[SSD1306_STREAM_LEN];
+static int stream_len;
+
+static const struct ssd1306_transport *transport;
+static bool pending;   // Dirty regions waiting for the bus to free up
+static bool in_flight; // A frame was started and its completion not yet reported
+static void (*done_callback)(void);
+
+static uint32_t frames;
+static uint32_t frames_window_start;
+static uint64_t fps_window_start;
+static uint32_t fps;
+
+static void stream_add_txn(uint8_t control, const uint8_t *bytes, int len)
+{
+  stream[stream_len++] = control;
+  for (int i = 0; i < len; i++)
+    stream[stream_len++] = bytes[i];
+  stream[stream_len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+}
+
+// 'stride' is the distance between pages in 'buf': the area width for a
+// packed buffer, SSD1306_WIDTH when gathering straight from the frame buffer
+static void stream_add_area(const uint8_t *buf, int stride, const struct render_area *area)
+{
+  uint8_t cmds[] = {
+      SSD1306_SET_COL_ADDR,
+      area->start_col,
+      area->end_col,
+      SSD1306_SET_PAGE_ADDR,
+      area->start_page,
+      area->end_page};
+
+  // Co = 0, D/C = 0 => every byte up to the stop condition is a command
+  stream_add_txn(0x00, cmds, count_of(cmds));
+
+  // D/C = 1 => everything after the control byte goes to display RAM
+  int width = area->end_col - area->start_col + 1;
+  stream[stream_len++] = 0x40;
+  for (int page = area->start_page; page <= area->end_page; page++, buf += stride)
+  {
+    for (int i = 0; i < width; i++)
+      stream[stream_len++] = buf[i];
+  }
+  stream[stream_len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+}
+
+static void finish_frame()
+{
+  if (in_flight)
+  {
+    in_flight = false;
+    frames++;
+    if (done_callback)
+      done_callback();
+  }
+}
+
+// Waits for the transport to drain; used before the stream buffer is reused
+static void wait_idle()
+{
+  while (transport->busy())
+    tight_loop_contents();
+  finish_frame();
+}
+
+static void start_stream()
+{
+  transport->start(stream, stream_len);
+}
+
+void SSD1306_set_transport(const struct ssd1306_transport *t)
+{
+  transport = t;
+}
+
+void SSD1306_set_done_callback(void (*cb)(void))
+{
+  done_callback = cb;
+}
+
 void SSD1306_send_cmd(uint8_t cmd)
 {
-  // I2C write process expects a control byte followed by data
-  // this "data" can be a command or data to follow up a command
-  // Co = 1, D/C = 0 => the driver expects a command
-  uint8_t buf[2] = {0x80, cmd};
-  i2c_write_blocking(i2c1, SSD1306_I2C_ADDR, buf, 2, false);
+  SSD1306_send_cmd_list(&cmd, 1);
 }
 
 void SSD1306_send_cmd_list(uint8_t *buf, int num)
 {
-  for (int i = 0; i < num; i++)
-    SSD1306_send_cmd(buf[i]);
+  // The whole list goes out as one transaction
+  wait_idle();
+  stream_len = 0;
+  stream_add_txn(0x00, buf, num);
+  start_stream();
 }
 
 void SSD1306_send_buf(uint8_t buf[], int buflen)
@@ -40,20 +136,211 @@ void SSD1306_send_buf(uint8_t buf[], int buflen)
   // in horizontal addressing mode, the column address pointer auto-increments
   // and then wraps around to the next page, so we can send the entire frame
   // buffer in one gooooooo!
+  wait_idle();
+  stream_len = 0;
+  stream_add_txn(0x40, buf, buflen);
+  start_stream();
+}
+
+uint8_t *SSD1306_framebuffer()
+{
+  return fb;
+}
+
+void SSD1306_mark_dirty(int x0, int x1, int page0, int page1)
+{
+  if (x0 < 0)
+    x0 = 0;
+  if (x1 > SSD1306_WIDTH - 1)
+    x1 = SSD1306_WIDTH - 1;
+  if (page0 < 0)
+    page0 = 0;
+  if (page1 > SSD1306_NUM_PAGES - 1)
+    page1 = SSD1306_NUM_PAGES - 1;
+
+  for (int page = page0; page <= page1 && x0 <= x1; page++)
+  {
+    if (dirty_start[page] > dirty_end[page])
+    {
+      dirty_start[page] = x0;
+      dirty_end[page] = x1;
+      continue;
+    }
+    if (x0 < dirty_start[page])
+      dirty_start[page] = x0;
+    if (x1 > dirty_end[page])
+      dirty_end[page] = x1;
+  }
+}
+
+static inline void mark_if_fb(const uint8_t *buf, int x0, int x1, int page0, int page1)
+{
+  if (buf == fb)
+    SSD1306_mark_dirty(x0, x1, page0, page1);
+}
+
+void SSD1306_clear()
+{
+  memset(fb, 0, SSD1306_BUF_LEN);
+  SSD1306_mark_dirty(0, SSD1306_WIDTH - 1, 0, SSD1306_NUM_PAGES - 1);
+}
+
+// Copy a prerendered bitmap (page layout, 'width' bytes per page, e.g. from
+// flash) into the framebuffer. Only the columns that actually change are marked
+// dirty, so redrawing a screen that is mostly on display already sends little.
+void SSD1306_blit(const uint8_t *src, int x, int page, int width, int pages)
+{
+  for (int p = 0; p < pages; p++, src += width)
+  {
+    uint8_t *dst = &fb[(page + p) * SSD1306_WIDTH + x];
+    int first = 0, last = width - 1;
+    while (first <= last && dst[first] == src[first])
+      first++;
+    while (last >= first && dst[last] == src[last])
+      last--;
+    if (first > last)
+      continue;
+    memcpy(&dst[first], &src[first], last - first + 1);
+    SSD1306_mark_dirty(x + first, x + last, page + p, page + p);
+  }
+}
+
+void SSD1306_update()
+{
+  // Bus busy: the dirty spans keep accumulating and go out together from
+  // SSD1306_poll() once the current frame is done
+  if (transport->busy())
+  {
+    pending = true;
+    return;
+  }
+  finish_frame();
+  pending = false;
+  stream_len = 0;
+
+  int page = 0;
+  while (page < SSD1306_NUM_PAGES)
+  {
+    if (dirty_start[page] > dirty_end[page])
+    {
+      page++;
+      continue;
+    }
+
+    struct render_area area = {
+        start_col : dirty_start[page],
+        end_col : dirty_end[page],
+        start_page : page,
+        end_page : page
+    };
+
+    // A run of pages with the same dirty span goes out as one area
+    while (area.end_page + 1 < SSD1306_NUM_PAGES && dirty_start[area.end_page + 1] == area.start_col &&
+           dirty_end[area.end_page + 1] == area.end_col)
+      area.end_page++;
+
+    calc_render_area_buflen(&area);
+    stream_add_area(fb + area.start_page * SSD1306_WIDTH + area.start_col, SSD1306_WIDTH, &area);
+
+    for (; page <= area.end_page; page++)
+    {
+      dirty_start[page] = 1;
+      dirty_end[page] = 0;
+    }
+  }
 
-  // copy our frame buffer into a new buffer because we need to add the control byte
-  // to the beginning
+  if (stream_len > 0)
+  {
+    in_flight = true;
+    start_stream();
+  }
+}
 
-  uint8_t *temp_buf = malloc(buflen + 1);
+void SSD1306_poll()
+{
+  if (transport->busy())
+    return;
+  finish_frame();
+  if (pending)
+    SSD1306_update();
+
+  uint64_t now = time_us_64();
+  if (now - fps_window_start >= 1000000)
+  {
+    fps = frames - frames_window_start;
+    frames_window_start = frames;
+    fps_window_start = now;
+  }
+}
 
-  temp_buf[0] = 0x40;
-  memcpy(temp_buf + 1, buf, buflen);
+bool SSD1306_busy()
+{
+  return pending || transport->busy();
+}
 
-  i2c_write_blocking(i2c1, SSD1306_I2C_ADDR, temp_buf, buflen + 1, false);
+uint32_t SSD1306_fps()
+{
+  return fps;
+}
 
-  free(temp_buf);
+uint SSD1306_set_clock_khz(uint khz)
+{
+  wait_idle();
+  return i2c_set_baudrate(i2c1, khz * 1000) / 1000;
 }
 
+#if PICO_ON_DEVICE
+
+// Default transport: one DMA channel paced by the I2C TX DREQ
+static int dma_chan = -1;
+static dma_channel_config dma_cfg;
+static uint32_t tx_aborts;
+
+static void dma_transport_start(const uint32_t *words, int len)
+{
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+
+  if (dma_chan < 0)
+  {
+    dma_chan = dma_claim_unused_channel(true);
+    dma_cfg = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&dma_cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&dma_cfg, true);
+    channel_config_set_write_increment(&dma_cfg, false);
+    channel_config_set_dreq(&dma_cfg, i2c_get_dreq(i2c1, true));
+    hw->dma_tdlr = 8; // Refill while half of the 16-entry FIFO is still queued
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+  }
+  dma_channel_configure(dma_chan, &dma_cfg, &hw->data_cmd, words, len, true);
+}
+
+static bool dma_transport_busy()
+{
+  if (dma_chan < 0)
+    return false;
+  if (dma_channel_is_busy(dma_chan))
+    return true;
+
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+  // A NACK (display missing) flushes the FIFO; clear it once the DMA is done
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+  {
+    (void)hw->clr_tx_abrt;
+    tx_aborts++;
+  }
+  return !(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+static const struct ssd1306_transport dma_transport = {
+    start : dma_transport_start,
+    busy : dma_transport_busy
+};
+
+static const struct ssd1306_transport *transport_default = &dma_transport;
+#else
+static const struct ssd1306_transport *transport_default = NULL;
+#endif
+
 void SSD1306_init()
 {
   // Some of these commands are not strictly necessary as the reset
@@ -61,6 +348,16 @@ void SSD1306_init()
   // to demonstrate what the initialization sequence looks like
   // Some configuration values are recommended by the board manufacturer
 
+  if (!transport)
+    transport = transport_default;
+
+  // The transport writes IC_DATA_CMD directly, so the target address is set
+  // once here (IC_TAR can only change while the block is disabled)
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+  hw->enable = 0;
+  hw->tar = SSD1306_I2C_ADDR;
+  hw->enable = 1;
+
   uint8_t cmds[] = {
       SSD1306_SET_DISP, // set display off
       /* memory mapping */
@@ -102,6 +399,10 @@ void SSD1306_init()
   };
 
   SSD1306_send_cmd_list(cmds, count_of(cmds));
+
+  // The controller RAM content is unknown after reset
+  SSD1306_clear();
+  SSD1306_update();
 }
 
 void SSD1306_scroll(bool on)
@@ -121,50 +422,78 @@ void SSD1306_scroll(bool on)
   SSD1306_send_cmd_list(cmds, count_of(cmds));
 }
 
-void render(uint8_t *buf, struct render_area *area)
+void SSD1306_scroll_one_column(bool left, uint8_t start_page, uint8_t end_page)
 {
-  // update a portion of the display with a render area
+  // Content scroll (2Ch/2Dh) moves the display RAM itself by one column, so
+  // the frame buffer is shifted the same way to stay in sync. The column that
+  // comes in at the edge is left for the caller to draw. The controller needs
+  // at least two frame periods between consecutive one-column scrolls.
   uint8_t cmds[] = {
-      SSD1306_SET_COL_ADDR,
-      area->start_col,
-      area->end_col,
-      SSD1306_SET_PAGE_ADDR,
-      area->start_page,
-      area->end_page};
+      left ? SSD1306_SCROLL_ONE_COL_FB_LEFT : SSD1306_SCROLL_ONE_COL_FB_RIGHT,
+      0x00,             // dummy byte
+      start_page,       // start page
+      0x01,             // dummy byte
+      end_page,         // end page
+      0x00,             // dummy byte
+      0x00,             // start column
+      SSD1306_WIDTH - 1 // end column
+  };
 
   SSD1306_send_cmd_list(cmds, count_of(cmds));
-  SSD1306_send_buf(buf, area->buflen);
+
+  for (int page = start_page; page <= end_page; page++)
+  {
+    uint8_t *row = fb + page * SSD1306_WIDTH;
+    if (left)
+      memmove(row, row + 1, SSD1306_WIDTH - 1);
+    else
+      memmove(row + 1, row, SSD1306_WIDTH - 1);
+
+    // Spans not yet sent moved along with the content; widen them so both
+    // the old and the new position get refreshed
+    if (dirty_start[page] <= dirty_end[page])
+    {
+      if (left && dirty_start[page] > 0)
+        dirty_start[page]--;
+      else if (!left && dirty_end[page] < SSD1306_WIDTH - 1)
+        dirty_end[page]++;
+    }
+  }
 }
 
-void SetPixel(uint8_t *buf, int x, int y, bool on)
+void render(uint8_t *buf, struct render_area *area)
 {
-  assert(x >= 0 && x < SSD1306_WIDTH && y >= 0 && y < SSD1306_HEIGHT);
-
-  // The calculation to determine the correct bit to set depends on which address
-  // mode we are in. This code assumes horizontal
-
-  // The video ram on the SSD1306 is split up in to 8 rows, one bit per pixel.
-  // Each row is 128 long by 8 pixels high, each byte vertically arranged, so byte 0 is x=0, y=0->7,
-  // byte 1 is x = 1, y=0->7 etc
-
-  // This code could be optimised, but is like this for clarity. The compiler
-  // should do a half decent job optimising it anyway.
-
-  const int BytesPerRow = SSD1306_WIDTH; // x pixels, 1bpp, but each row is 8 pixel high, so (x / 8) * 8
-
-  int byte_idx = (y / 8) * BytesPerRow + x;
-  uint8_t byte = buf[byte_idx];
-
-  if (on)
-    byte |= 1 << (y % 8);
-  else
-    byte &= ~(1 << (y % 8));
+  // update a portion of the display with a render area; 'buf' is copied into
+  // the stream, so it may be reused as soon as this returns
+  wait_idle();
+  stream_len = 0;
+  stream_add_area(buf, area->end_col - area->start_col + 1, area);
+  in_flight = true;
+  start_stream();
+}
 
-  buf[byte_idx] = byte;
+// Kept for compatibility: one pixel is a one-column span with a single bit set
+// in the mask (see ssd1306_gfx.h). Pixels off the buffer are clipped.
+void SetPixel(uint8_t *buf, int x, int y, bool on)
+{
+  FillSpan(buf, x, x, y >> 3, 1 << (y & 7), on);
 }
-// Basic Bresenhams.
+
+// Horizontal and vertical lines take the page-wise paths in ssd1306_gfx.c. The
+// rest is basic Bresenham writing the bits directly; the columns it touched in
+// each page are marked dirty once when the line leaves that page.
 void DrawLine(uint8_t *buf, int x0, int y0, int x1, int y1, bool on)
 {
+  if (y0 == y1)
+  {
+    DrawHLine(buf, x0, x1, y0, on);
+    return;
+  }
+  if (x0 == x1)
+  {
+    DrawVLine(buf, x0, y0, y1, on);
+    return;
+  }
 
   int dx = abs(x1 - x0);
   int sx = x0 < x1 ? 1 : -1;
@@ -172,10 +501,31 @@ void DrawLine(uint8_t *buf, int x0, int y0, int x1, int y1, bool on)
   int sy = y0 < y1 ? 1 : -1;
   int err = dx + dy;
   int e2;
+  int run_page = -1, run_x0 = 0, run_x1 = 0;
 
   while (true)
   {
-    SetPixel(buf, x0, y0, on);
+    if (x0 >= 0 && x0 < SSD1306_WIDTH && y0 >= 0 && y0 < SSD1306_HEIGHT)
+    {
+      int page = y0 >> 3;
+      uint8_t bit = 1 << (y0 & 7);
+      if (on)
+        buf[page * SSD1306_WIDTH + x0] |= bit;
+      else
+        buf[page * SSD1306_WIDTH + x0] &= ~bit;
+
+      if (page != run_page)
+      {
+        if (run_page >= 0)
+          mark_if_fb(buf, run_x0, run_x1, run_page, run_page);
+        run_page = page;
+        run_x0 = run_x1 = x0;
+      }
+      else if (x0 < run_x0)
+        run_x0 = x0;
+      else if (x0 > run_x1)
+        run_x1 = x0;
+    }
     if (x0 == x1 && y0 == y1)
       break;
     e2 = 2 * err;
@@ -191,9 +541,11 @@ void DrawLine(uint8_t *buf, int x0, int y0, int x1, int y1, bool on)
       y0 += sy;
     }
   }
+  if (run_page >= 0)
+    mark_if_fb(buf, run_x0, run_x1, run_page, run_page);
 }
 
-inline int GetFontIndex(uint8_t ch)
+static inline int GetFontIndex(uint8_t ch)
 {
   if (ch >= 'A' && ch <= 'Z')
   {
@@ -223,6 +575,7 @@ void WriteChar(uint8_t *buf, int16_t x, int16_t y, uint8_t ch)
   {
     buf[fb_idx++] = font[idx * 8 + i];
   }
+  mark_if_fb(buf, x, x + 7, y, y);
 }
 
 void WriteString(uint8_t *buf, int16_t x, int16_t y, char *str)
@@ -26,6 +26,8 @@ All text above, and the splash screen must be included in any redistribution
 #ifndef SSD1306_I2C_H_
 #define SSD1306_I2C_H_
 
+#include "pico/stdlib.h"
+
 // Define the size of the display we have attached. This can vary, make sure you
 // have the right size defined or the output will look rather odd!
 // Code has been tested on 128x32 and 128x64 OLED displays
@@ -36,8 +38,10 @@ All text above, and the splash screen must be included in any redistribution
 
 // 400 is usual, but often these can be overclocked to improve display response.
 // Tested at 1000 on both 32 and 84 pixel height devices and it worked.
+// This is only the boot value; SSD1306_set_clock_khz() changes it at runtime.
 #define SSD1306_I2C_CLK 400
 // #define SSD1306_I2C_CLK             1000
+#define SSD1306_I2C_CLK_FAST_PLUS 1000
 
 // commands (see datasheet)
 #define SSD1306_SET_MEM_MODE _u(0x20)
@@ -45,6 +49,11 @@ All text above, and the splash screen must be included in any redistribution
 #define SSD1306_SET_PAGE_ADDR _u(0x22)
 #define SSD1306_SET_HORIZ_SCROLL _u(0x26)
 #define SSD1306_SET_SCROLL _u(0x2E)
+// Content scroll by one column: 2Ch moves right, 2Dh left, in segment order.
+// With the segment re-map used by SSD1306_init (column 127 -> SEG0) the
+// segment order is the mirror of the frame buffer order.
+#define SSD1306_SCROLL_ONE_COL_FB_LEFT _u(0x2C)
+#define SSD1306_SCROLL_ONE_COL_FB_RIGHT _u(0x2D)
 
 #define SSD1306_SET_DISP_START_LINE _u(0x40)
 
@@ -84,4 +93,12 @@ struct render_area
   int buflen;
 };
 
+// Moves IC_DATA_CMD words (data byte | STOP bit) to the bus without blocking.
+// The default is DMA into i2c1; tests and simulations can plug in their own.
+struct ssd1306_transport
+{
+  void (*start)(const uint32_t *words, int len);
+  bool (*busy)(void);
+};
+
 #endif /* _SSD1306_I2C_H_ */
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include <string.h>
+#include "ssd1306_text.h"
+#include "ssd1306.h"
+#include "ssd1306_font5x7.h"
+
+#define GLYPH_QUESTION ('?' - FONT5X7_FIRST)
+
+// Decodes the next code point of a UTF-8 string; only U+0000-U+00FF can be in
+// the font, anything longer is consumed and returned as 0xFFFF
+static uint16_t next_code(const char **str)
+{
+  const uint8_t *s = (const uint8_t *)*str;
+  uint16_t code = *s++;
+  if (code >= 0x80)
+  {
+    if ((code & 0xE0) == 0xC0 && (*s & 0xC0) == 0x80)
+      code = ((code & 0x1F) << 6) | (*s++ & 0x3F);
+    else
+    {
+      code = 0xFFFF;
+      while ((*s & 0xC0) == 0x80)
+        s++;
+    }
+  }
+  *str = (const char *)s;
+  return code;
+}
+
+static uint8_t glyph_index(uint16_t code)
+{
+  if (code >= FONT5X7_FIRST && code <= FONT5X7_LAST)
+    return code - FONT5X7_FIRST;
+  if (code >= 0xA0 && code <= 0xFF && font5x7_latin1[code - 0xA0])
+    return font5x7_latin1[code - 0xA0];
+  return GLYPH_QUESTION;
+}
+
+// Blits one cell (glyph plus spacing column) with its top row at y. 'glyph' < 0
+// draws an empty cell (the space glyph). Returns false if the cell is entirely clipped.
+static bool blit_cell(uint8_t *buf, int x, int y, int glyph, bool opaque)
+{
+  if (x <= -TEXT_ADVANCE || x >= SSD1306_WIDTH || y <= -TEXT_HEIGHT || y >= SSD1306_HEIGHT)
+    return false;
+
+  int page = y >> 3; // Arithmetic shift: y = -3 is page -1, shift 5
+  int shift = y & 7;
+  uint8_t *top = (page >= 0) ? &buf[page * SSD1306_WIDTH] : NULL;
+  uint8_t *bottom = (shift && page + 1 < SSD1306_NUM_PAGES) ? &buf[(page + 1) * SSD1306_WIDTH] : NULL;
+  uint8_t top_mask = opaque ? (uint8_t)(0xFF << shift) : 0;
+  uint8_t bottom_mask = opaque ? (uint8_t)(0xFF >> (8 - shift)) : 0;
+  const uint8_t *cols = glyph >= 0 ? font5x7[glyph] : font5x7[' ' - FONT5X7_FIRST];
+
+  // Common case: page aligned, opaque and not clipped, a straight copy
+  if (shift == 0 && opaque && top && x >= 0 && x + TEXT_ADVANCE <= SSD1306_WIDTH)
+  {
+    uint8_t *dst = &top[x];
+    dst[0] = cols[0];
+    dst[1] = cols[1];
+    dst[2] = cols[2];
+    dst[3] = cols[3];
+    dst[4] = cols[4];
+    dst[5] = 0;
+    return true;
+  }
+
+  int c0 = x < 0 ? -x : 0;
+  int c1 = x + TEXT_ADVANCE > SSD1306_WIDTH ? SSD1306_WIDTH - x : TEXT_ADVANCE;
+  if (top && bottom)
+  {
+    // Straddling two pages, both on screen
+    for (int c = c0; c < c1; c++)
+    {
+      uint8_t g = c < FONT5X7_WIDTH ? cols[c] : 0;
+      top[x + c] = (top[x + c] & ~top_mask) | (uint8_t)(g << shift);
+      bottom[x + c] = (bottom[x + c] & ~bottom_mask) | (uint8_t)(g >> (8 - shift));
+    }
+    return true;
+  }
+  for (int c = c0; c < c1; c++)
+  {
+    uint8_t g = c < FONT5X7_WIDTH ? cols[c] : 0;
+    if (top)
+      top[x + c] = (top[x + c] & ~top_mask) | (uint8_t)(g << shift);
+    if (bottom)
+      bottom[x + c] = (bottom[x + c] & ~bottom_mask) | (uint8_t)(g >> (8 - shift));
+  }
+  return true;
+}
+
+static void mark_text(const uint8_t *buf, int x0, int x1, int y)
+{
+  if (buf == SSD1306_framebuffer() && x1 >= x0)
+    SSD1306_mark_dirty(x0, x1, y >> 3, (y + TEXT_HEIGHT - 1) >> 3);
+}
+
+int DrawText(uint8_t *buf, int x, int y, const char *str, bool opaque)
+{
+  int start = x;
+  while (*str)
+  {
+    blit_cell(buf, x, y, glyph_index(next_code(&str)), opaque);
+    x += TEXT_ADVANCE;
+  }
+  mark_text(buf, start, x - 1, y);
+  return x - start;
+}
+
+int TextWidth(const char *str)
+{
+  int width = 0;
+  while (*str)
+  {
+    next_code(&str);
+    width += TEXT_ADVANCE;
+  }
+  return width;
+}
+
+void TextLabelInit(struct text_label *label, int x, int y)
+{
+  label->x = x;
+  label->y = y;
+  TextLabelInvalidate(label);
+}
+
+void TextLabelInvalidate(struct text_label *label)
+{
+  label->len = 0;
+  label->text[0] = '\0';
+}
+
+bool DrawLabel(uint8_t *buf, struct text_label *label, const char *str)
+{
+  const char *text = str;
+  size_t bytes = strlen(str);
+  bool cacheable = bytes < sizeof(label->text);
+  if (cacheable && label->len && strcmp(str, label->text) == 0)
+    return false;
+
+  int first = TEXT_LABEL_MAX, last = -1; // Changed cells
+  uint8_t len = 0;
+  while (*str && len < TEXT_LABEL_MAX)
+  {
+    uint8_t glyph = glyph_index(next_code(&str));
+    if (len >= label->len || label->glyphs[len] != glyph)
+    {
+      label->glyphs[len] = glyph;
+      blit_cell(buf, label->x + len * TEXT_ADVANCE, label->y, glyph, true);
+      if (first > len)
+        first = len;
+      last = len;
+    }
+    len++;
+  }
+  for (uint8_t i = len; i < label->len; i++)
+  {
+    blit_cell(buf, label->x + i * TEXT_ADVANCE, label->y, -1, true);
+    if (first > i)
+      first = i;
+    last = i;
+  }
+  label->len = len;
+  if (cacheable)
+    memcpy(label->text, text, bytes + 1);
+  else
+    label->text[0] = '\0';
+
+  if (last < 0)
+    return false;
+  mark_text(buf, label->x + first * TEXT_ADVANCE, label->x + (last + 1) * TEXT_ADVANCE - 1, label->y);
+  return true;
+}
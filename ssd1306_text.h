@@ -0,0 +1,45 @@
+#ifndef SSD1306_TEXT_H_
+#define SSD1306_TEXT_H_
+
+#include "ssd1306_i2c.h"
+
+// Text renderer for the framebuffer with the 5x7 font in ssd1306_font5x7.h:
+// printable ASCII plus the Latin-1 letters used in Portuguese. Strings are
+// UTF-8; anything outside the font is drawn as '?'.
+//
+// Glyphs are blitted at any pixel y: each column byte is shifted and masked
+// into the two pages it straddles. Glyphs are clipped at the buffer edges.
+// Drawing into the framebuffer marks the touched columns dirty once per string.
+
+#define TEXT_ADVANCE 6     // 5 columns plus 1 column of spacing
+#define TEXT_HEIGHT 8
+#define TEXT_LABEL_MAX 22  // Glyphs in a label (a full 128 pixel line is 21)
+
+// Opaque text clears the 8 pixel tall cell behind each glyph; transparent
+// text only sets pixels
+int DrawText(uint8_t *buf, int x, int y, const char *str, bool opaque);
+
+// Width in pixels DrawText would use
+int TextWidth(const char *str);
+
+// A label remembers the glyphs it has on screen. Redrawing it with the same
+// string costs one string compare; with a different string only the cells
+// whose glyph changed are rasterized again, and a shorter string clears the
+// leftover cells. Labels are always opaque.
+struct text_label
+{
+  int16_t x, y;
+  uint8_t len;                      // Glyphs currently on screen
+  uint8_t glyphs[TEXT_LABEL_MAX];   // Glyph index of each cell
+  char text[TEXT_LABEL_MAX * 2 + 1]; // Last string drawn, for the fast path
+};
+
+void TextLabelInit(struct text_label *label, int x, int y);
+
+// Returns true if anything was drawn
+bool DrawLabel(uint8_t *buf, struct text_label *label, const char *str);
+
+// Forget what is on screen (after the area was cleared by other means)
+void TextLabelInvalidate(struct text_label *label);
+
+#endif
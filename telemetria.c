@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <string.h>
+#include "telemetria.h"
+#include "fila_spsc.h"
+
+#if PICO_ON_DEVICE
+#include "pico/stdio_usb.h"
+#endif
+
+typedef struct {
+    TelemetriaCabecalho cab;
+    uint8_t carga[TELEMETRIA_MAX_CARGA];
+} TelemetriaPacote;
+
+FILA_SPSC_ARMAZENAMENTO(pacotes, TelemetriaPacote, TELEMETRIA_FILA_PACOTES);
+static FilaSpsc filaPacotes;
+
+static uint8_t modoAtual = TELEMETRIA_TEXTO;
+static uint8_t decimacaoAtual = 1;
+
+// Estado do núcleo 1
+static TelemetriaPacote pacoteAmostras;
+static uint32_t somaDecimacao;
+static uint8_t contagemDecimacao;
+static uint32_t seqAmostras;
+
+// Estado do núcleo 0
+static TelemetriaPacote pacoteResultados;
+static uint32_t seqResultados;
+static uint32_t seqVisto = UINT32_MAX; // Pacote parcial de resultados visto por telemetriaEnviar()
+static uint64_t instanteVisto;         // e quando foi visto pela primeira vez
+static TelemetriaPacote pacoteRegistros;
+static uint32_t seqRegistros;
+static uint32_t seqTexto;
+static uint32_t seqDisparo;
+static uint8_t quadro[TELEMETRIA_MAX_QUADRO];
+static TelemetriaStats stats;
+
+static uint64_t agoraUs();
+static bool conectado();
+static void escrever(const uint8_t *dados, size_t n);
+
+uint8_t telemetriaInit(uint8_t modo, uint8_t decimacao, uint32_t taxa, uint32_t periodoUs) {
+    filaSpscInit(&filaPacotes, pacotesDados, NULL, sizeof(TelemetriaPacote), TELEMETRIA_FILA_PACOTES,
+                 FILA_DESCARTAR);
+    modoAtual = modo;
+    decimacaoAtual = decimacao ? decimacao : 1;
+    if (modo & TELEMETRIA_AMOSTRAS) {
+        while (decimacaoAtual < UINT8_MAX && !TELEMETRIA_CABE_NA_FILA(taxa, decimacaoAtual, periodoUs)) {
+            decimacaoAtual++;
+        }
+    }
+    pacoteAmostras.cab.n = 0;
+    pacoteResultados.cab.n = 0;
+    pacoteRegistros.cab.n = 0;
+    somaDecimacao = 0;
+    contagemDecimacao = 0;
+    return decimacaoAtual;
+}
+
+bool telemetriaTexto() {
+    return modoAtual == TELEMETRIA_TEXTO;
+}
+
+void telemetriaAmostras(const uint16_t *amostras, size_t n) {
+    if (!(modoAtual & TELEMETRIA_AMOSTRAS)) {
+        return;
+    }
+
+    TelemetriaPacote *p = &pacoteAmostras;
+    for (size_t i = 0; i < n; i++) {
+        somaDecimacao += amostras[i];
+        if (++contagemDecimacao < decimacaoAtual) {
+            continue;
+        }
+        uint16_t valor = somaDecimacao / decimacaoAtual;
+        somaDecimacao = 0;
+        contagemDecimacao = 0;
+
+        if (p->cab.n == 0) {
+            p->cab.tipo = TELEMETRIA_TIPO_AMOSTRAS;
+            p->cab.decimacao = decimacaoAtual;
+            p->cab.seq = seqAmostras;
+            p->cab.instante = agoraUs();
+        }
+        p->carga[2 * p->cab.n] = valor;
+        p->carga[2 * p->cab.n + 1] = valor >> 8;
+        if (++p->cab.n == TELEMETRIA_AMOSTRAS_POR_PACOTE) {
+            // A sequência avança mesmo se a fila descartar o pacote, para que
+            // o host veja o buraco
+            seqAmostras++;
+            filaSpscPush(&filaPacotes, p);
+            p->cab.n = 0;
+        }
+    }
+}
+
+static void enviarPacote(const TelemetriaPacote *p, size_t tamCarga) {
+    if (!conectado()) {
+        stats.semConexao++;
+        return;
+    }
+    size_t n = telemetriaMontarQuadro(&p->cab, p->carga, tamCarga, quadro);
+    escrever(quadro, n);
+    stats.quadros++;
+    stats.bytes += n;
+}
+
+void telemetriaResultado(const DetectorResultado *res) {
+    if (!(modoAtual & TELEMETRIA_RESULTADOS)) {
+        return;
+    }
+
+    TelemetriaPacote *p = &pacoteResultados;
+    if (p->cab.n == 0) {
+        p->cab.tipo = TELEMETRIA_TIPO_RESULTADO;
+        p->cab.decimacao = 1;
+        p->cab.seq = seqResultados;
+        p->cab.instante = agoraUs();
+    }
+
+    uint16_t campos[] = {res->dc, res->rms, res->pico, res->amplitude[DETECTOR_50HZ], res->amplitude[DETECTOR_60HZ],
+                         res->amplitude[DETECTOR_100HZ], res->amplitude[DETECTOR_120HZ], res->intensidade};
+    uint8_t *c = &p->carga[p->cab.n * TELEMETRIA_TAM_RESULTADO];
+    for (size_t i = 0; i < sizeof(campos) / sizeof(campos[0]); i++) {
+        *c++ = campos[i];
+        *c++ = campos[i] >> 8;
+    }
+    *c = res->rede;
+
+    if (++p->cab.n == TELEMETRIA_RESULTADOS_POR_PACOTE) {
+        telemetriaResultadosFim();
+    }
+}
+
+void telemetriaResultadosFim() {
+    TelemetriaPacote *p = &pacoteResultados;
+    if (p->cab.n > 0) {
+        seqResultados++;
+        enviarPacote(p, p->cab.n * TELEMETRIA_TAM_RESULTADO);
+        p->cab.n = 0;
+    }
+}
+
+void telemetriaRegistro(uint16_t sessao, uint32_t instanteMs, uint16_t valor) {
+    TelemetriaPacote *p = &pacoteRegistros;
+    if (p->cab.n == 0) {
+        p->cab.tipo = TELEMETRIA_TIPO_REGISTRO;
+        p->cab.decimacao = 1;
+        p->cab.seq = seqRegistros;
+        p->cab.instante = agoraUs();
+    }
+
+    uint8_t *c = &p->carga[p->cab.n * TELEMETRIA_TAM_REGISTRO];
+    c[0] = sessao;
+    c[1] = sessao >> 8;
+    c[2] = instanteMs;
+    c[3] = instanteMs >> 8;
+    c[4] = instanteMs >> 16;
+    c[5] = instanteMs >> 24;
+    c[6] = valor;
+    c[7] = valor >> 8;
+
+    if (++p->cab.n == TELEMETRIA_MAX_CARGA / TELEMETRIA_TAM_REGISTRO) {
+        telemetriaRegistroFim();
+    }
+}
+
+void telemetriaRegistroFim() {
+    TelemetriaPacote *p = &pacoteRegistros;
+    if (p->cab.n > 0) {
+        seqRegistros++;
+        enviarPacote(p, p->cab.n * TELEMETRIA_TAM_REGISTRO);
+        p->cab.n = 0;
+    }
+}
+
+void telemetriaDisparo(uint64_t instante, int16_t primeira, const uint16_t *amostras, size_t n) {
+    static TelemetriaPacote p;
+    if (n > TELEMETRIA_AMOSTRAS_DISPARO) {
+        n = TELEMETRIA_AMOSTRAS_DISPARO;
+    }
+    p.cab.tipo = TELEMETRIA_TIPO_DISPARO;
+    p.cab.decimacao = 1;
+    p.cab.n = n;
+    p.cab.seq = seqDisparo++;
+    p.cab.instante = instante;
+    p.carga[0] = primeira;
+    p.carga[1] = (uint16_t)primeira >> 8;
+    for (size_t i = 0; i < n; i++) {
+        p.carga[2 + 2 * i] = amostras[i];
+        p.carga[3 + 2 * i] = amostras[i] >> 8;
+    }
+    enviarPacote(&p, 2 + 2 * n);
+}
+
+void telemetriaLinha(const char *linha) {
+    static TelemetriaPacote p;
+    size_t n = strlen(linha);
+    if (n > TELEMETRIA_MAX_CARGA) {
+        n = TELEMETRIA_MAX_CARGA;
+    }
+    p.cab.tipo = TELEMETRIA_TIPO_TEXTO;
+    p.cab.decimacao = 1;
+    p.cab.n = n;
+    p.cab.seq = seqTexto++;
+    p.cab.instante = agoraUs();
+    memcpy(p.carga, linha, n);
+    enviarPacote(&p, n);
+}
+
+void telemetriaEnviar(uint64_t agora) {
+    static TelemetriaPacote p;
+    while (filaSpscPop(&filaPacotes, &p)) {
+        enviarPacote(&p, p.cab.n * 2);
+    }
+
+    // A idade conta de quando o pacote parcial apareceu aqui, não do instante
+    // do cabeçalho, que no host é o relógio real e não o da agenda
+    if (pacoteResultados.cab.n > 0) {
+        if (pacoteResultados.cab.seq != seqVisto) {
+            seqVisto = pacoteResultados.cab.seq;
+            instanteVisto = agora;
+        } else if (agora - instanteVisto >= TELEMETRIA_IDADE_RESULTADOS_US) {
+            telemetriaResultadosFim();
+        }
+    }
+}
+
+void telemetriaGetStats(TelemetriaStats *s) {
+    *s = stats;
+    s->descartados = filaPacotes.descartados;
+}
+
+#if PICO_ON_DEVICE
+
+static uint64_t agoraUs() {
+    return time_us_64();
+}
+
+static bool conectado() {
+    return stdio_usb_connected();
+}
+
+// Vai direto ao driver da USB: sem o printf e sem a tradução de \n para \r\n,
+// que estragaria os quadros. O driver escreve no FIFO do CDC até o fim,
+// liberando os pacotes bulk à medida que enchem.
+static void escrever(const uint8_t *dados, size_t n) {
+    stdio_usb.out_chars((const char *)dados, n);
+}
+
+#else
+
+#include <time.h>
+
+static uint64_t agoraUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
+
+static FILE *saida = NULL;
+
+static bool conectado() {
+    return true;
+}
+
+static void escrever(const uint8_t *dados, size_t n) {
+    fwrite(dados, 1, n, saida ? saida : stdout);
+}
+
+void telemetriaSaida(FILE *arquivo) {
+    saida = arquivo;
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include "plataforma.h"
+#include "detector.h"
+#include "telemetria_quadro.h"
+
+// Telemetria binária pela USB (CDC), no lugar de um printf por amostra.
+//
+// As amostras brutas chegam no núcleo 1 (callback da captura), são dizimadas
+// e acumuladas em pacotes de TELEMETRIA_AMOSTRAS_POR_PACOTE; cada pacote
+// completo passa por uma fila SPSC para o núcleo 0. Os resultados do detector
+// são acumulados no próprio núcleo 0. telemetriaEnviar(), no laço principal,
+// codifica os pacotes prontos (telemetria_quadro.h) e os escreve na USB em
+// quadros grandes, que enchem o endpoint bulk em vez de mandar uma linha curta
+// por pacote USB.
+//
+// Com a telemetria binária ligada, o texto do printf corromperia os quadros;
+// telemetriaTexto() diz se a aplicação ainda pode imprimir.
+
+#define TELEMETRIA_AMOSTRAS_POR_PACOTE (TELEMETRIA_MAX_CARGA / 2)
+#define TELEMETRIA_RESULTADOS_POR_PACOTE 10 // Um pacote por segundo com janelas de 100 ms
+#define TELEMETRIA_IDADE_RESULTADOS_US 200000 // Espera máxima de um pacote parcial de resultados
+
+// Fila dos pacotes de amostras entre os núcleos. Ela guarda tudo o que o
+// núcleo 1 produz entre duas chamadas de telemetriaEnviar(), com o dobro de
+// folga para o atraso da tarefa: 16 pacotes são 24 ms a 160 kS/s sem
+// decimação, para uma tarefa de 10 ms.
+#define TELEMETRIA_FILA_PACOTES 16
+
+// Pacotes de amostras produzidos em 'periodoUs' com 'taxa' amostras/s na
+// entrada de telemetriaAmostras()
+#define TELEMETRIA_PACOTES_POR_PERIODO(taxa, decimacao, periodoUs)                                 \
+    (((uint64_t)(taxa) * (periodoUs) / (1000000u * (decimacao)) + TELEMETRIA_AMOSTRAS_POR_PACOTE - 1) / \
+     TELEMETRIA_AMOSTRAS_POR_PACOTE)
+#define TELEMETRIA_CABE_NA_FILA(taxa, decimacao, periodoUs) \
+    (2 * TELEMETRIA_PACOTES_POR_PERIODO(taxa, decimacao, periodoUs) <= TELEMETRIA_FILA_PACOTES)
+
+typedef enum {
+    TELEMETRIA_TEXTO = 0,           // Só o printf de sempre
+    TELEMETRIA_AMOSTRAS = 1 << 0,   // Amostras brutas do ADC
+    TELEMETRIA_RESULTADOS = 1 << 1  // Resultados do detector
+} TelemetriaModo;
+
+typedef struct {
+    uint32_t quadros;       // Quadros escritos na USB
+    uint32_t bytes;
+    uint32_t descartados;   // Pacotes de amostras perdidos com a fila cheia
+    uint32_t semConexao;    // Pacotes descartados sem terminal aberto
+} TelemetriaStats;
+
+// 'modo' é uma combinação de TelemetriaModo. 'decimacao' é quantas amostras
+// do ADC viram uma amostra enviada (média), de 1 a 255. 'taxa' (amostras/s
+// do ADC) e 'periodoUs' (intervalo entre chamadas de telemetriaEnviar())
+// conferem a fila: se ela não comporta dois períodos de pacotes, a decimação
+// sobe até caber, em vez de descartar pacotes continuamente. Retorna a
+// decimação usada.
+uint8_t telemetriaInit(uint8_t modo, uint8_t decimacao, uint32_t taxa, uint32_t periodoUs);
+
+bool telemetriaTexto();
+
+// Núcleo 1: amostras de um bloco da captura
+void telemetriaAmostras(const uint16_t *amostras, size_t n);
+
+// Núcleo 0: resultado de uma janela do detector. Um pacote parcial não
+// espera os TELEMETRIA_RESULTADOS_POR_PACOTE: telemetriaEnviar() o envia
+// quando passa de TELEMETRIA_IDADE_RESULTADOS_US, e telemetriaResultadosFim()
+// o envia na hora.
+void telemetriaResultado(const DetectorResultado *res);
+void telemetriaResultadosFim();
+
+// Núcleo 0: um registro lido da flash (ver registro.h). Os registros vão em
+// pacotes de TIPO_REGISTRO, independentes do modo; telemetriaRegistroFim()
+// envia o último pacote parcial.
+void telemetriaRegistro(uint16_t sessao, uint32_t instanteMs, uint16_t valor);
+void telemetriaRegistroFim();
+
+// Núcleo 0: trecho de uma rajada congelada pelo gatilho (gatilho.h), num
+// pacote de TIPO_DISPARO, independente do modo. 'primeira' é o índice da
+// primeira amostra em relação ao disparo; 'n' vai até TELEMETRIA_AMOSTRAS_DISPARO.
+#define TELEMETRIA_AMOSTRAS_DISPARO ((TELEMETRIA_MAX_CARGA - 2) / 2)
+void telemetriaDisparo(uint64_t instante, int16_t primeira, const uint16_t *amostras, size_t n);
+
+// Núcleo 0: uma linha de texto (diagnóstico) num pacote de TIPO_TEXTO, para
+// não misturar printf com os quadros binários. Linhas maiores que a carga são
+// cortadas.
+void telemetriaLinha(const char *linha);
+
+// Núcleo 0: escreve na USB os pacotes prontos. 'agora' (us) mede a idade do
+// pacote parcial de resultados.
+void telemetriaEnviar(uint64_t agora);
+
+void telemetriaGetStats(TelemetriaStats *stats);
+
+#if !PICO_ON_DEVICE
+#include <stdio.h>
+// Destino dos quadros no build de host (padrão: stdout)
+void telemetriaSaida(FILE *arquivo);
+#endif
+
+#endif
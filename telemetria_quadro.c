@@ -0,0 +1,126 @@
+#include <string.h>
+#include "telemetria_quadro.h"
+
+// CRC-16/CCITT meio byte por vez: 16 entradas na tabela em vez de 256, e
+// duas consultas por byte em vez de oito deslocamentos
+static const uint16_t crcTabela[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t telemetriaCrc16(const uint8_t *dados, size_t n) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < n; i++) {
+        crc = (crc << 4) ^ crcTabela[(crc >> 12) ^ (dados[i] >> 4)];
+        crc = (crc << 4) ^ crcTabela[(crc >> 12) ^ (dados[i] & 0x0F)];
+    }
+    return crc;
+}
+
+size_t cobsCodificar(const uint8_t *entrada, size_t n, uint8_t *saida) {
+    size_t codigo = 0; // Posição do byte de código do bloco atual
+    size_t j = 1;
+    uint8_t contagem = 1;
+
+    for (size_t i = 0; i < n; i++) {
+        if (entrada[i] != 0) {
+            saida[j++] = entrada[i];
+            contagem++;
+        }
+        if (entrada[i] == 0 || contagem == 0xFF) {
+            saida[codigo] = contagem;
+            codigo = j++;
+            contagem = 1;
+        }
+    }
+    saida[codigo] = contagem;
+    saida[j++] = 0;
+    return j;
+}
+
+size_t cobsDecodificar(const uint8_t *entrada, size_t n, uint8_t *saida) {
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < n) {
+        uint8_t codigo = entrada[i++];
+        if (codigo == 0 || i + codigo - 1 > n) {
+            return 0;
+        }
+        for (uint8_t k = 1; k < codigo; k++) {
+            if (entrada[i] == 0) {
+                return 0;
+            }
+            saida[j++] = entrada[i++];
+        }
+        // Um código menor que 0xFF representa um zero, exceto no fim do quadro
+        if (codigo != 0xFF && i < n) {
+            saida[j++] = 0;
+        }
+    }
+    return j;
+}
+
+static void escrever16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void escrever32(uint8_t *p, uint32_t v) {
+    escrever16(p, v);
+    escrever16(p + 2, v >> 16);
+}
+
+static uint16_t ler16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t ler32(const uint8_t *p) {
+    return ler16(p) | ((uint32_t)ler16(p + 2) << 16);
+}
+
+size_t telemetriaMontarQuadro(const TelemetriaCabecalho *cab, const uint8_t *carga, size_t tamCarga,
+                              uint8_t *quadro) {
+    uint8_t pacote[TELEMETRIA_MAX_PACOTE];
+
+    if (tamCarga > TELEMETRIA_MAX_CARGA) {
+        return 0;
+    }
+    pacote[0] = cab->tipo;
+    pacote[1] = cab->decimacao;
+    escrever16(&pacote[2], cab->n);
+    escrever32(&pacote[4], cab->seq);
+    escrever32(&pacote[8], (uint32_t)cab->instante);
+    escrever32(&pacote[12], (uint32_t)(cab->instante >> 32));
+    memcpy(&pacote[TELEMETRIA_TAM_CABECALHO], carga, tamCarga);
+
+    size_t tam = TELEMETRIA_TAM_CABECALHO + tamCarga;
+    escrever16(&pacote[tam], telemetriaCrc16(pacote, tam));
+    return cobsCodificar(pacote, tam + TELEMETRIA_TAM_CRC, quadro);
+}
+
+bool telemetriaAbrirQuadro(const uint8_t *quadro, size_t n, TelemetriaCabecalho *cab, uint8_t *carga,
+                           size_t *tamCarga) {
+    uint8_t pacote[TELEMETRIA_MAX_QUADRO];
+
+    if (n > TELEMETRIA_MAX_QUADRO) {
+        return false;
+    }
+    size_t tam = cobsDecodificar(quadro, n, pacote);
+    if (tam < TELEMETRIA_TAM_CABECALHO + TELEMETRIA_TAM_CRC || tam > TELEMETRIA_MAX_PACOTE) {
+        return false;
+    }
+    tam -= TELEMETRIA_TAM_CRC;
+    if (telemetriaCrc16(pacote, tam) != ler16(&pacote[tam])) {
+        return false;
+    }
+
+    cab->tipo = pacote[0];
+    cab->decimacao = pacote[1];
+    cab->n = ler16(&pacote[2]);
+    cab->seq = ler32(&pacote[4]);
+    cab->instante = ler32(&pacote[8]) | ((uint64_t)ler32(&pacote[12]) << 32);
+    *tamCarga = tam - TELEMETRIA_TAM_CABECALHO;
+    memcpy(carga, &pacote[TELEMETRIA_TAM_CABECALHO], *tamCarga);
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef TELEMETRIA_QUADRO_H
+#define TELEMETRIA_QUADRO_H
+
+#include "plataforma.h"
+
+// Formato dos quadros de telemetria, compartilhado pelo firmware e pelo
+// decodificador de host (tools/telemetria_dump.c). Não depende do SDK.
+//
+// Pacote (little-endian), antes da codificação:
+//   tipo (1) | decimação (1) | n (2) | seq (4) | instante em us (8) | carga | CRC-16 (2)
+// O CRC-16/CCITT (0x1021, início 0xFFFF) cobre cabeçalho e carga. O pacote
+// inteiro é codificado em COBS e terminado por um byte 0x00, que nunca aparece
+// dentro do quadro: o receptor se ressincroniza no próximo zero.
+//
+// Cada tipo tem sua própria sequência; um salto em 'seq' indica pacotes
+// perdidos (fila cheia na placa ou bytes perdidos no caminho).
+
+#define TELEMETRIA_TAM_CABECALHO 16
+#define TELEMETRIA_TAM_CRC 2
+#define TELEMETRIA_MAX_CARGA 480
+#define TELEMETRIA_MAX_PACOTE (TELEMETRIA_TAM_CABECALHO + TELEMETRIA_MAX_CARGA + TELEMETRIA_TAM_CRC)
+// COBS acrescenta um byte a cada 254, mais um no início e o delimitador
+#define TELEMETRIA_MAX_QUADRO (TELEMETRIA_MAX_PACOTE + TELEMETRIA_MAX_PACOTE / 254 + 2)
+
+typedef enum {
+    TELEMETRIA_TIPO_AMOSTRAS = 1,  // n amostras do ADC, uint16 cada
+    TELEMETRIA_TIPO_RESULTADO = 2, // n resultados do detector, TELEMETRIA_TAM_RESULTADO bytes cada
+    TELEMETRIA_TIPO_REGISTRO = 3,  // n registros exportados da flash, TELEMETRIA_TAM_REGISTRO bytes cada
+    TELEMETRIA_TIPO_TEXTO = 4,     // Uma linha de texto com n caracteres, sem o fim de linha
+    TELEMETRIA_TIPO_DISPARO = 5    // Trecho de uma rajada do gatilho: índice do primeiro item em relação ao disparo (int16) e n amostras uint16
+} TelemetriaTipo;
+
+// dc, rms, pico, amplitude[4], intensidade (uint16 cada) e rede (uint8)
+#define TELEMETRIA_TAM_RESULTADO 17
+// sessão (uint16), instante em ms (uint32) e valor (uint16)
+#define TELEMETRIA_TAM_REGISTRO 8
+
+typedef struct {
+    uint8_t tipo;
+    uint8_t decimacao;  // Amostras do ADC por amostra enviada (só TIPO_AMOSTRAS)
+    uint16_t n;         // Itens na carga
+    uint32_t seq;
+    uint64_t instante;  // time_us_64() do primeiro item (TIPO_DISPARO: do disparo)
+} TelemetriaCabecalho;
+
+uint16_t telemetriaCrc16(const uint8_t *dados, size_t n);
+
+// Codifica 'n' bytes em COBS e acrescenta o delimitador 0x00. 'saida' precisa
+// de n + n / 254 + 2 bytes. Retorna o tamanho escrito, delimitador incluído.
+size_t cobsCodificar(const uint8_t *entrada, size_t n, uint8_t *saida);
+
+// Decodifica um quadro sem o delimitador. Retorna o tamanho decodificado ou 0
+// se o quadro é inválido. 'saida' precisa de 'n' bytes.
+size_t cobsDecodificar(const uint8_t *entrada, size_t n, uint8_t *saida);
+
+// Monta o pacote com CRC e o codifica em 'quadro' (TELEMETRIA_MAX_QUADRO
+// bytes). Retorna o tamanho do quadro, delimitador incluído.
+size_t telemetriaMontarQuadro(const TelemetriaCabecalho *cab, const uint8_t *carga, size_t tamCarga,
+                              uint8_t *quadro);
+
+// Desfaz telemetriaMontarQuadro() a partir de um quadro sem o delimitador.
+// 'carga' precisa de TELEMETRIA_MAX_CARGA bytes. Retorna false se o COBS ou o
+// CRC não conferem.
+bool telemetriaAbrirQuadro(const uint8_t *quadro, size_t n, TelemetriaCabecalho *cab, uint8_t *carga,
+                           size_t *tamCarga);
+
+#endif
@@ -0,0 +1,180 @@
+#include "tom.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#endif
+
+static TomPwm tabela[TOM_NUM_FREQ];
+static volatile uint16_t alvoFreq = TOM_FREQ_MIN;
+static volatile uint16_t alvoVolume = 0;
+static uint32_t atualQ8 = 0;  // Frequência do glide em Hz, Q8
+static TomEstado estado;
+
+static void aplicar(const TomEstado *e);
+
+// Erro de clk / (div16 / 16 * top) em relação a 'freq', em ppm
+static uint32_t erroPpm(uint32_t clkHz, uint32_t freq, uint32_t div16, uint32_t top) {
+    uint64_t obtido = (uint64_t)freq * div16 * top; // Em unidades de clk * 16
+    uint64_t ideal = (uint64_t)clkHz << 4;
+    uint64_t diferenca = obtido > ideal ? obtido - ideal : ideal - obtido;
+    return diferenca * 1000000 / obtido;
+}
+
+uint32_t tomTabelaInit(uint32_t clkHz) {
+    uint32_t erroMax = 0;
+
+    for (uint32_t f = TOM_FREQ_MIN; f <= TOM_FREQ_MAX; f++) {
+        uint64_t total = ((uint64_t)clkHz << 4) / f; // div16 * top ideal
+        uint32_t minimo = (total + 65535) >> 16;     // Menor divisor com top <= 65536
+        if (minimo < 16) {
+            minimo = 16;                             // Divisor mínimo 1.0
+        }
+
+        TomPwm melhor = {0, 0};
+        uint32_t melhorErro = UINT32_MAX;
+        for (uint32_t div16 = minimo; div16 < minimo + 8 && div16 <= 0xFFF; div16++) {
+            uint32_t top = (((uint64_t)clkHz << 4) + (uint64_t)div16 * f / 2) / ((uint64_t)div16 * f);
+            if (top < 2 || top > 65536) {
+                continue;
+            }
+            uint32_t erro = erroPpm(clkHz, f, div16, top);
+            if (erro < melhorErro) { // Empate fica com o divisor menor
+                melhorErro = erro;
+                melhor.wrap = top - 1;
+                melhor.div16 = div16;
+            }
+        }
+
+        tabela[f - TOM_FREQ_MIN] = melhor;
+        if (melhorErro > erroMax) {
+            erroMax = melhorErro;
+        }
+    }
+
+    estado.freq = 0; // Força reaplicar com a tabela nova
+    return erroMax;
+}
+
+const TomPwm *tomTabela(uint16_t freq) {
+    if (freq < TOM_FREQ_MIN) {
+        freq = TOM_FREQ_MIN;
+    } else if (freq > TOM_FREQ_MAX) {
+        freq = TOM_FREQ_MAX;
+    }
+    return &tabela[freq - TOM_FREQ_MIN];
+}
+
+void tomDefinir(uint16_t freq, uint16_t volumeQ8) {
+    if (freq < TOM_FREQ_MIN) {
+        freq = TOM_FREQ_MIN;
+    } else if (freq > TOM_FREQ_MAX) {
+        freq = TOM_FREQ_MAX;
+    }
+    alvoFreq = freq;
+    alvoVolume = volumeQ8 > TOM_VOLUME_MAX ? TOM_VOLUME_MAX : volumeQ8;
+}
+
+TomEstado tomEstado() {
+    return estado;
+}
+
+// Um passo do glide, no temporizador
+static void passo() {
+    int32_t alvo = (int32_t)alvoFreq << 8;
+    uint16_t volume = alvoVolume;
+
+    if (atualQ8 == 0) {
+        atualQ8 = alvo; // Primeiro tom: sem glide a partir do nada
+    } else {
+        int32_t falta = alvo - (int32_t)atualQ8;
+        if (falta > (1 << TOM_GLIDE_SHIFT) || falta < -(1 << TOM_GLIDE_SHIFT)) {
+            atualQ8 += falta >> TOM_GLIDE_SHIFT;
+        } else {
+            atualQ8 = alvo;
+        }
+    }
+
+    TomEstado novo;
+    novo.freq = (atualQ8 + 128) >> 8;
+    novo.pwm = tabela[novo.freq - TOM_FREQ_MIN];
+    novo.nivel = ((uint32_t)(novo.pwm.wrap + 1) * volume) >> 9; // Volume máximo = 50% de duty
+
+    if (novo.freq != estado.freq || novo.nivel != estado.nivel) {
+        estado = novo;
+        aplicar(&estado);
+    }
+}
+
+#if PICO_ON_DEVICE
+
+static uint slices[2];
+static uint canais[2];
+static repeating_timer_t temporizador;
+
+static bool tomTemporizador(repeating_timer_t *rt) {
+    passo();
+    return true;
+}
+
+// O DIV do PWM muda na hora e o TOP/CC só no fim do período; a troca de
+// divisor entre passos vizinhos do glide é pequena e não se ouve
+static void aplicar(const TomEstado *e) {
+    for (int i = 0; i < 2; i++) {
+        pwm_set_clkdiv_int_frac(slices[i], e->pwm.div16 >> 4, e->pwm.div16 & 0xF);
+        pwm_set_wrap(slices[i], e->pwm.wrap);
+        pwm_set_chan_level(slices[i], canais[i], e->nivel);
+    }
+}
+
+void tomInit(unsigned pino1, unsigned pino2) {
+    unsigned pinos[2] = {pino1, pino2};
+    for (int i = 0; i < 2; i++) {
+        gpio_set_function(pinos[i], GPIO_FUNC_PWM);
+        slices[i] = pwm_gpio_to_slice_num(pinos[i]);
+        canais[i] = pwm_gpio_to_channel(pinos[i]);
+        pwm_config config = pwm_get_default_config();
+        pwm_init(slices[i], &config, false);
+        pwm_set_chan_level(slices[i], canais[i], 0);
+        pwm_set_enabled(slices[i], true);
+    }
+
+    tomTabelaInit(clock_get_hz(clk_sys));
+    add_repeating_timer_us(-TOM_PASSO_US, tomTemporizador, NULL, &temporizador);
+}
+
+// A tabela não pode mudar no meio de um passo do glide, e com o clock novo o
+// tom atual já sai errado: silencia, recalcula e volta no passo seguinte
+uint32_t tomAjustarRelogio(uint32_t clkHz) {
+    cancel_repeating_timer(&temporizador);
+    for (int i = 0; i < 2; i++) {
+        pwm_set_chan_level(slices[i], canais[i], 0);
+    }
+    uint32_t erro = tomTabelaInit(clkHz);
+    passo();
+    add_repeating_timer_us(-TOM_PASSO_US, tomTemporizador, NULL, &temporizador);
+    return erro;
+}
+
+#else
+
+static void aplicar(const TomEstado *e) {
+    (void)e;
+}
+
+void tomInit(unsigned pino1, unsigned pino2) {
+    (void)pino1;
+    (void)pino2;
+    tomTabelaInit(125000000);
+}
+
+uint32_t tomAjustarRelogio(uint32_t clkHz) {
+    return tomTabelaInit(clkHz);
+}
+
+void tomPasso() {
+    passo();
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef TOM_H
+#define TOM_H
+
+#include "plataforma.h"
+
+// Gerador de tom dos buzzers por PWM. O par (divisor, wrap) de cada
+// frequência inteira entre TOM_FREQ_MIN e TOM_FREQ_MAX é calculado uma vez em
+// tomTabelaInit(): o divisor é o menor que faz o período caber nos 16 bits do
+// wrap, o que dá a maior resolução de duty, e entre os vizinhos fica o de
+// menor erro de frequência.
+//
+// O volume é uma fração do duty em Q8 (256 = 50%, onda quadrada), aplicada só
+// com inteiros. A mudança de frequência desliza (glide) até o alvo num
+// temporizador periódico, independente do laço principal.
+
+#define TOM_FREQ_MIN 200
+#define TOM_FREQ_MAX 2000
+#define TOM_NUM_FREQ (TOM_FREQ_MAX - TOM_FREQ_MIN + 1)
+#define TOM_VOLUME_MAX 256
+#define TOM_PASSO_US 2000   // Período do glide
+#define TOM_GLIDE_SHIFT 4   // Cada passo anda 1/16 do que falta: ~32 ms de constante de tempo
+
+typedef struct {
+    uint16_t wrap;
+    uint16_t div16;  // Divisor em 1/16 (inteiro << 4 | fração)
+} TomPwm;
+
+typedef struct {
+    uint16_t freq;   // Frequência aplicada agora, em Hz (0 = mudo)
+    TomPwm pwm;
+    uint16_t nivel;  // Nível do canal (duty)
+} TomEstado;
+
+// Recalcula a tabela para o clock do sistema 'clkHz'. Retorna o maior erro
+// de frequência da tabela, em ppm.
+uint32_t tomTabelaInit(uint32_t clkHz);
+
+// Monta a tabela para um clk_sys novo e reaplica o tom atual, com o glide
+// parado durante a conta (os buzzers ficam mudos nesse meio-tempo). Retorna o
+// mesmo erro que tomTabelaInit().
+uint32_t tomAjustarRelogio(uint32_t clkHz);
+
+// Configura os dois pinos como PWM, monta a tabela e inicia o glide
+void tomInit(unsigned pino1, unsigned pino2);
+
+// Alvo do glide. 'freq' fora da faixa é limitada; volume 0 silencia.
+void tomDefinir(uint16_t freq, uint16_t volumeQ8);
+
+const TomPwm *tomTabela(uint16_t freq);
+TomEstado tomEstado();
+
+#if !PICO_ON_DEVICE
+// Faz o papel do temporizador no build de host
+void tomPasso();
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""Gera telas.h a partir de telas.txt: cada tela e cada variante de trecho vira
+um bitmap constante no layout de páginas do SSD1306 (um byte por coluna de 8
+pixels, bit 0 no topo), pronto para SSD1306_blit().
+
+O texto é rasterizado com a fonte de ssd1306_font5x7.h e com as mesmas regras do
+DrawText() opaco de ssd1306_text.c: célula de 6 colunas, y em qualquer pixel.
+
+Uso: gerar_telas.py telas.txt ssd1306_font5x7.h telas.h
+"""
+
+import re
+import shlex
+import sys
+
+LARGURA = 128
+ALTURA = 32
+PAGINAS = ALTURA // 8
+AVANCO = 6
+
+
+def ler_fonte(caminho):
+    texto = open(caminho, encoding="utf-8").read()
+    corpo = texto[texto.index("font5x7[][FONT5X7_WIDTH]"):texto.index("font5x7_latin1")]
+    glifos = [[int(b, 16) for b in m.group(1).split(",")]
+              for m in re.finditer(r"\{\s*(0x[0-9a-fA-F]{2}(?:\s*,\s*0x[0-9a-fA-F]{2}){4})\s*\}", corpo)]
+    tabela = texto[texto.index("font5x7_latin1[96] = {"):]
+    tabela = tabela[tabela.index("{") + 1:tabela.index("}")]
+    latin1 = [int(n) for n in re.findall(r"\d+", tabela)]
+    primeiro = int(re.search(r"#define FONT5X7_FIRST (0x[0-9a-fA-F]+)", texto).group(1), 16)
+    ultimo = int(re.search(r"#define FONT5X7_LAST (0x[0-9a-fA-F]+)", texto).group(1), 16)
+    if len(latin1) != 96:
+        sys.exit("%s: tabela Latin-1 com %d entradas" % (caminho, len(latin1)))
+
+    def indice(codigo):
+        if primeiro <= codigo <= ultimo:
+            return codigo - primeiro
+        if 0xA0 <= codigo <= 0xFF and latin1[codigo - 0xA0]:
+            return latin1[codigo - 0xA0]
+        return ord("?") - primeiro
+
+    return glifos, indice
+
+
+def desenhar_texto(buf, fonte, x, y, texto):
+    glifos, indice = fonte
+    for ch in texto:
+        codigo = ord(ch)
+        colunas = glifos[indice(codigo if codigo <= 0xFF else 0xFFFF)] + [0]
+        for c, g in enumerate(colunas):
+            coluna = x + c
+            if not 0 <= coluna < LARGURA:
+                continue
+            for linha in range(8):
+                yy = y + linha
+                if not 0 <= yy < ALTURA:
+                    continue
+                byte = (yy // 8) * LARGURA + coluna
+                bit = 1 << (yy % 8)
+                buf[byte] = (buf[byte] | bit) if (g >> linha) & 1 else (buf[byte] & ~bit)
+        x += AVANCO
+
+
+def ler_definicoes(caminho):
+    telas, trechos = [], []
+    atual = None
+    for numero, linha in enumerate(open(caminho, encoding="utf-8"), 1):
+        linha = linha.strip()
+        if not linha or linha.startswith("#"):
+            continue
+        campos = shlex.split(linha)
+        if campos[0] in ("tela", "trecho") and len(campos) == 2:
+            atual = (campos[1], [])
+            (telas if campos[0] == "tela" else trechos).append(atual)
+        elif campos[0] == "texto" and len(campos) == 4 and atual is not None:
+            atual[1].append((int(campos[1]), int(campos[2]), campos[3]))
+        else:
+            sys.exit("%s:%d: linha inválida" % (caminho, numero))
+    return telas, trechos
+
+
+def nome_c(nome, prefixo):
+    partes = nome.lower().split("_")
+    return prefixo + "".join(p.capitalize() for p in partes)
+
+
+def bytes_c(dados, recuo):
+    linhas = []
+    for i in range(0, len(dados), 16):
+        linhas.append(recuo + ", ".join("0x%02x" % b for b in dados[i:i + 16]) + ",")
+    return "\n".join(linhas)
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit(__doc__)
+    fonte = ler_fonte(sys.argv[2])
+    telas, trechos = ler_definicoes(sys.argv[1])
+
+    saida = ["// Gerado por tools/gerar_telas.py a partir de telas.txt. Não editar.",
+             "#ifndef TELAS_H", "#define TELAS_H", "", "#include <stdint.h>", ""]
+
+    for nome, textos in telas:
+        buf = [0] * (LARGURA * PAGINAS)
+        for x, y, texto in textos:
+            desenhar_texto(buf, fonte, x, y, texto)
+        saida.append("// Tela %s (%d x %d, %d páginas)" % (nome, LARGURA, ALTURA, PAGINAS))
+        saida.append("static const uint8_t %s[%d] = {" % (nome_c(nome, "tela"), len(buf)))
+        saida.append(bytes_c(buf, "    "))
+        saida.append("};")
+        saida.append("")
+
+    for nome, variantes in trechos:
+        # Região: união das células desenhadas por todas as variantes
+        x0 = min(x for x, _, _ in variantes)
+        x1 = max(x + AVANCO * len(t) for x, _, t in variantes)
+        p0 = min(y // 8 for _, y, _ in variantes)
+        p1 = max((y + 7) // 8 for _, y, _ in variantes)
+        x0, x1, p0, p1 = max(x0, 0), min(x1, LARGURA), max(p0, 0), min(p1, PAGINAS - 1)
+        largura = x1 - x0
+        paginas = p1 - p0 + 1
+        macro = "TRECHO_" + nome
+        saida.append("// Trecho %s: %d variantes de %d colunas x %d página(s)" % (nome, len(variantes), largura, paginas))
+        saida.append("#define %s_X %d" % (macro, x0))
+        saida.append("#define %s_PAGINA %d" % (macro, p0))
+        saida.append("#define %s_LARGURA %d" % (macro, largura))
+        saida.append("#define %s_PAGINAS %d" % (macro, paginas))
+        saida.append("#define %s_VARIANTES %d" % (macro, len(variantes)))
+        saida.append("static const uint8_t %s[%d][%d] = {" % (nome_c(nome, "trecho"), len(variantes), largura * paginas))
+        for x, y, texto in variantes:
+            buf = [0] * (LARGURA * PAGINAS)
+            desenhar_texto(buf, fonte, x, y, texto)
+            regiao = []
+            for p in range(p0, p1 + 1):
+                regiao += buf[p * LARGURA + x0:p * LARGURA + x1]
+            saida.append("    { // \"%s\"" % texto)
+            saida.append(bytes_c(regiao, "        "))
+            saida.append("    },")
+        saida.append("};")
+        saida.append("")
+
+    saida.append("#endif")
+    open(sys.argv[3], "w", encoding="utf-8").write("\n".join(saida) + "\n")
+
+
+if __name__ == "__main__":
+    main()
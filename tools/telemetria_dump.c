@@ -0,0 +1,189 @@
+// Decodificador da telemetria binária do ProjetoU7T (ver telemetria_quadro.h).
+//
+// Lê os quadros COBS de um arquivo capturado ou direto da porta serial da
+// placa (/dev/ttyACM0, colocada em modo raw) e escreve uma linha CSV por item:
+//   amostra,<seq>,<instante_us>,<valor>
+//   resultado,<seq>,<instante_us>,<dc>,<rms>,<pico>,<a50>,<a60>,<a100>,<a120>,<intensidade>,<rede>
+//   registro,<sessao>,<instante_ms>,<valor>       (exportação do registro na flash)
+//   disparo,<seq>,<instante_us>,<indice>,<valor>  (rajada do gatilho; índice 0 = disparo)
+// No fim (EOF ou Ctrl+C) imprime em stderr os quadros válidos, os rejeitados
+// (COBS ou CRC) e os pacotes perdidos, contados pelos saltos de sequência.
+//
+// Uso: telemetria_dump <arquivo|dispositivo>   ("-" lê da entrada padrão)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "telemetria_quadro.h"
+
+#define NUM_TIPOS 6
+
+typedef struct {
+    bool visto;
+    uint32_t proximaSeq;
+    uint32_t pacotes;
+    uint32_t perdidos;
+} Fluxo;
+
+static Fluxo fluxos[NUM_TIPOS];
+static uint32_t quadrosValidos = 0;
+static uint32_t quadrosInvalidos = 0;
+static volatile sig_atomic_t parar = 0;
+
+static void pararLeitura(int sinal) {
+    (void)sinal;
+    parar = 1;
+}
+
+static uint16_t ler16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static void tratarQuadro(const uint8_t *quadro, size_t n) {
+    TelemetriaCabecalho cab;
+    uint8_t carga[TELEMETRIA_MAX_CARGA];
+    size_t tamCarga;
+
+    if (n == 0) {
+        return; // Zeros seguidos (por exemplo, no começo da captura)
+    }
+    if (!telemetriaAbrirQuadro(quadro, n, &cab, carga, &tamCarga) || cab.tipo == 0 || cab.tipo >= NUM_TIPOS) {
+        quadrosInvalidos++;
+        return;
+    }
+    quadrosValidos++;
+
+    Fluxo *f = &fluxos[cab.tipo];
+    if (f->visto && cab.seq != f->proximaSeq) {
+        f->perdidos += cab.seq - f->proximaSeq;
+        fprintf(stderr, "tipo %u: %lu pacote(s) perdido(s) antes de seq %lu\n", cab.tipo,
+                (unsigned long)(cab.seq - f->proximaSeq), (unsigned long)cab.seq);
+    }
+    f->visto = true;
+    f->proximaSeq = cab.seq + 1;
+    f->pacotes++;
+
+    if (cab.tipo == TELEMETRIA_TIPO_AMOSTRAS) {
+        if (tamCarga != cab.n * 2u) {
+            quadrosInvalidos++;
+            return;
+        }
+        for (uint16_t i = 0; i < cab.n; i++) {
+            printf("amostra,%lu,%llu,%u\n", (unsigned long)cab.seq, (unsigned long long)cab.instante,
+                   ler16(&carga[2 * i]));
+        }
+    } else if (cab.tipo == TELEMETRIA_TIPO_REGISTRO) {
+        if (tamCarga != cab.n * (size_t)TELEMETRIA_TAM_REGISTRO) {
+            quadrosInvalidos++;
+            return;
+        }
+        for (uint16_t i = 0; i < cab.n; i++) {
+            const uint8_t *r = &carga[i * TELEMETRIA_TAM_REGISTRO];
+            printf("registro,%u,%lu,%u\n", ler16(r), (unsigned long)(ler16(&r[2]) | ((uint32_t)ler16(&r[4]) << 16)),
+                   ler16(&r[6]));
+        }
+    } else if (cab.tipo == TELEMETRIA_TIPO_DISPARO) {
+        if (tamCarga != 2 + cab.n * 2u) {
+            quadrosInvalidos++;
+            return;
+        }
+        int16_t primeira = (int16_t)ler16(carga);
+        for (uint16_t i = 0; i < cab.n; i++) {
+            printf("disparo,%lu,%llu,%d,%u\n", (unsigned long)cab.seq, (unsigned long long)cab.instante,
+                   primeira + i, ler16(&carga[2 + 2 * i]));
+        }
+    } else if (cab.tipo == TELEMETRIA_TIPO_TEXTO) {
+        if (tamCarga != cab.n) {
+            quadrosInvalidos++;
+            return;
+        }
+        printf("texto,%.*s\n", (int)tamCarga, (const char *)carga);
+    } else {
+        if (tamCarga != cab.n * (size_t)TELEMETRIA_TAM_RESULTADO) {
+            quadrosInvalidos++;
+            return;
+        }
+        for (uint16_t i = 0; i < cab.n; i++) {
+            const uint8_t *r = &carga[i * TELEMETRIA_TAM_RESULTADO];
+            printf("resultado,%lu,%llu", (unsigned long)cab.seq, (unsigned long long)cab.instante);
+            for (int k = 0; k < 8; k++) {
+                printf(",%u", ler16(&r[2 * k]));
+            }
+            printf(",%u\n", r[16]);
+        }
+    }
+}
+
+// Porta serial: modo raw, sem eco nem tradução de fim de linha
+static void configurarTerminal(int fd) {
+    struct termios t;
+    if (tcgetattr(fd, &t) == 0) {
+        cfmakeraw(&t);
+        tcsetattr(fd, TCSANOW, &t);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "uso: %s <arquivo|dispositivo|->\n", argv[0]);
+        return 2;
+    }
+
+    int fd = strcmp(argv[1], "-") == 0 ? STDIN_FILENO : open(argv[1], O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+    if (isatty(fd)) {
+        configurarTerminal(fd);
+    }
+    signal(SIGINT, pararLeitura);
+
+    uint8_t bloco[4096];
+    uint8_t quadro[TELEMETRIA_MAX_QUADRO];
+    size_t tamQuadro = 0;
+    bool estourou = false; // Quadro maior que o máximo: descarta até o próximo zero
+
+    while (!parar) {
+        ssize_t lidos = read(fd, bloco, sizeof(bloco));
+        if (lidos < 0 && errno == EINTR) {
+            continue;
+        }
+        if (lidos <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < lidos; i++) {
+            if (bloco[i] == 0) {
+                if (estourou) {
+                    quadrosInvalidos++;
+                } else {
+                    tratarQuadro(quadro, tamQuadro);
+                }
+                tamQuadro = 0;
+                estourou = false;
+            } else if (tamQuadro < sizeof(quadro)) {
+                quadro[tamQuadro++] = bloco[i];
+            } else {
+                estourou = true;
+            }
+        }
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "quadros validos: %lu, invalidos: %lu\n", (unsigned long)quadrosValidos,
+            (unsigned long)quadrosInvalidos);
+    fprintf(stderr, "amostras: %lu pacotes, %lu perdidos\n", (unsigned long)fluxos[TELEMETRIA_TIPO_AMOSTRAS].pacotes,
+            (unsigned long)fluxos[TELEMETRIA_TIPO_AMOSTRAS].perdidos);
+    fprintf(stderr, "resultados: %lu pacotes, %lu perdidos\n",
+            (unsigned long)fluxos[TELEMETRIA_TIPO_RESULTADO].pacotes,
+            (unsigned long)fluxos[TELEMETRIA_TIPO_RESULTADO].perdidos);
+    fprintf(stderr, "registro: %lu pacotes, %lu perdidos\n", (unsigned long)fluxos[TELEMETRIA_TIPO_REGISTRO].pacotes,
+            (unsigned long)fluxos[TELEMETRIA_TIPO_REGISTRO].perdidos);
+    fprintf(stderr, "disparo: %lu pacotes, %lu perdidos\n", (unsigned long)fluxos[TELEMETRIA_TIPO_DISPARO].pacotes,
+            (unsigned long)fluxos[TELEMETRIA_TIPO_DISPARO].perdidos);
+    return 0;
+}